@@ -1,9 +1,12 @@
 #pragma once
+#include <string>
 
 #include "FrtDecimalizeIterationMethod.h"
+#include "FrtInteriorDetectionMethod.h"
 #include "FrtMPAAttribute.h"
 #include "FrtReferenceCompAttribute.h"
 #include "FrtReuseReferenceMethod.h"
+#include "FrtSegmentStorageMethod.h"
 #include "../calc/fp_complex.h"
 
 
@@ -20,5 +23,12 @@ namespace merutilm::rff2 {
         bool autoMaxIteration;
         uint16_t autoIterationMultiplier;
         bool absoluteIterationMode;
+        FrtInteriorDetectionMethod interiorDetectionMethod;
+        uint32_t threadedReferenceMinBits;
+        uint32_t referenceCheckpointInterval;
+        uint32_t referenceCacheCapacity;
+        FrtSegmentStorageMethod referenceStorageMethod;
+        FrtSegmentStorageMethod tableStorageMethod;
+        std::string scratchDirectory; // the files of the mapped segments and the checkpoints, in the temp directory when it is empty
     };
 }
@@ -0,0 +1,23 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+
+namespace merutilm::rff2 {
+    enum class FrtInteriorDetectionMethod {
+        /**
+         * Iterates the interior until the max iteration.
+         */
+        NONE,
+        /**
+         * Tracks the derivative of z, and stops when it is small enough, which means the orbit is attracted to a cycle.
+         */
+        DERIVATIVE,
+        /**
+         * Also compares z with the saved one whenever the reference is rebased, and stops when the orbit repeats.
+         * It finds the interior whose derivative is overflowed.
+         */
+        DERIVATIVE_AND_PERIODICITY
+    };
+}
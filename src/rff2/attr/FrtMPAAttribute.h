@@ -16,5 +16,6 @@ namespace merutilm::rff2 {
         float epsilonPower;
         FrtMPASelectionMethod mpaSelectionMethod;
         FrtMPACompressionMethod mpaCompressionMethod;
+        uint8_t seriesApproximationTerms; // zero disables the series approximation
     };
 }
\ No newline at end of file
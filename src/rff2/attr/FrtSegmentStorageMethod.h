@@ -0,0 +1,22 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+
+namespace merutilm::rff2 {
+    enum class FrtSegmentStorageMethod {
+        /**
+         * The segments on the heap. When the memory is full, the OS swaps them out.
+         */
+        HEAP,
+        /**
+         * The segments on the huge pages, so the random access of the iteration misses the TLB less.
+         */
+        HUGE_PAGE,
+        /**
+         * The segments on a temporary file of the scratch directory, for the data larger than the memory.
+         */
+        MAPPED_FILE
+    };
+}
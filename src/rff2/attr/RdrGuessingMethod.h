@@ -0,0 +1,24 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+
+namespace merutilm::rff2 {
+    enum class RdrGuessingMethod {
+        /**
+         * Renders all pixels.
+         */
+        NONE,
+        /**
+         * Renders the borders of the rectangles first, and fills the inside without rendering if the whole border is the interior.
+         * It is the fastest when the large minibrot is shown.
+         */
+        SOLID_GUESSING,
+        /**
+         * Verifies the filled rectangles by rendering some of the pixels.
+         * It is slower than the solid guessing, but finds most of the thinner filaments than a pixel.
+         */
+        SOLID_GUESSING_VERIFIED
+    };
+}
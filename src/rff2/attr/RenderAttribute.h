@@ -1,11 +1,14 @@
 #pragma once
 
+#include "RdrGuessingMethod.h"
+
 namespace merutilm::rff2 {
     struct RenderAttribute {
         float clarityMultiplier;
         float fps;
         bool linearInterpolation;
         uint32_t threads;
+        RdrGuessingMethod guessingMethod;
     };
 }
 
@@ -8,9 +8,12 @@
 
 #include "ShdPalColorSmoothingMethod.h"
 #include "FrtDecimalizeIterationMethod.h"
+#include "FrtInteriorDetectionMethod.h"
 #include "FrtMPACompressionMethod.h"
 #include "FrtMPASelectionMethod.h"
 #include "FrtReuseReferenceMethod.h"
+#include "FrtSegmentStorageMethod.h"
+#include "RdrGuessingMethod.h"
 #include "ShdStripeType.h"
 
 
@@ -35,6 +38,14 @@ namespace merutilm::rff2 {
                     LOG_LOG
                 };
             }
+            if constexpr (std::is_same_v<E, FrtInteriorDetectionMethod>) {
+                using enum FrtInteriorDetectionMethod;
+                return {
+                    NONE,
+                    DERIVATIVE,
+                    DERIVATIVE_AND_PERIODICITY
+                };
+            }
             if constexpr (std::is_same_v<E, FrtMPASelectionMethod>) {
                 using enum FrtMPASelectionMethod;
                 return {
@@ -50,6 +61,22 @@ namespace merutilm::rff2 {
                     STRONGEST
                 };
             }
+            if constexpr (std::is_same_v<E, FrtSegmentStorageMethod>) {
+                using enum FrtSegmentStorageMethod;
+                return {
+                    HEAP,
+                    HUGE_PAGE,
+                    MAPPED_FILE
+                };
+            }
+            if constexpr (std::is_same_v<E, RdrGuessingMethod>) {
+                using enum RdrGuessingMethod;
+                return {
+                    NONE,
+                    SOLID_GUESSING,
+                    SOLID_GUESSING_VERIFIED
+                };
+            }
             if constexpr (std::is_same_v<E, ShdPalColorSmoothingMethod>) {
                 using enum ShdPalColorSmoothingMethod;
                 return {
@@ -96,6 +123,15 @@ namespace merutilm::rff2 {
                     default: break;
                 }
             }
+            if constexpr (std::is_same_v<E, FrtInteriorDetectionMethod>) {
+                switch (value) {
+                    using enum FrtInteriorDetectionMethod;
+                    case NONE: return L"None";
+                    case DERIVATIVE: return L"Derivative";
+                    case DERIVATIVE_AND_PERIODICITY: return L"Derivative + Periodicity";
+                    default: break;
+                }
+            }
             if constexpr (std::is_same_v<E, FrtMPASelectionMethod>) {
                 switch (value) {
                     using enum FrtMPASelectionMethod;
@@ -113,6 +149,24 @@ namespace merutilm::rff2 {
                     default: break;
                 }
             }
+            if constexpr (std::is_same_v<E, FrtSegmentStorageMethod>) {
+                switch (value) {
+                    using enum FrtSegmentStorageMethod;
+                    case HEAP: return L"Heap";
+                    case HUGE_PAGE: return L"Huge page";
+                    case MAPPED_FILE: return L"Mapped file";
+                    default: break;
+                }
+            }
+            if constexpr (std::is_same_v<E, RdrGuessingMethod>) {
+                switch (value) {
+                    using enum RdrGuessingMethod;
+                    case NONE: return L"None";
+                    case SOLID_GUESSING: return L"Solid guessing";
+                    case SOLID_GUESSING_VERIFIED: return L"Solid guessing + verification";
+                    default: break;
+                }
+            }
             if constexpr (std::is_same_v<E, ShdPalColorSmoothingMethod>) {
                 switch (value) {
                     using enum ShdPalColorSmoothingMethod;
@@ -0,0 +1,208 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../calc/dex_trigonometric.h"
+#include "../data/ApproxTableCache.h"
+#include "../data/PixelGrid.h"
+#include "../formula/DeepMandelbrotPerturbator.h"
+#include "../formula/LightMandelbrotPerturbator.h"
+#include "../formula/Perturbator.h"
+#include "../formula/ScaledMandelbrotPerturbator.h"
+#include "../parallel/ParallelRenderState.h"
+#include "../preset/calc/CalculationPresets.h"
+
+/**
+ * <b>Kernel Benchmark</b>
+ * <br/>
+ * Iterates the same frame with the specialized kernel and the RUNTIME kernel of each perturbator, for each calculation preset.
+ * <li> usage : RFFKernelBenchmark [logZoom] [maxIteration] [repeats] [deepLogZoom]</li>
+ * <li> The light perturbator renders the frame of logZoom. The deep and the scaled one render the frame of deepLogZoom with the same reference and table.</li>
+ * <li> The time is the fastest of the repeats, and the iterations of the kernels must be the same.</li>
+ * <li> The selection of the compact MPA table is validated against the exact radii of the generated PAs, and must be the same.</li>
+ * <li> A PA whose skip does not fit in 32 bits is packed again into the table, and the validation must find the difference.</li>
+ */
+namespace {
+    using namespace merutilm::rff2;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto CENTER_REAL = "-0.743643887037158704752191506114774";
+    constexpr auto CENTER_IMAG = "0.131825904205311970493132056385139";
+    constexpr uint16_t WIDTH = 320;
+    constexpr uint16_t HEIGHT = 180;
+
+    template<typename P>
+    double iterateFrame(const P &perturbator, const PixelGrid &grid, std::vector<double> &out, const int repeats) {
+        double best = INFINITY;
+        for (int r = 0; r < repeats; ++r) {
+            const auto start = Clock::now();
+            for (uint16_t y = 0; y < HEIGHT; ++y) {
+                for (uint16_t x = 0; x < WIDTH; ++x) {
+                    const auto [dcr, dci] = grid(x, y);
+                    out[static_cast<size_t>(y) * WIDTH + x] = perturbator.iterate(dcr, dci);
+                }
+            }
+            best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+        }
+        return best;
+    }
+
+    /**
+     * Compares the specialized kernel of the perturbator with its RUNTIME kernel. The perturbator is left with the RUNTIME kernel.
+     * @return whether the iterations and the selection of the table are the same
+     */
+    template<typename P>
+    bool compareKernels(const Presets::CalculationPreset &preset, const char *name, P &perturbator,
+                        const PixelGrid &grid, const uint64_t tableMemory, const int repeats) {
+        auto specialized = std::vector<double>(static_cast<size_t>(WIDTH) * HEIGHT);
+        auto runtime = std::vector<double>(specialized.size());
+        const double specializedTime = iterateFrame(perturbator, grid, specialized, repeats);
+        perturbator.useRuntimeKernel();
+        const double runtimeTime = iterateFrame(perturbator, grid, runtime, repeats);
+
+        const bool same = specialized == runtime;
+        const uint64_t mismatches = perturbator.getTable().validateSelection();
+        std::printf("%-12s %-6s specialized %8.4fs  runtime %8.4fs  gain %6.3fx  %s  table %8.2f MiB  selection %s\n",
+                    preset.getName().c_str(), name, specializedTime, runtimeTime, runtimeTime / specializedTime,
+                    same ? "same" : "DIFFERENT", static_cast<double>(tableMemory) / (1 << 20),
+                    mismatches == 0 ? "same" : "DIFFERENT");
+        return same && mismatches == 0;
+    }
+
+    /**
+     * @return the memory of the table for the rendering, without the exact radii kept for the validation
+     */
+    template<typename T>
+    uint64_t packedMemory(const T &table) {
+        return table.allocatedMemory() - table.exactRadii.capacity() * sizeof(table.exactRadii[0]);
+    }
+
+    LightPA unpack(const LightPA::Entry &entry, const uint64_t skip, const double radius) {
+        return LightPA(entry.anr, entry.ani, entry.bnr, entry.bni, skip, radius);
+    }
+
+    DeepPA unpack(const DeepPA::Entry &entry, const uint64_t skip, const dex &radius) {
+        return DeepPA(entry.anr(), entry.ani(), entry.bnr(), entry.bni(), skip, radius);
+    }
+
+    /**
+     * Packs the first PA of the table again with the skip which does not fit in 32 bits, so its compact radius is lost.
+     * The PA is restored after that.
+     * @return whether the validation finds the lost radius, or the table has no PA
+     */
+    template<typename P, typename T>
+    bool checkLossyPack(const char *name, const P &perturbator, T &table) {
+        if (table.pas.empty()) {
+            return true;
+        }
+        const auto entry = table.pas[0];
+        const auto radius = table.exactRadii[0];
+        table.set(0, unpack(entry, static_cast<uint64_t>(UINT32_MAX) + 1, radius));
+        const uint64_t mismatches = perturbator.getTable().validateSelection();
+        table.set(0, unpack(entry, entry.skip, radius));
+
+        const bool detected = mismatches != 0 && mismatches != UINT64_MAX;
+        std::printf("%-12s %-6s lossy pack %s\n", "", name, detected ? "detected" : "NOT DETECTED");
+        return detected;
+    }
+
+    FractalAttribute createAttribute(const Presets::CalculationPreset &preset, const float logZoom,
+                                     const uint64_t maxIteration) {
+        return FractalAttribute{
+            .center = fp_complex(CENTER_REAL, CENTER_IMAG, Perturbator::logZoomToExp10(logZoom)),
+            .logZoom = logZoom,
+            .maxIteration = maxIteration,
+            .bailout = 2,
+            .decimalizeIterationMethod = FrtDecimalizeIterationMethod::LOG_LOG,
+            .mpaAttribute = preset.genMPA(),
+            .referenceCompAttribute = preset.genReferenceCompression(),
+            .reuseReferenceMethod = FrtReuseReferenceMethod::DISABLED,
+            .autoMaxIteration = false,
+            .autoIterationMultiplier = 100,
+            .absoluteIterationMode = false,
+            .interiorDetectionMethod = FrtInteriorDetectionMethod::DERIVATIVE,
+            .threadedReferenceMinBits = UINT32_MAX,
+            .referenceCheckpointInterval = 0,
+            .referenceCacheCapacity = 0,
+            .referenceStorageMethod = FrtSegmentStorageMethod::HEAP,
+            .tableStorageMethod = FrtSegmentStorageMethod::HEAP,
+            .scratchDirectory = ""
+        };
+    }
+
+    dex getDcMax(const PixelGrid &grid) {
+        const auto [vr, vi] = grid(0, 0);
+        dex dcMax = dex::ZERO;
+        dex_trigonometric::hypot_approx(&dcMax, vr, vi);
+        return dcMax;
+    }
+
+    bool benchmarkLight(const Presets::CalculationPreset &preset, const float logZoom, const uint64_t maxIteration,
+                        const int repeats) {
+        const auto calc = createAttribute(preset, logZoom, maxIteration);
+        const auto grid = PixelGrid(WIDTH, HEIGHT, logZoom, 1);
+        auto state = ParallelRenderState();
+        auto tableRef = ApproxTableCache();
+        tableRef.keepExactRadii = true;
+        const auto perturbator = std::make_unique<LightMandelbrotPerturbator>(
+            state, calc, static_cast<double>(getDcMax(grid)), Perturbator::logZoomToExp10(logZoom), 0, tableRef,
+            [](uint64_t) {
+            }, [](uint64_t, double) {
+            });
+        const bool same = compareKernels(preset, "light", *perturbator, grid, packedMemory(tableRef.lightTable), repeats);
+        return checkLossyPack("light", *perturbator, tableRef.lightTable) && same;
+    }
+
+    bool benchmarkDeep(const Presets::CalculationPreset &preset, const float logZoom, const uint64_t maxIteration,
+                       const int repeats) {
+        const auto calc = createAttribute(preset, logZoom, maxIteration);
+        const auto grid = PixelGrid(WIDTH, HEIGHT, logZoom, 1);
+        auto state = ParallelRenderState();
+        auto tableRef = ApproxTableCache();
+        tableRef.keepExactRadii = true;
+        const auto deep = std::make_unique<DeepMandelbrotPerturbator>(
+            state, calc, getDcMax(grid), Perturbator::logZoomToExp10(logZoom), 0, tableRef, [](uint64_t) {
+            }, [](uint64_t, double) {
+            });
+        const uint64_t tableMemory = packedMemory(tableRef.deepTable);
+        bool same = compareKernels(preset, "deep", *deep, grid, tableMemory, repeats);
+        // the scaled one selects its kernel again, so the RUNTIME kernel of the deep one is not carried.
+        const auto scaled = deep->toScaled(tableRef);
+        same &= compareKernels(preset, "scaled", *scaled, grid, tableMemory, repeats);
+        return checkLossyPack("deep", *scaled, tableRef.deepTable) && same;
+    }
+}
+
+int main(const int argc, char **argv) {
+    using namespace merutilm::rff2;
+    const float logZoom = argc > 1 ? std::stof(argv[1]) : 30;
+    const uint64_t maxIteration = argc > 2 ? std::stoull(argv[2]) : 20000;
+    const int repeats = argc > 3 ? std::stoi(argv[3]) : 3;
+    const float deepLogZoom = argc > 4 ? std::stof(argv[4]) : 320;
+
+    const std::unique_ptr<Presets::CalculationPreset> presets[] = {
+        std::make_unique<CalculationPresets::UltraFast>(),
+        std::make_unique<CalculationPresets::Fast>(),
+        std::make_unique<CalculationPresets::Normal>(),
+        std::make_unique<CalculationPresets::Best>(),
+        std::make_unique<CalculationPresets::UltraBest>(),
+        std::make_unique<CalculationPresets::Stable>(),
+        std::make_unique<CalculationPresets::MoreStable>(),
+        std::make_unique<CalculationPresets::UltraStable>()
+    };
+    std::printf("logZoom %g, deep logZoom %g, max iteration %llu, %ux%u\n", logZoom, deepLogZoom,
+                static_cast<unsigned long long>(maxIteration), WIDTH, HEIGHT);
+    bool same = true;
+    for (const auto &preset: presets) {
+        same &= benchmarkLight(*preset, logZoom, maxIteration, repeats);
+        same &= benchmarkDeep(*preset, deepLogZoom, maxIteration, repeats);
+    }
+    return same ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#include "fp_fixed.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace merutilm::rff2 {
+    fp_fixed::fp_fixed(const mp_size_t size) : limbs(size, 0) {
+    }
+
+    fp_fixed::fp_fixed(const fp_decimal_calculator &value, const mp_size_t size) : limbs(size, 0) {
+        // limbs = |value| * 2^(exp2 + 64 * (size - 1))
+        mpz_t magnitude;
+        mpz_init(magnitude);
+        mpz_abs(magnitude, value.value);
+        if (const int shift = value.exp2 + static_cast<int>(64 * (size - 1)); shift >= 0) {
+            mpz_mul_2exp(magnitude, magnitude, shift);
+        } else {
+            mpz_tdiv_q_2exp(magnitude, magnitude, -shift);
+        }
+        const auto length = std::min(static_cast<mp_size_t>(mpz_size(magnitude)), size);
+        mpn_copyi(limbs.data(), mpz_limbs_read(magnitude), length);
+        negative = mpz_sgn(value.value) < 0;
+        mpz_clear(magnitude);
+    }
+
+    /**
+     * <b> A + B </b> <br/><br/>
+     * It assumes that the sizes of both numbers are the same. The output can be the same as the input.
+     * @param out the result
+     * @param a input A
+     * @param b input B
+     */
+    void fp_fixed::fp_add(fp_fixed &out, const fp_fixed &a, const fp_fixed &b) {
+        addSigned(out, a, b, b.negative);
+    }
+
+    /**
+     * <b> A - B </b> <br/><br/>
+     * It assumes that the sizes of both numbers are the same. The output can be the same as the input.
+     * @param out the result
+     * @param a input A
+     * @param b input B
+     */
+    void fp_fixed::fp_sub(fp_fixed &out, const fp_fixed &a, const fp_fixed &b) {
+        addSigned(out, a, b, !b.negative);
+    }
+
+    /**
+     * <b> A * B </b> <br/><br/>
+     * It assumes that the sizes of both numbers are the same. The output can be the same as the input.
+     * @param out the result
+     * @param a input A
+     * @param b input B
+     * @param scratch the scratch of @code scratchSize(size)@endcode limbs. It must not be the same as the others.
+     */
+    void fp_fixed::fp_mul(fp_fixed &out, const fp_fixed &a, const fp_fixed &b, mp_limb_t *scratch) {
+        const mp_size_t n = a.size();
+        const bool resultNegative = a.negative != b.negative;
+
+        if (n >= TRUNCATED_MUL_MIN_SIZE && n <= TRUNCATED_MUL_MAX_SIZE) {
+            // Only the columns from (n - 2) are accumulated. The dropped ones are at most n units of the lowest limb,
+            // and the guard limb of the size absorbs it.
+            const mp_size_t low = std::max<mp_size_t>(n - 2, 0);
+            mpn_zero(scratch + low, 2 * n - low);
+            for (mp_size_t i = 0; i < n; ++i) {
+                const mp_size_t j = std::max<mp_size_t>(low - i, 0);
+                scratch[i + n] = mpn_addmul_1(scratch + i + j, b.limbs.data() + j, n - j, a.limbs[i]);
+            }
+        } else {
+            mpn_mul_n(scratch, a.limbs.data(), b.limbs.data(), n);
+        }
+
+        mpn_copyi(out.limbs.data(), scratch + n - 1, n);
+        if (scratch[2 * n - 1] != 0) {
+            saturate(out);
+        }
+        out.negative = resultNegative && !out.isZero();
+    }
+
+    /**
+     * <b> A * B </b> <br/><br/>
+     * Multiplies the unbounded decimal by the fixed one. The result has the exponent of A.
+     * It is for the numbers which can be larger than the integer limb, such as the derivative.
+     * @param out the result
+     * @param a input A
+     * @param b input B
+     */
+    void fp_fixed::fp_mul(fp_decimal_calculator &out, const fp_decimal_calculator &a, const fp_fixed &b) {
+        mpz_t view;
+        mpz_roinit_n(view, b.limbs.data(), b.negative ? -b.size() : b.size());
+        mpz_mul(out.temp, a.value, view);
+        mpz_div_2exp(out.value, out.temp, 64 * (b.size() - 1));
+    }
+
+    /**
+     * Doubles value. It assumes that the sizes of both numbers are the same.
+     * @param out the result
+     * @param target input
+     */
+    void fp_fixed::fp_dbl(fp_fixed &out, const fp_fixed &target) {
+        if (mpn_lshift(out.limbs.data(), target.limbs.data(), target.size(), 1) != 0) {
+            saturate(out);
+        }
+        out.negative = target.negative;
+    }
+
+    mp_size_t fp_fixed::exp10ToSize(const int exp10) {
+        const int bits = -fp_decimal_calculator::exp10ToExp2(exp10);
+        // the integer limb, and the guard limb.
+        return (std::max(bits, 0) + 63) / 64 + 2;
+    }
+
+    size_t fp_fixed::scratchSize(const mp_size_t size) {
+        return static_cast<size_t>(size) * 2;
+    }
+
+    mp_size_t fp_fixed::size() const {
+        return static_cast<mp_size_t>(limbs.size());
+    }
+
+    double fp_fixed::double_value() const {
+        if (isZero()) {
+            return 0;
+        }
+        uint64_t mantissa;
+        const int exp2 = mantissa53(&mantissa);
+        const double result = std::ldexp(static_cast<double>(mantissa), exp2 - 52);
+        return negative ? -result : result;
+    }
+
+    void fp_fixed::double_exp_value(dex *result) const {
+        if (isZero()) {
+            dex::cpy(result, dex::ZERO);
+            return;
+        }
+        uint64_t mantissa_bit;
+        const int exp2 = mantissa53(&mantissa_bit);
+        const double mantissa = std::bit_cast<double>(0x3ff0000000000000ULL | (mantissa_bit & 0x000fffffffffffffULL));
+
+        dex::cpy(result, mantissa);
+        dex::mul_2exp(result, *result, exp2);
+        if (negative) dex::neg(result);
+    }
+
+    fp_decimal_calculator fp_fixed::decimal_value(const int exp10) const {
+        auto result = fp_decimal_calculator(0.0, exp10);
+        mpz_t magnitude;
+        mpz_roinit_n(magnitude, limbs.data(), size());
+
+        // value = limbs * 2^(-64 * (size - 1) - exp2)
+        if (const int shift = -static_cast<int>(64 * (size() - 1)) - result.exp2; shift >= 0) {
+            mpz_mul_2exp(result.value, magnitude, shift);
+        } else {
+            mpz_tdiv_q_2exp(result.value, magnitude, -shift);
+        }
+        if (negative) {
+            mpz_neg(result.value, result.value);
+        }
+        return result;
+    }
+
+    void fp_fixed::addSigned(fp_fixed &out, const fp_fixed &a, const fp_fixed &b, const bool bNegative) {
+        const mp_size_t n = a.size();
+        mp_limb_t *o = out.limbs.data();
+        const mp_limb_t *x = a.limbs.data();
+        const mp_limb_t *y = b.limbs.data();
+        bool resultNegative;
+
+        if (a.negative == bNegative) {
+            if (mpn_add_n(o, x, y, n) != 0) {
+                saturate(out);
+            }
+            resultNegative = a.negative;
+        } else if (mpn_cmp(x, y, n) >= 0) {
+            mpn_sub_n(o, x, y, n);
+            resultNegative = a.negative;
+        } else {
+            mpn_sub_n(o, y, x, n);
+            resultNegative = bNegative;
+        }
+        out.negative = resultNegative && !out.isZero();
+    }
+
+    void fp_fixed::saturate(fp_fixed &out) {
+        std::fill(out.limbs.begin(), out.limbs.end(), ~static_cast<mp_limb_t>(0));
+    }
+
+    int fp_fixed::mantissa53(uint64_t *mantissa) const {
+        mp_size_t top = size() - 1;
+        while (limbs[top] == 0) {
+            --top;
+        }
+        const uint64_t high = limbs[top];
+        const uint64_t low = top > 0 ? limbs[top - 1] : 0;
+        const int leadingZeros = std::countl_zero(high);
+        const uint64_t bits = leadingZeros == 0 ? high : high << leadingZeros | low >> (64 - leadingZeros);
+        *mantissa = bits >> 11;
+        return static_cast<int>(64 * (top - (size() - 1))) + 63 - leadingZeros;
+    }
+
+    bool fp_fixed::isZero() const {
+        return mpn_zero_p(limbs.data(), size());
+    }
+}
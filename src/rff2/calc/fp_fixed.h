@@ -0,0 +1,86 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "dex.h"
+#include "fp_decimal_calculator.h"
+#include "gmp.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Fixed-limb Decimal</b>
+     * <br/>
+     * The arbitrary-precision fixed-point number for the hot loop of the reference orbit.
+     * It is built on the @code mpn_*@endcode primitives on the limbs allocated once, so the operations never touch the allocator.
+     * <li> value = (-1)^negative * limbs * 2^(-64 * (size - 1)). The top limb is the integer part, so it is only for the small numbers like the orbit.</li>
+     * <li> The size is fixed by the precision. It keeps one more fraction limb than required, which absorbs the error of the truncated multiplication.</li>
+     * <li> The multiplication computes the high half only, because the low half is thrown away anyway.</li>
+     * <li> The result which exceeds the integer limb is saturated to the largest value, instead of wrapping around.
+     * It happens only with the huge bailout, and the saturated orbit still escapes.</li>
+     */
+    struct fp_fixed final {
+        std::vector<mp_limb_t> limbs;
+        bool negative = false;
+
+        /**
+         * The size range to use the truncated schoolbook multiplication. The others use the full @code mpn_mul_n@endcode.
+         * The smaller ones lose to its assembly basecase by the call overhead of each row,
+         * and the larger ones lose to its sub-quadratic algorithm.
+         */
+        static constexpr mp_size_t TRUNCATED_MUL_MIN_SIZE = 10;
+        static constexpr mp_size_t TRUNCATED_MUL_MAX_SIZE = 56;
+
+        explicit fp_fixed() = default;
+
+        explicit fp_fixed(mp_size_t size);
+
+        explicit fp_fixed(const fp_decimal_calculator &value, mp_size_t size);
+
+        static void fp_add(fp_fixed &out, const fp_fixed &a, const fp_fixed &b);
+
+        static void fp_sub(fp_fixed &out, const fp_fixed &a, const fp_fixed &b);
+
+        static void fp_mul(fp_fixed &out, const fp_fixed &a, const fp_fixed &b, mp_limb_t *scratch);
+
+        static void fp_mul(fp_decimal_calculator &out, const fp_decimal_calculator &a, const fp_fixed &b);
+
+        static void fp_dbl(fp_fixed &out, const fp_fixed &target);
+
+        /**
+         * @return the number of limbs for the precision of given exponent of 10.
+         */
+        static mp_size_t exp10ToSize(int exp10);
+
+        /**
+         * @return the number of limbs of the scratch required by @code fp_mul@endcode.
+         */
+        static size_t scratchSize(mp_size_t size);
+
+        [[nodiscard]] mp_size_t size() const;
+
+        [[nodiscard]] double double_value() const;
+
+        void double_exp_value(dex *result) const;
+
+        [[nodiscard]] fp_decimal_calculator decimal_value(int exp10) const;
+
+    private:
+        static void addSigned(fp_fixed &out, const fp_fixed &a, const fp_fixed &b, bool bNegative);
+
+        /**
+         * Sets the magnitude to the largest value of the limbs. The sign is not changed.
+         */
+        static void saturate(fp_fixed &out);
+
+        /**
+         * @return the exponent of the highest bit, and writes its 53 bits truncated mantissa. The value must not be zero.
+         */
+        [[nodiscard]] int mantissa53(uint64_t *mantissa) const;
+
+        [[nodiscard]] bool isZero() const;
+    };
+}
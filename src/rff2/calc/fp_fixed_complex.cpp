@@ -0,0 +1,53 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#include "fp_fixed_complex.h"
+
+namespace merutilm::rff2 {
+    fp_fixed_complex::fp_fixed_complex(const mp_size_t size) : real(size), imag(size),
+                                                                temp{fp_fixed(size), fp_fixed(size), fp_fixed(size)},
+                                                                scratch(fp_fixed::scratchSize(size)) {
+    }
+
+    fp_fixed_complex::fp_fixed_complex(const fp_complex_calculator &value, const mp_size_t size) : fp_fixed_complex(size) {
+        real = fp_fixed(value.getRealClone(), size);
+        imag = fp_fixed(value.getImagClone(), size);
+    }
+
+    void fp_fixed_complex::squareAdd(const fp_fixed_complex &c) {
+        //REAL : (a+b)(a-b) + cr
+        //IMAG : 2ab + ci
+        fp_fixed::fp_add(temp[0], real, imag);
+        fp_fixed::fp_sub(temp[1], real, imag);
+        fp_fixed::fp_mul(temp[2], temp[0], temp[1], scratch.data());
+        fp_fixed::fp_mul(temp[0], real, imag, scratch.data());
+        fp_fixed::fp_add(real, temp[2], c.real);
+        fp_fixed::fp_dbl(imag, temp[0]);
+        fp_fixed::fp_add(imag, imag, c.imag);
+    }
+
+    fp_fixed &fp_fixed_complex::getReal() {
+        return real;
+    }
+
+    fp_fixed &fp_fixed_complex::getImag() {
+        return imag;
+    }
+
+    const fp_fixed &fp_fixed_complex::getReal() const {
+        return real;
+    }
+
+    const fp_fixed &fp_fixed_complex::getImag() const {
+        return imag;
+    }
+
+    mp_size_t fp_fixed_complex::size() const {
+        return real.size();
+    }
+
+    fp_complex_calculator fp_fixed_complex::calculator_value(const int exp10) const {
+        return fp_complex_calculator(real.decimal_value(exp10), imag.decimal_value(exp10), exp10);
+    }
+}
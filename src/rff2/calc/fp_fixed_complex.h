@@ -0,0 +1,48 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+
+#include <array>
+
+#include "fp_complex_calculator.h"
+#include "fp_fixed.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Fixed-limb Complex</b>
+     * <br/>
+     * The complex number of @code fp_fixed@endcode with its own temporaries and scratch, for the reference orbit.
+     * Nothing is allocated after the construction.
+     */
+    class fp_fixed_complex final {
+        fp_fixed real;
+        fp_fixed imag;
+        std::array<fp_fixed, 3> temp;
+        std::vector<mp_limb_t> scratch;
+
+    public:
+        explicit fp_fixed_complex(mp_size_t size);
+
+        explicit fp_fixed_complex(const fp_complex_calculator &value, mp_size_t size);
+
+        /**
+         * z = z^2 + c, fused.
+         * @param c the value to add
+         */
+        void squareAdd(const fp_fixed_complex &c);
+
+        fp_fixed &getReal();
+
+        fp_fixed &getImag();
+
+        [[nodiscard]] const fp_fixed &getReal() const;
+
+        [[nodiscard]] const fp_fixed &getImag() const;
+
+        [[nodiscard]] mp_size_t size() const;
+
+        [[nodiscard]] fp_complex_calculator calculator_value(int exp10) const;
+    };
+}
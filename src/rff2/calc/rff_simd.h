@@ -0,0 +1,52 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define RFF_SIMD_X86 1
+#endif
+
+namespace merutilm::rff2 {
+    /**
+     * <b>SIMD support</b><br/>
+     * Detects the widest double-precision SIMD instruction set that the running CPU (and OS) supports. <br/>
+     * The kernels are compiled with per-function target attributes, so the binary still runs on CPUs without them.
+     */
+    struct rff_simd {
+        enum class Level {
+            SCALAR,
+            AVX2,
+            AVX512
+        };
+
+        rff_simd() = delete;
+
+        /**
+         * @return The detected level. It is detected only once.
+         */
+        static Level level();
+
+    private:
+        static Level detect();
+    };
+
+    inline rff_simd::Level rff_simd::level() {
+        static const Level detected = detect();
+        return detected;
+    }
+
+    inline rff_simd::Level rff_simd::detect() {
+#ifdef RFF_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return Level::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return Level::AVX2;
+        }
+#endif
+        return Level::SCALAR;
+    }
+}
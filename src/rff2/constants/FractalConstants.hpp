@@ -7,13 +7,29 @@
 
 namespace merutilm::rff2::Constants::Fractal {
     constexpr int EXIT_CHECK_INTERVAL = 256;
+    constexpr uint64_t BATCH_MIN_TABLE_PERIOD = 8; // below this, the MPA lookups of the lanes cost more than the SIMD step saves
+    constexpr uint64_t BATCH_MIN_UNCOMPRESSED_TABLE_PERIOD = 16; // the same, the uncompressed table has the PAs of every level to look up
+    constexpr uint32_t THREADED_REFERENCE_MIN_BITS = 20000; // below this, the barriers of the threaded reference cost more than the multiplications
+    constexpr uint32_t REFERENCE_CHECKPOINT_INTERVAL = 60; // seconds
+    constexpr auto REFERENCE_CHECKPOINT_DIRECTORY = L"rff2_reference_checkpoint"; // in the scratch directory
+    constexpr uint32_t REFERENCE_CHECKPOINT_CAPACITY = 4096; // MiB, the least recently used checkpoints beyond this are removed
+    constexpr uint32_t REFERENCE_CACHE_CAPACITY = 4096; // MiB
+    constexpr auto REFERENCE_CACHE_DIRECTORY = L"rff2_reference_cache"; // in the temp directory
+    constexpr std::chrono::seconds REFERENCE_CACHE_MIN_DURATION(1); // the faster references are computed again rather than written
+    constexpr auto SCRATCH_DIRECTORY = L"rff2_scratch"; // in the temp directory, the files of the mapped segments and the checkpoints
+    constexpr double INTERIOR_DERIVATIVE_THRESHOLD = 1e-12; // the squared norm of dz/dz1, below this the orbit is attracted to a cycle
+    constexpr int INTERIOR_CHECK_INTERVAL = 16; // the scaled derivative grows at most 16 times per iteration, so it is rescaled at this interval
+    constexpr double INTERIOR_PERIODICITY_EPSILON = 1e-24; // the squared distance to the saved z, relative to the squared norm of z
     constexpr float ZOOM_MIN = 1.0f;
     constexpr float ZOOM_INTERVAL = 0.235f;
     constexpr float ZOOM_DEADLINE = 290;
+    constexpr float SCALED_MAX_ZOOM_WITH_MPA = 1000; // beyond this, the deep perturbator is faster when the MPA is used
     constexpr uint64_t MINIMUM_ITERATION = 100;
     constexpr uint16_t GAUSSIAN_MAX_WIDTH = 200;
     constexpr int GAUSSIAN_REQUIRES_BOX = 3;
     constexpr double INTENTIONAL_ERROR_OFFSET_MIN_PIX = 0.25;
+    constexpr uint16_t PROGRESSIVE_PREVIEW_STEP = 8; // the distance of the pixels of the first preview pass, halved every pass
+    constexpr double SHIFT_PIXEL_TOLERANCE = 1e-3; // the moved center must be this close to the whole pixels to move the previous pixels
     constexpr double INTENTIONAL_ERROR_DCLMB = 1e16; //DCmax for Locate Minibrot
     constexpr double INTENTIONAL_ERROR_REFZERO_POWER = 1024; // multiplier of exp10 when zr, zi is zero
     constexpr int EXP10_ADDITION = 15;
@@ -11,15 +11,34 @@
 #include <memory>
 #include <algorithm>
 
+#include "CompactPATable.h"
+#include "../calc/dex.h"
 #include "../mrthy/DeepPA.h"
 #include "../mrthy/LightPA.h"
-#include "../mrthy/SparseVector.h"
+#include "../parallel/ParallelThreadPool.h"
 
 namespace merutilm::rff2 {
 
     struct ApproxTableCache {
-        SparseVector<std::vector<LightPA>> lightTable;
-        SparseVector<std::vector<DeepPA>> deepTable;
+        CompactPATable<LightPA, double> lightTable;
+        CompactPATable<DeepPA, dex> deepTable;
+        /**
+         * The pool to generate the table. The table is generated on the caller thread if it is null.
+         */
+        ParallelThreadPool *threadPool = nullptr;
+        /**
+         * The number of threads to generate the table.
+         */
+        uint32_t threads = 1;
+        /**
+         * The storage of the tables, which is used from the next generation or load.
+         */
+        SegmentStorage storage;
+        /**
+         * Whether the generated tables keep the exact radii of their PAs, which validateSelection() of the MPA table compares with.
+         * It takes one more radius per PA, so it is only for the validation.
+         */
+        bool keepExactRadii = false;
 
         ApproxTableCache() = default;
         ~ApproxTableCache() = default;
@@ -35,16 +54,8 @@ namespace merutilm::rff2 {
             deepTable.clear();
         }
 
-        size_t lightTableSegmentCount() const {
-            return lightTable.segment_count();
-        }
-
-        size_t deepTableSegmentCount() const {
-            return deepTable.segment_count();
-        }
-
         size_t approximateMemoryUsage() const {
-            return lightTable.allocated_memory() + deepTable.allocated_memory();
+            return lightTable.allocatedMemory() + deepTable.allocatedMemory();
         }
     };
 
@@ -0,0 +1,179 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "../mrthy/SegmentStorage.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Compact PA Table</b>
+     * <br/>
+     * The read-only MPA table after the generation.
+     * <li> The PAs of the table index i are @code pas[offsets[i]]@endcode to @code pas[offsets[i + 1] - 1]@endcode in one contiguous array.</li>
+     * <li> The upper bits of the radii are moved into their own array as the bounds, because the lookup scans only them until the valid PA is found.
+     * The coefficients, the 32-bit skip and the lower bits of the radius are read together, so they are kept in the packed entry of the PA.</li>
+     * <li> The bound is the radius rounded down. The lower bits are compared only when the bound is the same as the distance,
+     * so the selected PA and the result are the same as the generated table. validateSelection() of the MPA table checks it
+     * against the exact radii of the generated PAs, which are kept only when the table is allocated for the validation.</li>
+     * <li> The PAs are allocated at once before the generation, and each generated PA is stored at its own position.
+     * Nothing is allocated or resized after that, so it is safe to read from the render threads at once.</li>
+     * <li> The PAs and the bounds are allocated from the storage, which is chosen apart from the reference orbit.</li>
+     * @tparam P @code LightPA@endcode or @code DeepPA@endcode
+     * @tparam Num the type of the radius
+     * @tparam Storage the storage of the PAs and the bounds
+     */
+    template<typename P, typename Num, typename Storage = SegmentStorage>
+    struct CompactPATable {
+        using Entry = typename P::Entry;
+        using Bound = typename P::Bound;
+
+        std::vector<uint64_t> offsets;
+        std::vector<Entry, SegmentAllocator<Entry, Storage> > pas;
+        std::vector<Bound, SegmentAllocator<Bound, Storage> > bounds;
+        /**
+         * The radii of the generated PAs before they are packed, at the same positions as the PAs.
+         * It is empty unless the table is allocated to keep them, and is never read by the lookup.
+         */
+        std::vector<Num> exactRadii;
+
+        CompactPATable() = default;
+
+        /**
+         * @param storage the storage of the PAs and the bounds, until they are allocated again
+         */
+        explicit CompactPATable(const Storage &storage);
+
+        void clear();
+
+        /**
+         * @return the number of the table indices
+         */
+        [[nodiscard]] uint64_t size() const;
+
+        /**
+         * @return the PAs of the table index, which is lower than @code size()@endcode.
+         */
+        [[nodiscard]] std::span<const Entry> at(uint64_t index) const;
+
+        /**
+         * Scans the offsets forward from the table index, without reading the PAs.
+         * @return the distance to the next table index which has any PA, at most the limit.
+         * It is @code UINT64_MAX@endcode when no table index from there has the PA.
+         */
+        [[nodiscard]] uint64_t distanceToNextEntry(uint64_t index, uint64_t limit) const;
+
+        /**
+         * @return the exact radius of the PA at the given position
+         */
+        [[nodiscard]] Num radius(uint64_t position) const;
+
+        /**
+         * Appends the PA of the last table index. The offsets must be set by the caller.
+         */
+        void add(const P &pa);
+
+        /**
+         * Replaces the table with the PAs of the given offsets, which are not stored yet.
+         * @param offsets the offsets of the table indices, and the number of the PAs at the end
+         * @param storage the storage of the PAs and the bounds
+         * @param keepExactRadii whether the radii of the generated PAs are kept for the validation
+         */
+        void allocate(std::vector<uint64_t> &&offsets, const Storage &storage, bool keepExactRadii = false);
+
+        /**
+         * Stores the PA at the position allocated by allocate().
+         * The different positions can be stored from the different threads at once.
+         */
+        void set(uint64_t position, const P &pa);
+
+        [[nodiscard]] size_t allocatedMemory() const;
+    };
+
+    // DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE
+    // DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE
+    // DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE
+    // DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE  DEFINITION OF COMPACT PA TABLE
+
+
+    template<typename P, typename Num, typename Storage>
+    CompactPATable<P, Num, Storage>::CompactPATable(const Storage &storage) : pas(SegmentAllocator<Entry, Storage>(storage)),
+        bounds(SegmentAllocator<Bound, Storage>(storage)) {
+    }
+
+    template<typename P, typename Num, typename Storage>
+    void CompactPATable<P, Num, Storage>::clear() {
+        offsets.clear();
+        pas.clear();
+        bounds.clear();
+        exactRadii.clear();
+    }
+
+    template<typename P, typename Num, typename Storage>
+    uint64_t CompactPATable<P, Num, Storage>::size() const {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    template<typename P, typename Num, typename Storage>
+    std::span<const typename CompactPATable<P, Num, Storage>::Entry> CompactPATable<P, Num, Storage>::at(const uint64_t index) const {
+        return std::span<const Entry>(pas.data() + offsets[index], offsets[index + 1] - offsets[index]);
+    }
+
+    template<typename P, typename Num, typename Storage>
+    uint64_t CompactPATable<P, Num, Storage>::distanceToNextEntry(const uint64_t index, const uint64_t limit) const {
+        const uint64_t length = size();
+        if (index >= length) {
+            return UINT64_MAX;
+        }
+        const uint64_t end = std::min(length, index + limit);
+        for (uint64_t i = index; i < end; ++i) {
+            if (offsets[i] != offsets[i + 1]) {
+                return i - index;
+            }
+        }
+        return end == length ? UINT64_MAX : limit;
+    }
+
+    template<typename P, typename Num, typename Storage>
+    Num CompactPATable<P, Num, Storage>::radius(const uint64_t position) const {
+        return pas[position].radius(bounds[position]);
+    }
+
+    template<typename P, typename Num, typename Storage>
+    void CompactPATable<P, Num, Storage>::add(const P &pa) {
+        pas.emplace_back(pa);
+        bounds.emplace_back(pa);
+    }
+
+    template<typename P, typename Num, typename Storage>
+    void CompactPATable<P, Num, Storage>::allocate(std::vector<uint64_t> &&offsets, const Storage &storage,
+                                                   const bool keepExactRadii) {
+        clear();
+        this->offsets = std::move(offsets);
+        pas = decltype(pas)(this->offsets.back(), SegmentAllocator<Entry, Storage>(storage));
+        bounds = decltype(bounds)(this->offsets.back(), SegmentAllocator<Bound, Storage>(storage));
+        if (keepExactRadii) {
+            exactRadii.resize(this->offsets.back());
+        }
+    }
+
+    template<typename P, typename Num, typename Storage>
+    void CompactPATable<P, Num, Storage>::set(const uint64_t position, const P &pa) {
+        pas[position] = Entry(pa);
+        bounds[position] = Bound(pa);
+        if (!exactRadii.empty()) {
+            exactRadii[position] = pa.radius;
+        }
+    }
+
+    template<typename P, typename Num, typename Storage>
+    size_t CompactPATable<P, Num, Storage>::allocatedMemory() const {
+        return offsets.capacity() * sizeof(uint64_t) + pas.capacity() * sizeof(Entry) + bounds.capacity() * sizeof(Bound) +
+               exactRadii.capacity() * sizeof(Num);
+    }
+}
@@ -0,0 +1,285 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../attr/FractalAttribute.h"
+#include "../formula/MandelbrotContinuation.h"
+#include "../formula/MandelbrotReference.h"
+#include "../formula/Perturbator.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Continuation Buffer</b>
+     * <br/>
+     * The side buffer of the iteration matrix, which keeps where each pixel stopped.
+     * When only the max iteration is raised, the pixels at the previous max iteration are continued from here,
+     * and the others keep their iterations.
+     * <li> Each pixel has a slot of the state, or one of the markers. The states are stored only for the pixels which reached the max iteration.</li>
+     * <li> The new states of a pass are pending until the pass is committed, so the stored ones are safe to continue in place from the render threads.</li>
+     * <li> The states of the pixels which are not continuable anymore are dropped when the pass is committed, so the states do not grow over the passes.</li>
+     * <li> The buffer is valid only for the key of the last completed pass. The center, zoom, reference, table and the settings which change the escaped iterations are keyed.</li>
+     * <li> When the center is moved by the whole pixels, the slots are moved with the iteration matrix.</li>
+     */
+    class ContinuationBuffer final {
+        struct Key {
+            FractalAttribute calc;
+            uint16_t width;
+            uint16_t height;
+            /**
+             * The generation of the reference. The address can be reused by the new reference after the old one is freed.
+             */
+            uint64_t referenceGeneration;
+        };
+
+        std::vector<uint32_t> slots;
+        std::vector<MandelbrotContinuation> states;
+        std::vector<std::pair<uint32_t, MandelbrotContinuation> > pending;
+        std::mutex pendingMutex;
+        std::optional<Key> key = std::nullopt;
+
+    public:
+        /**
+         * The pixel is not iterated in the last pass, e.g. filled by the guessing.
+         */
+        static constexpr uint32_t UNKNOWN = UINT32_MAX;
+        /**
+         * The pixel escaped, so its iteration is final.
+         */
+        static constexpr uint32_t ESCAPED = UINT32_MAX - 1;
+        /**
+         * The pixel is the interior, so it is the max iteration of any pass.
+         */
+        static constexpr uint32_t INTERIOR = UINT32_MAX - 2;
+
+        ContinuationBuffer() = default;
+
+        ContinuationBuffer(const ContinuationBuffer &) = delete;
+
+        ContinuationBuffer &operator=(const ContinuationBuffer &) = delete;
+
+        ContinuationBuffer(ContinuationBuffer &&) = delete;
+
+        ContinuationBuffer &operator=(ContinuationBuffer &&) = delete;
+
+        /**
+         * Drops all states, and marks all pixels unknown for the new pass.
+         * @param length the number of the pixels
+         */
+        void reset(uint32_t length);
+
+        /**
+         * Drops the key, so the next pass starts from zero.
+         */
+        void invalidate();
+
+        /**
+         * Moves the pending states of the pass, and keys the buffer with it.
+         * @param calc the attribute of the completed pass
+         * @param width the width of the iteration buffer
+         * @param height the height of the iteration buffer
+         * @param reference the reference of the pass
+         */
+        void commit(const FractalAttribute &calc, uint16_t width, uint16_t height, const MandelbrotReference *reference);
+
+        /**
+         * The pixels can be continued only if nothing but the max iteration is raised.<br/>
+         * The reference which is cut by the previous max iteration is not enough for the longer orbit,
+         * so it is rejected, too.
+         * @return true when the pass of the given attribute can continue the stored pixels.
+         */
+        [[nodiscard]] bool canContinue(const FractalAttribute &calc, uint16_t width, uint16_t height,
+                                       const MandelbrotReference *reference) const;
+
+        /**
+         * The pixels can be moved only if the center is moved by the whole pixels of the same zoom, and nothing else is changed.
+         * @param pixelSize the distance between the adjacent pixels
+         * @return the offset of the previous pixel of each pixel, or @code std::nullopt@endcode if the pixels cannot be moved.
+         */
+        [[nodiscard]] std::optional<std::array<int32_t, 2> > getShift(const FractalAttribute &calc, uint16_t width,
+                                                                      uint16_t height,
+                                                                      const MandelbrotReference *reference,
+                                                                      const dex &pixelSize) const;
+
+        /**
+         * Moves the slots in the same way as the iteration matrix. The exposed pixels are unknown.
+         * @param width the width of the iteration buffer
+         * @param height the height of the iteration buffer
+         * @param shift the offset of the previous pixel of each pixel
+         */
+        void shift(uint16_t width, uint16_t height, const std::array<int32_t, 2> &shift);
+
+        /**
+         * @return the slot of the pixel, or the marker
+         */
+        [[nodiscard]] uint32_t getSlot(uint32_t pixel) const;
+
+        /**
+         * @return the stored state of the slot
+         */
+        [[nodiscard]] const MandelbrotContinuation &get(uint32_t slot) const;
+
+        /**
+         * Stores where the pixel stopped. It is safe to call from the render threads, for the different pixels.
+         * @param pixel the index of the pixel
+         * @param continuation the state which is returned by the perturbator
+         */
+        void store(uint32_t pixel, const MandelbrotContinuation &continuation);
+
+        /**
+         * Marks the pixel unknown, when its iteration is filled without the perturbator.
+         * @param pixel the index of the pixel
+         */
+        void forget(uint32_t pixel);
+
+    private:
+        static bool isSameSettings(const FractalAttribute &a, const FractalAttribute &b);
+    };
+
+    // DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER
+    // DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER
+    // DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER
+    // DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER
+    // DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER  DEFINITION OF CONTINUATION BUFFER
+
+
+    inline void ContinuationBuffer::reset(const uint32_t length) {
+        key = std::nullopt;
+        slots.assign(length, UNKNOWN);
+        states.clear();
+        pending.clear();
+    }
+
+    inline void ContinuationBuffer::invalidate() {
+        key = std::nullopt;
+    }
+
+    inline void ContinuationBuffer::commit(const FractalAttribute &calc, const uint16_t width, const uint16_t height,
+                                           const MandelbrotReference *reference) {
+        // Only the states which are still in the slots are kept, in the order of the pixels.
+        auto live = std::vector<MandelbrotContinuation>();
+        live.reserve(pending.size() + std::ranges::count_if(slots, [this](const uint32_t slot) {
+            return slot < states.size();
+        }));
+        for (uint32_t &slot: slots) {
+            if (slot < states.size()) {
+                live.push_back(states[slot]);
+                slot = static_cast<uint32_t>(live.size() - 1);
+            }
+        }
+        for (const auto &[pixel, continuation]: pending) {
+            slots[pixel] = static_cast<uint32_t>(live.size());
+            live.push_back(continuation);
+        }
+        states = std::move(live);
+        pending.clear();
+        key = Key{
+            .calc = calc, .width = width, .height = height,
+            .referenceGeneration = reference == nullptr ? 0 : reference->generation
+        };
+    }
+
+    inline bool ContinuationBuffer::canContinue(const FractalAttribute &calc, const uint16_t width,
+                                                const uint16_t height, const MandelbrotReference *reference) const {
+        if (!key.has_value() || calc.absoluteIterationMode || key->calc.absoluteIterationMode) {
+            return false;
+        }
+        const uint64_t previousMaxIteration = key->calc.maxIteration;
+        return reference != nullptr && key->referenceGeneration == reference->generation &&
+               key->width == width && key->height == height &&
+               calc.maxIteration > previousMaxIteration &&
+               reference->longestPeriod() + 1 < previousMaxIteration &&
+               isSameSettings(calc, key->calc) && calc.center.to_string() == key->calc.center.to_string();
+    }
+
+    inline std::optional<std::array<int32_t, 2> > ContinuationBuffer::getShift(
+        const FractalAttribute &calc, const uint16_t width, const uint16_t height,
+        const MandelbrotReference *reference, const dex &pixelSize) const {
+        using namespace Constants::Fractal;
+        if (!key.has_value() || reference == nullptr || key->referenceGeneration != reference->generation ||
+            key->width != width || key->height != height || calc.maxIteration != key->calc.maxIteration ||
+            calc.absoluteIterationMode != key->calc.absoluteIterationMode || !isSameSettings(calc, key->calc)) {
+            return std::nullopt;
+        }
+
+        const int exp10 = Perturbator::logZoomToExp10(calc.logZoom);
+        fp_complex_calculator centerOffset = calc.center.edit(exp10);
+        centerOffset -= key->calc.center.edit(exp10);
+        dex offR = dex::ZERO;
+        dex offI = dex::ZERO;
+        centerOffset.getReal().double_exp_value(&offR);
+        centerOffset.getImag().double_exp_value(&offI);
+
+        const auto sx = static_cast<double>(offR / pixelSize);
+        const auto sy = static_cast<double>(offI / pixelSize);
+        const double rx = std::round(sx);
+        const double ry = std::round(sy);
+        if (std::abs(sx - rx) > SHIFT_PIXEL_TOLERANCE || std::abs(sy - ry) > SHIFT_PIXEL_TOLERANCE ||
+            std::abs(rx) >= width || std::abs(ry) >= height || (rx == 0 && ry == 0)) {
+            return std::nullopt;
+        }
+        return std::array{static_cast<int32_t>(rx), static_cast<int32_t>(ry)};
+    }
+
+    inline void ContinuationBuffer::shift(const uint16_t width, const uint16_t height,
+                                          const std::array<int32_t, 2> &shift) {
+        const auto [sx, sy] = shift;
+        auto shifted = std::vector<uint32_t>(slots.size(), UNKNOWN);
+        for (int32_t y = std::max(0, -sy); y < std::min<int32_t>(height, height - sy); ++y) {
+            for (int32_t x = std::max(0, -sx); x < std::min<int32_t>(width, width - sx); ++x) {
+                shifted[y * width + x] = slots[(y + sy) * width + x + sx];
+            }
+        }
+        slots = std::move(shifted);
+    }
+
+    inline uint32_t ContinuationBuffer::getSlot(const uint32_t pixel) const {
+        return slots[pixel];
+    }
+
+    inline const MandelbrotContinuation &ContinuationBuffer::get(const uint32_t slot) const {
+        return states[slot];
+    }
+
+    inline void ContinuationBuffer::store(const uint32_t pixel, const MandelbrotContinuation &continuation) {
+        if (!continuation.isContinuable()) {
+            slots[pixel] = continuation.iteration == MandelbrotContinuation::ESCAPED ? ESCAPED : INTERIOR;
+            return;
+        }
+        if (const uint32_t slot = slots[pixel]; slot < states.size()) {
+            states[slot] = continuation;
+            return;
+        }
+        std::scoped_lock lock(pendingMutex);
+        pending.emplace_back(pixel, continuation);
+    }
+
+    inline void ContinuationBuffer::forget(const uint32_t pixel) {
+        slots[pixel] = UNKNOWN;
+    }
+
+    inline bool ContinuationBuffer::isSameSettings(const FractalAttribute &a, const FractalAttribute &b) {
+        const auto mpa = [](const FrtMPAAttribute &m) {
+            return std::tie(m.minSkipReference, m.maxMultiplierBetweenLevel, m.epsilonPower, m.mpaSelectionMethod,
+                            m.mpaCompressionMethod, m.seriesApproximationTerms);
+        };
+        const auto compression = [](const FrtReferenceCompAttribute &c) {
+            return std::tie(c.compressCriteria, c.compressionThresholdPower, c.noCompressorNormalization);
+        };
+        return a.logZoom == b.logZoom && a.bailout == b.bailout &&
+               a.decimalizeIterationMethod == b.decimalizeIterationMethod &&
+               a.interiorDetectionMethod == b.interiorDetectionMethod &&
+               mpa(a.mpaAttribute) == mpa(b.mpaAttribute) &&
+               compression(a.referenceCompAttribute) == compression(b.referenceCompAttribute);
+    }
+}
@@ -4,6 +4,8 @@
 
 #pragma once
 #include <algorithm>
+#include <cstring>
+#include <span>
 #include <vector>
 #include <array>
 
@@ -58,6 +60,42 @@ namespace merutilm::rff2 {
             vkh::BufferContext::fill(context, vector);
         }
 
+        /**
+         * Checks that the matrix of the size is copied to this buffer, on the calling thread before its rows are dispatched.
+         * fillRows() and fillRow() are called from the threads of the pool, where the exception cannot be thrown, so they do not check.
+         * @param matrixWidth the width of the matrix to copy
+         * @param matrixHeight the height of the matrix to copy
+         */
+        void checkSize(const uint32_t matrixWidth, const uint32_t matrixHeight) const {
+            if (matrixWidth != width || matrixHeight != height) {
+                throw vkh::exception_invalid_args(std::format("Size mismatch : {}x{}, and {}x{}", matrixWidth,
+                                                              matrixHeight, width, height));
+            }
+        }
+
+        /**
+         * Copies the rows of the vector of the same size to the mapped memory at once.
+         * The disjoint rows can be copied from the different threads. The size is checked by checkSize() beforehand.
+         * @param vector the values of all pixels
+         * @param fromY the first row to copy
+         * @param toY the row after the last one to copy, not greater than the height
+         */
+        void fillRows(const std::vector<T> &vector, const uint32_t fromY, const uint32_t toY) const noexcept {
+            const size_t offset = static_cast<size_t>(width) * fromY;
+            memcpy(context.mappedMemory + offset * sizeof(T), vector.data() + offset,
+                   static_cast<size_t>(width) * (toY - fromY) * sizeof(T));
+        }
+
+        /**
+         * Copies a row to the mapped memory at once. The different rows can be copied from the different threads.
+         * The size is checked by checkSize() beforehand.
+         * @param y the row to copy, less than the height
+         * @param row the values of the row, the same length as the width
+         */
+        void fillRow(const uint32_t y, const std::span<const T> row) const noexcept {
+            memcpy(context.mappedMemory + static_cast<size_t>(width) * y * sizeof(T), row.data(), width * sizeof(T));
+        }
+
         void fillZero() const {
             vkh::BufferContext::fillZero(context);
         }
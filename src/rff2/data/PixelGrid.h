@@ -0,0 +1,92 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "../calc/dex.h"
+#include "../calc/dex_exp.h"
+#include "../constants/FractalConstants.hpp"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Pixel Grid</b>
+     * <br/>
+     * The offsets from the center of the pixels of the iteration buffer, which are computed once per pass.
+     * The offset of a pixel only depends on its column and its row, so the columns and the rows are kept separately,
+     * and the pixel needs no exp10 and division of the dex.
+     * <li> The pixel on the center line is moved by the intentional error offset, the same as the offset of the mouse.</li>
+     */
+    class PixelGrid final {
+        std::vector<dex> columns;
+        std::vector<dex> rows;
+
+    public:
+        /**
+         * @param width the width of the iteration buffer
+         * @param height the height of the iteration buffer
+         * @param logZoom the zoom of the pass
+         * @param clarityMultiplier the pixels of the iteration buffer per the pixel of the window
+         */
+        PixelGrid(uint16_t width, uint16_t height, double logZoom, float clarityMultiplier);
+
+        /**
+         * Converts the coordinate of a pixel to its offset from the center.
+         * @param length the width or the height of the iteration buffer
+         * @param pixel the column or the row of the pixel
+         * @param divisor the pixels of the iteration buffer per the unit
+         * @param clarityMultiplier the pixels of the iteration buffer per the pixel of the window
+         */
+        static dex offset(uint16_t length, int pixel, const dex &divisor, float clarityMultiplier);
+
+        [[nodiscard]] const dex &getReal(uint16_t x) const;
+
+        [[nodiscard]] const dex &getImag(uint16_t y) const;
+
+        [[nodiscard]] std::array<dex, 2> operator()(uint16_t x, uint16_t y) const;
+    };
+
+    // DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID
+    // DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID
+    // DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID
+    // DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID
+    // DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID  DEFINITION OF PIXEL GRID
+
+
+    inline PixelGrid::PixelGrid(const uint16_t width, const uint16_t height, const double logZoom,
+                                const float clarityMultiplier) {
+        const dex divisor = dex_exp::exp10(logZoom);
+        columns.reserve(width);
+        rows.reserve(height);
+        for (uint16_t x = 0; x < width; ++x) {
+            columns.push_back(offset(width, x, divisor, clarityMultiplier));
+        }
+        for (uint16_t y = 0; y < height; ++y) {
+            rows.push_back(offset(height, y, divisor, clarityMultiplier));
+        }
+    }
+
+    inline dex PixelGrid::offset(const uint16_t length, const int pixel, const dex &divisor,
+                                 const float clarityMultiplier) {
+        using namespace Constants::Fractal;
+        const double o = static_cast<double>(pixel) - static_cast<double>(length) / 2.0;
+        return dex::value(std::abs(o) < INTENTIONAL_ERROR_OFFSET_MIN_PIX ? INTENTIONAL_ERROR_OFFSET_MIN_PIX : o) /
+               divisor / clarityMultiplier;
+    }
+
+    inline const dex &PixelGrid::getReal(const uint16_t x) const {
+        return columns[x];
+    }
+
+    inline const dex &PixelGrid::getImag(const uint16_t y) const {
+        return rows[y];
+    }
+
+    inline std::array<dex, 2> PixelGrid::operator()(const uint16_t x, const uint16_t y) const {
+        return {columns[x], rows[y]};
+    }
+}
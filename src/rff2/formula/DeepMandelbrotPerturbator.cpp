@@ -3,6 +3,7 @@
 //
 
 #include "DeepMandelbrotPerturbator.h"
+#include "ScaledMandelbrotPerturbator.h"
 
 namespace merutilm::rff2 {
 
@@ -39,21 +40,43 @@ namespace merutilm::rff2 {
         } else {
             table = std::move(reusedTable);
         }
+        kernel = MandelbrotKernelTable<DeepMandelbrotPerturbator>::select(calc, table->mpaPeriod != nullptr);
     }
 
 
     double DeepMandelbrotPerturbator::iterate(const dex &dcr, const dex &dci) const {
+        auto continuation = MandelbrotContinuation();
+        return iterate(dcr, dci, continuation);
+    }
+
+    double DeepMandelbrotPerturbator::iterate(const dex &dcr, const dex &dci,
+                                              MandelbrotContinuation &continuation) const {
+        return (this->*kernel)(dcr, dci, continuation);
+    }
+
+    void DeepMandelbrotPerturbator::useRuntimeKernel() {
+        kernel = &DeepMandelbrotPerturbator::iterateKernel<false, false, FrtMPASelectionMethod::LOWEST,
+            FrtMPACompressionMethod::NO_COMPRESSION, true>;
+    }
+
+    template<bool INTERIOR, bool MPA, FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION, bool RUNTIME>
+    double DeepMandelbrotPerturbator::iterateKernel(const dex &dcr, const dex &dci,
+                                                    MandelbrotContinuation &continuation) const {
         if (state.interruptRequested()) return 0.0;
 
         const dex dcr1 = dcr + offR;
         const dex dci1 = dci + offI;
 
-        uint64_t iteration = 0;
-        uint64_t refIteration = 0;
+        if (series != nullptr && continuation.iteration == 0) {
+            continuation = series->evaluate(dcr1, dci1);
+        }
+
+        uint64_t iteration = continuation.iteration;
+        uint64_t refIteration = continuation.refIteration;
         int absIteration = 0;
         const uint64_t maxRefIteration = reference->longestPeriod();
-        dex dzr = dex::ZERO;
-        dex dzi = dex::ZERO;
+        dex dzr = continuation.dzr;
+        dex dzi = continuation.dzi;
         dex zr = dex::ZERO;
         dex zi = dex::ZERO;
 
@@ -61,41 +84,98 @@ namespace merutilm::rff2 {
         const dex zrMin = dex::value(-2);
         const dex zrMax = dex::value(0.25);
 
-        double cd = 0;
-        double pd = cd;
+        double cd = continuation.cd;
+        double pd = continuation.pd;
         const bool isAbs = calc.absoluteIterationMode;
         const uint64_t maxIteration = calc.maxIteration;
         const float bailout = calc.bailout;
         const float bailout2 = bailout * bailout;
         auto temps = std::array<dex, 4>();
-
-
-        while (iteration < maxIteration) {
-            if (table != nullptr) {
-                if (const DeepPA *mpaPtr = table->lookup(refIteration, dzr, dzi, temps); mpaPtr != nullptr) {
-                    const DeepPA &mpa = *mpaPtr;
-
-                    dex::mul(&temps[0], mpa.anr, dzr);
-                    dex::mul(&temps[1], mpa.ani, dzi);
+        auto cursor = CompressedReferenceCursor(reference->compressor, reference->compressorOffsets);
+
+        // The runtime kernel reads the settings here, and tests them in the loop.
+        const bool interior = RUNTIME
+                                  ? !isAbs && calc.interiorDetectionMethod != FrtInteriorDetectionMethod::NONE
+                                  : INTERIOR;
+        // Interior detection : dz/dz1 is multiplied by 2z every iteration, and by A of the PA when skipped.
+        const bool periodicityDetection = interior &&
+                                          calc.interiorDetectionMethod == FrtInteriorDetectionMethod::DERIVATIVE_AND_PERIODICITY;
+        const dex derThreshold = dex::value(Constants::Fractal::INTERIOR_DERIVATIVE_THRESHOLD);
+        const dex periodicityEpsilon = dex::value(Constants::Fractal::INTERIOR_PERIODICITY_EPSILON);
+        dex derR = continuation.derR;
+        dex derI = continuation.derI;
+        auto derTemps = std::array<dex, 4>();
+        // Brent's method : z is saved at the rebases of the powers of two, and compared at every rebase.
+        dex savedZr = dex::ZERO;
+        dex savedZi = dex::ZERO;
+        uint64_t rebases = 0;
+        uint64_t nextSave = 1;
+
+        // derivative = (fr + fi i) * derivative
+        const auto multiplyDerivative = [&derR, &derI, &derTemps](const dex &fr, const dex &fi) {
+            dex::mul(&derTemps[0], fr, derR);
+            dex::mul(&derTemps[1], fi, derI);
+            dex::mul(&derTemps[2], fr, derI);
+            dex::mul(&derTemps[3], fi, derR);
+            dex::sub(&derR, derTemps[0], derTemps[1]);
+            dex::add(&derI, derTemps[2], derTemps[3]);
+        };
+
+        const auto isInterior = [&derR, &derI, &derThreshold, interior] {
+            return interior && derR * derR + derI * derI < derThreshold;
+        };
+
+        const auto suspend = [&] {
+            continuation = MandelbrotContinuation{
+                .dzr = dzr, .dzi = dzi, .derR = derR, .derI = derI, .iteration = iteration,
+                .refIteration = refIteration, .cd = cd, .pd = pd
+            };
+        };
+
+
+        // The pixel which escaped at the previous max iteration is not iterated again.
+        while (iteration < maxIteration && cd <= bailout2) {
+            if constexpr (MPA || RUNTIME) {
+                if (const DeepPA::Entry *mpaPtr = RUNTIME
+                                                      ? table->lookup(refIteration, dzr, dzi, temps)
+                                                      : table->lookup<SELECTION, COMPRESSION>(refIteration, dzr, dzi, temps);
+                    mpaPtr != nullptr) {
+                    const DeepPA::Entry &mpa = *mpaPtr;
+                    const dex anr = mpa.anr();
+                    const dex ani = mpa.ani();
+                    const dex bnr = mpa.bnr();
+                    const dex bni = mpa.bni();
+
+                    dex::mul(&temps[0], anr, dzr);
+                    dex::mul(&temps[1], ani, dzi);
                     dex::sub(&temps[0], temps[0], temps[1]);
-                    dex::mul(&temps[1], mpa.bnr, dcr1);
+                    dex::mul(&temps[1], bnr, dcr1);
                     dex::add(&temps[0], temps[0], temps[1]);
-                    dex::mul(&temps[1], mpa.bni, dci1);
+                    dex::mul(&temps[1], bni, dci1);
                     dex::sub(&temps[0], temps[0], temps[1]);
-                    dex::mul(&temps[1], mpa.anr, dzi);
-                    dex::mul(&temps[2], mpa.ani, dzr);
+                    dex::mul(&temps[1], anr, dzi);
+                    dex::mul(&temps[2], ani, dzr);
                     dex::add(&temps[1], temps[1], temps[2]);
-                    dex::mul(&temps[2], mpa.bnr, dci1);
+                    dex::mul(&temps[2], bnr, dci1);
                     dex::add(&temps[1], temps[1], temps[2]);
-                    dex::mul(&temps[2], mpa.bni, dcr1);
+                    dex::mul(&temps[2], bni, dcr1);
                     dex::cpy(&dzr, temps[0]);
                     dex::add(&dzi, temps[1], temps[2]);
 
+                    if (interior) {
+                        multiplyDerivative(anr, ani);
+                    }
+
                     iteration += mpa.skip;
                     refIteration += mpa.skip;
                     ++absIteration;
 
+                    if (isInterior()) {
+                        continuation.iteration = MandelbrotContinuation::INTERIOR;
+                        return static_cast<double>(maxIteration);
+                    }
                     if (iteration >= maxIteration) {
+                        suspend();
                         return static_cast<double>(isAbs ? absIteration : maxIteration);
                     }
                     continue;
@@ -104,13 +184,25 @@ namespace merutilm::rff2 {
 
 
             if (refIteration != maxRefIteration) {
-                if (const uint64_t index = ArrayCompressor::compress(reference->compressor, refIteration);
+                // dz/dz1 = 2z * dz/dz1, from z1 because z0 is zero
+                if (interior && iteration > 0) {
+                    const uint64_t index = cursor.seek(refIteration);
+                    dex::add(&temps[0], reference->orbit.real(index), dzr);
+                    dex::add(&temps[1], reference->orbit.imag(index), dzi);
+                    dex::mul_2exp(&temps[0], temps[0], 1);
+                    dex::mul_2exp(&temps[1], temps[1], 1);
+                    multiplyDerivative(temps[0], temps[1]);
+                    derR.try_normalize();
+                    derI.try_normalize();
+                }
+
+                if (const uint64_t index = cursor.seek(refIteration);
                     index == 0) {
                     dex::cpy(&temps[0], dzr);
                     dex::cpy(&temps[1], dzi);
                     } else {
-                        dex::cpy(&temps[0], reference->refReal[index]);
-                        dex::cpy(&temps[1], reference->refImag[index]);
+                        dex::cpy(&temps[0], reference->orbit.real(index));
+                        dex::cpy(&temps[1], reference->orbit.imag(index));
                         dex::mul_2exp(&temps[0], temps[0], 1);
                         dex::mul_2exp(&temps[1], temps[1], 1);
                         dex::add(&temps[0], temps[0], dzr);
@@ -138,9 +230,9 @@ namespace merutilm::rff2 {
                 ++absIteration;
             }
 
-            const uint64_t index = ArrayCompressor::compress(reference->compressor, refIteration);
-            dex::add(&zr, reference->refReal[index], dzr);
-            dex::add(&zi, reference->refImag[index], dzi);
+            const uint64_t index = cursor.seek(refIteration);
+            dex::add(&zr, reference->orbit.real(index), dzr);
+            dex::add(&zi, reference->orbit.imag(index), dzi);
 
 
             dex::sub(&temps[0], zr, zrMin);
@@ -149,6 +241,7 @@ namespace merutilm::rff2 {
             if (zi.sgn() == 0 && temps[0].sgn() != -1 && temps[1].sgn() != -1) {
                 //IT IS NOT SATISFIED MPA SKIP RADIUS CONDITION.
                 //WHEN THE MAX ITERATION IS HIGH, REPEATS SEMI-INFINITELY.
+                continuation.iteration = MandelbrotContinuation::INTERIOR;
                 return static_cast<double>(maxIteration);
             }
 
@@ -161,6 +254,19 @@ namespace merutilm::rff2 {
             cd = zr0 * zr0 + zi0 * zi0;
 
             if (refIteration == maxRefIteration || cd < dzr0 * dzr0 + dzi0 * dzi0) {
+                if (periodicityDetection) {
+                    if ((zr - savedZr) * (zr - savedZr) + (zi - savedZi) * (zi - savedZi) <
+                        periodicityEpsilon * (zr * zr + zi * zi)) {
+                        continuation.iteration = MandelbrotContinuation::INTERIOR;
+                        return static_cast<double>(maxIteration);
+                    }
+                    if (++rebases == nextSave) {
+                        dex::cpy(&savedZr, zr);
+                        dex::cpy(&savedZi, zi);
+                        nextSave <<= 1;
+                    }
+                }
+
                 refIteration = 0;
                 dex::cpy(&dzr, zr);
                 dex::cpy(&dzi, zi);
@@ -169,15 +275,22 @@ namespace merutilm::rff2 {
             dzr.try_normalize();
             dzi.try_normalize();
             if (cd > bailout2) break;
+            if (isInterior()) {
+                continuation.iteration = MandelbrotContinuation::INTERIOR;
+                return static_cast<double>(maxIteration);
+            }
             if (absIteration % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 && state.interruptRequested()) return 0.0;
         }
 
-        if (isAbs) {
-            return absIteration;
+        if (iteration >= maxIteration) {
+            suspend();
+            return static_cast<double>(isAbs ? absIteration : maxIteration);
         }
 
-        if (iteration >= maxIteration) {
-            return static_cast<double>(maxIteration);
+        continuation.iteration = MandelbrotContinuation::ESCAPED;
+
+        if (isAbs) {
+            return absIteration;
         }
 
         const double fpd = sqrt(pd);
@@ -187,6 +300,10 @@ namespace merutilm::rff2 {
     }
 
 
+    void DeepMandelbrotPerturbator::approximateSeries(const std::span<const std::array<dex, 2> > probes) {
+        series = SeriesApproximation::create(state, *reference, calc, probes, offR, offI);
+    }
+
     std::unique_ptr<DeepMandelbrotPerturbator> DeepMandelbrotPerturbator::reuse(
         const FractalAttribute &calc, const dex &dcMax, ApproxTableCache &tableRef) {
         dex offR = dex::ZERO;
@@ -219,4 +336,16 @@ namespace merutilm::rff2 {
                                                            }, false, std::move(reusedReference),
                                                            std::move(table), offR, offI);
     }
+
+    std::unique_ptr<ScaledMandelbrotPerturbator> DeepMandelbrotPerturbator::toScaled(ApproxTableCache &tableRef) {
+        const uint64_t longestPeriod = reference->longestPeriod();
+        return std::make_unique<ScaledMandelbrotPerturbator>(state, calc, dcMax, logZoomToExp10(calc.logZoom), longestPeriod,
+                                                             tableRef,
+                                                             [](uint64_t) {
+                                                                 //no action because the reference is already declared
+                                                             }, [](uint64_t, double) {
+                                                                 //same reason
+                                                             }, false, std::move(reference),
+                                                             std::move(table), offR, offI);
+    }
 }
@@ -4,13 +4,17 @@
 
 #pragma once
 #include "DeepMandelbrotReference.h"
+#include "MandelbrotKernelTable.h"
 #include "MandelbrotPerturbator.h"
 #include "../mrthy/DeepMPATable.h"
 
 namespace merutilm::rff2 {
+    class ScaledMandelbrotPerturbator;
+
     class DeepMandelbrotPerturbator final : public MandelbrotPerturbator {
         std::unique_ptr<DeepMandelbrotReference> reference = nullptr;
         std::unique_ptr<DeepMPATable> table = nullptr;
+        MandelbrotKernelTable<DeepMandelbrotPerturbator>::Kernel kernel = nullptr;
 
         const dex dcMax;
         const dex offR;
@@ -31,14 +35,41 @@ namespace merutilm::rff2 {
 
         [[nodiscard]] double iterate(const dex &dcr, const dex &dci) const override;
 
+        [[nodiscard]] double iterate(const dex &dcr, const dex &dci, MandelbrotContinuation &continuation) const override;
+
+        /**
+         * Replaces the specialized kernel with the RUNTIME kernel, which dispatches the settings in the loop. <br/>
+         * It is the baseline of the kernel benchmark, and is never used for rendering.
+         */
+        void useRuntimeKernel();
+
         std::unique_ptr<DeepMandelbrotPerturbator> reuse(const FractalAttribute &calc, const dex &dcMax,
                                                          ApproxTableCache &tableRef);
 
+        /**
+         * Moves the reference and the table into the scaled perturbator, without creating them again.
+         * @see ScaledMandelbrotPerturbator::isFasterThanDeep
+         */
+        std::unique_ptr<ScaledMandelbrotPerturbator> toScaled(ApproxTableCache &tableRef);
+
         [[nodiscard]] const DeepMandelbrotReference *getReference() const override;
 
         [[nodiscard]] DeepMPATable &getTable() const;
 
         [[nodiscard]] dex getDcMaxAsDoubleExp() const override;
+
+        void approximateSeries(std::span<const std::array<dex, 2> > probes) override;
+
+    private:
+        friend class MandelbrotKernelTable<DeepMandelbrotPerturbator>;
+
+        /**
+         * The iteration of a pixel, which is specialized for the settings of the frame.
+         * The RUNTIME kernel ignores the other parameters, and tests the settings in the loop instead.
+         * @see MandelbrotKernelTable
+         */
+        template<bool INTERIOR, bool MPA, FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION, bool RUNTIME = false>
+        double iterateKernel(const dex &dcr, const dex &dci, MandelbrotContinuation &continuation) const;
     };
 
     // DEFINITION OF DEEP MANDELBROT PERTURBATOR  DEFINITION OF DEEP MANDELBROT PERTURBATOR  DEFINITION OF DEEP MANDELBROT PERTURBATOR  DEFINITION OF DEEP MANDELBROT PERTURBATOR
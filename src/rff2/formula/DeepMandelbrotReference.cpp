@@ -4,23 +4,25 @@
 
 #include "DeepMandelbrotReference.h"
 
+#include "ParallelReferenceStepper.h"
+#include "../calc/fp_fixed_complex.h"
 #include "../calc/double_exp_math.h"
 #include "../calc/rff_math.h"
+#include "../io/RFFReferenceCheckpoint.h"
 #include "../mrthy/ArrayCompressor.h"
 #include "../constants/Constants.hpp"
 
 
 namespace merutilm::rff2 {
-    DeepMandelbrotReference::DeepMandelbrotReference(fp_complex &&center, std::vector<dex> &&refReal,
-                                                     std::vector<dex> &&refImag,
+    DeepMandelbrotReference::DeepMandelbrotReference(fp_complex &&center, DeepReferenceOrbitStore::Part &&refReal,
+                                                     DeepReferenceOrbitStore::Part &&refImag,
                                                      std::vector<ArrayCompressionTool> &&compressor,
                                                      std::vector<uint64_t> &&period, fp_complex &&fpgReference,
                                                      fp_complex &&fpgBn) : MandelbrotReference(std::move(center),
                                                                                std::move(compressor), std::move(period),
                                                                                std::move(fpgReference),
                                                                                std::move(fpgBn)),
-                                                                           refReal(std::move(refReal)),
-                                                                           refImag(std::move(refImag)) {
+                                                                           orbit(std::move(refReal), std::move(refImag)) {
     }
 
 
@@ -43,16 +45,16 @@ namespace merutilm::rff2 {
             return Constants::NullPointer::PROCESS_TERMINATED_REFERENCE;
         }
 
-        auto rr = std::vector<dex>();
-        auto ri = std::vector<dex>();
+        auto rr = DeepReferenceOrbitStore::Part(SegmentStorage(calc.referenceStorageMethod, calc.scratchDirectory));
+        auto ri = DeepReferenceOrbitStore::Part(SegmentStorage(calc.referenceStorageMethod, calc.scratchDirectory));
         rr.push_back(dex::ZERO);
         ri.push_back(dex::ZERO);
 
         fp_complex center = calc.center;
-        auto c = center.edit(exp10);
-        auto z = fp_complex_calculator(0, 0, exp10);
+        const mp_size_t fixedSize = fp_fixed::exp10ToSize(exp10);
+        const auto c = fp_fixed_complex(center.edit(exp10), fixedSize);
+        auto z = fp_fixed_complex(fixedSize);
         auto fpgBn = fp_complex_calculator(0, 0, exp10);
-        auto one = fp_complex_calculator(1.0, 0.0, exp10);
         double bailoutSqr = calc.bailout * calc.bailout;
 
         dex fpgBnr = dex::ONE;
@@ -65,6 +67,7 @@ namespace merutilm::rff2 {
         auto periodArray = std::vector<uint64_t>();
 
         dex minZRadius = dex::ONE;
+        dex fpgMargin = dex::PINF;
         uint64_t reuseIndex = 0;
 
         auto tools = std::vector<ArrayCompressionTool>();
@@ -77,11 +80,42 @@ namespace merutilm::rff2 {
         bool canReuse = withoutNormalize;
 
         std::unique_ptr<fp_complex> fpgReference = nullptr;
+        const auto stepper = ParallelReferenceStepper::create(exp10, calc.threadedReferenceMinBits, strictFPG);
         auto temps = std::array<dex, 8>();
+        const auto checkpoint = RFFReferenceCheckpoint<dex>::create(calc, exp10, strictFPG, c);
+
+        if (checkpoint != nullptr) {
+            if (auto resumed = checkpoint->resume(z, fpgBn, rr, ri, maxIteration, initialPeriod, dcMax)) {
+                iteration = resumed->iteration;
+                period = std::max<uint64_t>(iteration, 1);
+                reuseIndex = resumed->reuseIndex;
+                compressed = resumed->compressed;
+                canReuse = resumed->canReuse;
+                zr = resumed->zr;
+                zi = resumed->zi;
+                fpgBnr = resumed->fpgBnr;
+                fpgBni = resumed->fpgBni;
+                minZRadius = resumed->minZRadius;
+                fpgMargin = resumed->fpgMargin;
+                periodArray = std::move(resumed->periodArray);
+                tools = std::move(resumed->tools);
+            }
+        }
 
         while ((iteration == 0 || dex_trigonometric::hypot2(zr, zi) < bailoutSqr) && iteration < maxIteration) {
-            if (iteration % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 && state.interruptRequested()) {
-                return Constants::NullPointer::PROCESS_TERMINATED_REFERENCE;
+            if (iteration % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 || iteration == maxIteration - 1) {
+                const bool interrupted = state.interruptRequested();
+                if (checkpoint != nullptr && checkpoint->due(interrupted || iteration == maxIteration - 1)) {
+                    checkpoint->save({
+                                         .iteration = iteration, .reuseIndex = reuseIndex, .compressed = compressed,
+                                         .canReuse = canReuse, .zr = zr, .zi = zi, .fpgBnr = fpgBnr, .fpgBni = fpgBni,
+                                         .minZRadius = minZRadius, .fpgMargin = fpgMargin, .periodArray = periodArray,
+                                         .tools = tools
+                                     }, z, fpgBn, rr, ri);
+                }
+                if (interrupted) {
+                    return Constants::NullPointer::PROCESS_TERMINATED_REFERENCE;
+                }
             }
 
             // use Fast-Period-Guessing, and create MPA Table
@@ -117,12 +151,20 @@ namespace merutilm::rff2 {
                     break;
                 }
 
+                if (temps[4].sgn() != 0) {
+                    dex::div(&temps[6], temps[0], temps[4]);
+                    dex::sub(&temps[7], fpgMargin, temps[6]);
+                    if (fpgMargin.isinf() || temps[7].sgn() > 0) {
+                        dex::cpy(&fpgMargin, temps[6]);
+                    }
+                }
+
                 dex::sub(&temps[4], temps[4], temps[1]);
 
                 if ((fpgReference == nullptr && temps[4].sgn() == 1) || temps[0].sgn() == 0 || (
                         initialPeriod != 0 && initialPeriod == iteration)) {
                     periodArray.push_back(iteration);
-                    fpgReference = std::make_unique<fp_complex>(z);
+                    fpgReference = std::make_unique<fp_complex>(z.calculator_value(exp10));
                     break;
                 }
 
@@ -130,16 +172,9 @@ namespace merutilm::rff2 {
                 dex::cpy(&fpgBni, temps[3]);
             }
 
-            if (strictFPG) {
-                fpgBn *= z.doubled();
-                fpgBn += one;
-                z.halved();
-            }
-
             //Let's do arbitrary-precision operation!!
             func(iteration);
-            z.square();
-            z += c;
+            stepper->step(z, c, fpgBn);
             z.getReal().double_exp_value(&zr);
             z.getImag().double_exp_value(&zi);
 
@@ -210,17 +245,23 @@ namespace merutilm::rff2 {
                 } else {
                     rr[index] = zr;
                     ri[index] = zi;
+                    if (checkpoint != nullptr) {
+                        checkpoint->markDirty(index);
+                    }
                 }
             }
         }
 
+        // the checkpoint at the max iteration is kept, to continue when it is raised.
+        if (checkpoint != nullptr && iteration != maxIteration - 1) {
+            checkpoint->remove();
+        }
+
         if (!strictFPG) fpgBn = fp_complex_calculator(fpgBnr, fpgBni, exp10);
-        if (fpgReference == nullptr) fpgReference = std::make_unique<fp_complex>(z);
+        if (fpgReference == nullptr) fpgReference = std::make_unique<fp_complex>(z.calculator_value(exp10));
 
         rr.resize(period - compressed + 1);
         ri.resize(period - compressed + 1);
-        rr.shrink_to_fit();
-        ri.shrink_to_fit();
         periodArray = periodArray.empty() ? std::vector(1, period) : periodArray;
 
         return std::make_unique<DeepMandelbrotReference>(std::move(center), std::move(rr), std::move(ri),
@@ -230,16 +271,16 @@ namespace merutilm::rff2 {
 
 
     dex DeepMandelbrotReference::real(const uint64_t refIteration) const {
-        return refReal[ArrayCompressor::compress(compressor, refIteration)];
+        return orbit.real(ArrayCompressor::compress(compressor, refIteration));
     }
 
     dex DeepMandelbrotReference::imag(const uint64_t refIteration) const {
-        return refImag[ArrayCompressor::compress(compressor, refIteration)];
+        return orbit.imag(ArrayCompressor::compress(compressor, refIteration));
     }
 
 
     size_t DeepMandelbrotReference::length() const {
-        return refReal.size();
+        return orbit.size();
     }
 
 
@@ -7,6 +7,7 @@
 
 #include "MandelbrotReference.h"
 #include "../calc/fp_complex.h"
+#include "../mrthy/DeepReferenceOrbitStore.h"
 #include "../parallel/ParallelRenderState.h"
 #include "../attr/FractalAttribute.h"
 
@@ -14,12 +15,11 @@ struct ArrayCompressionTool;
 
 namespace merutilm::rff2 {
     struct DeepMandelbrotReference final : public MandelbrotReference{
-        const std::vector<dex> refReal;
-        const std::vector<dex> refImag;
+        const DeepReferenceOrbitStore orbit;
 
 
-        DeepMandelbrotReference(fp_complex &&center, std::vector<dex> &&refReal,
-                                 std::vector<dex> &&refImag, std::vector<ArrayCompressionTool> &&compressor,
+        DeepMandelbrotReference(fp_complex &&center, DeepReferenceOrbitStore::Part &&refReal,
+                                 DeepReferenceOrbitStore::Part &&refImag, std::vector<ArrayCompressionTool> &&compressor,
                                  std::vector<uint64_t> &&period, fp_complex &&fpgReference, fp_complex &&fpgBn);
 
         static std::unique_ptr<DeepMandelbrotReference> createReference(const ParallelRenderState &state,
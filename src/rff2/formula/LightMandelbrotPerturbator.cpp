@@ -5,7 +5,9 @@
 
 #include "LightMandelbrotPerturbator.h"
 
+#include <algorithm>
 #include <cmath>
+#include <utility>
 #include "Perturbator.h"
 
 namespace merutilm::rff2 {
@@ -42,27 +44,49 @@ namespace merutilm::rff2 {
         } else {
             table = std::move(reusedTable);
         }
+        kernel = MandelbrotKernelTable<LightMandelbrotPerturbator>::select(calc, table->mpaPeriod != nullptr);
+    }
+
+    void LightMandelbrotPerturbator::useRuntimeKernel() {
+        kernel = &LightMandelbrotPerturbator::iterateKernel<false, false, FrtMPASelectionMethod::LOWEST,
+            FrtMPACompressionMethod::NO_COMPRESSION, true>;
     }
 
     double LightMandelbrotPerturbator::iterate(const dex &dcr, const dex &dci) const {
+        auto continuation = MandelbrotContinuation();
+        return iterate(dcr, dci, continuation);
+    }
+
+    double LightMandelbrotPerturbator::iterate(const dex &dcr, const dex &dci,
+                                               MandelbrotContinuation &continuation) const {
+        return (this->*kernel)(dcr, dci, continuation);
+    }
+
+    template<bool INTERIOR, bool MPA, FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION, bool RUNTIME>
+    double LightMandelbrotPerturbator::iterateKernel(const dex &dcr, const dex &dci,
+                                                     MandelbrotContinuation &continuation) const {
         if (state.interruptRequested()) return 0.0;
 
         // 定数をローカル変数へ
         const double dcr1 = static_cast<double>(dcr) + offR;
         const double dci1 = static_cast<double>(dci) + offI;
+        if (series != nullptr && continuation.iteration == 0) {
+            continuation = series->evaluate(dex::value(dcr1), dex::value(dci1));
+        }
 
-        uint64_t iteration = 0;
-        uint64_t refIteration = 0;
+
+        uint64_t iteration = continuation.iteration;
+        uint64_t refIteration = continuation.refIteration;
         int absIteration = 0;
         const uint64_t maxRefIteration = reference->longestPeriod();
 
-        double dzr = 0; // delta z
-        double dzi = 0;
+        auto dzr = static_cast<double>(continuation.dzr); // delta z
+        auto dzi = static_cast<double>(continuation.dzi);
         double zr = 0; // z
         double zi = 0;
 
-        double cd = 0;
-        double pd = 0;
+        double cd = continuation.cd;
+        double pd = continuation.pd;
         
         const bool isAbs = calc.absoluteIterationMode;
         const uint64_t maxIteration = calc.maxIteration;
@@ -70,6 +94,31 @@ namespace merutilm::rff2 {
         const float bailout2 = bailout * bailout;
         const int exitCheckInterval = Constants::Fractal::EXIT_CHECK_INTERVAL;
 
+        // Interior detection : dz/dz1 is multiplied by 2z every iteration, and by A of the PA when skipped.
+        // The zero threshold disables the periodicity check.
+        constexpr double derThreshold = Constants::Fractal::INTERIOR_DERIVATIVE_THRESHOLD;
+        // The runtime kernel reads the settings here, and tests them in the loop.
+        const bool interior = RUNTIME
+                                  ? !isAbs && calc.interiorDetectionMethod != FrtInteriorDetectionMethod::NONE
+                                  : INTERIOR;
+        const double periodicityEpsilon = calc.interiorDetectionMethod == FrtInteriorDetectionMethod::DERIVATIVE_AND_PERIODICITY
+                                              ? Constants::Fractal::INTERIOR_PERIODICITY_EPSILON
+                                              : 0;
+        auto derR = static_cast<double>(continuation.derR);
+        auto derI = static_cast<double>(continuation.derI);
+        // Brent's method : z is saved at the rebases of the powers of two, and compared at every rebase.
+        double savedZr = 0;
+        double savedZi = 0;
+        uint64_t rebases = 0;
+        uint64_t nextSave = 1;
+
+        const auto suspend = [&] {
+            continuation = MandelbrotContinuation{
+                .dzr = dex::value(dzr), .dzi = dex::value(dzi), .derR = dex::value(derR), .derI = dex::value(derI),
+                .iteration = iteration, .refIteration = refIteration, .cd = cd, .pd = pd
+            };
+        };
+
         // --- Optimization: Access raw pointers directly to avoid indirection overhead ---
         // std::vector等のデータへの直接ポインタを取得（実装依存ですが、通常operator[]より高速）
         // referenceクラスの実装が見えないため、安全にoperator[]を使う形を維持しつつ、
@@ -77,23 +126,33 @@ namespace merutilm::rff2 {
         const auto* refObj = reference.get();
         const auto* mpaTable = table.get();
         
+        // 圧縮インデックスはカーソルで逐次追跡する（1ステップあたり償却O(1)）
+        auto cursor = CompressedReferenceCursor(refObj->compressor, refObj->compressorOffsets);
+
         // 最初の参照軌道をロード
-        uint64_t index = ArrayCompressor::compress(refObj->compressor, refIteration);
-        // Note: refReal/refImagがpublicメンバ変数であると仮定（元のコードに基づく）
-        // 可能なら refReal.data() を取得したいが、std::vectorか不明なためそのまま使用
+        uint64_t index = cursor.seek(refIteration);
+        // 参照軌道は (re, im) の組で並んでいるため、1ステップで1か所だけを読む
         // ループ内での間接参照を減らすため、現在値をキャッシュ
-        double curRefR = refObj->refReal[index];
-        double curRefI = refObj->refImag[index];
+        const ReferenceOrbitStore &orbit = refObj->orbit;
+        double curRefR = orbit[index].real;
+        double curRefI = orbit[index].imag;
 
         // 中断チェック用カウンタ（剰余演算の除去）
         int checkCounter = exitCheckInterval;
 
-        while (iteration < maxIteration) {
+        // The pixel which escaped at the previous max iteration is not iterated again.
+        while (iteration < maxIteration && cd <= bailout2) {
             // MPA Optimization
-            // mpaTableがnullでない場合のみチェック。分岐予測によりコストは低い。
-            if (mpaTable) {
-                if (const LightPA *mpaPtr = mpaTable->lookup(refIteration, dzr, dzi); mpaPtr != nullptr) {
-                    const LightPA &mpa = *mpaPtr;
+            // テーブルの有無と方式はカーネルの選択時に決まっている。
+            if constexpr (MPA || RUNTIME) {
+                const LightPA::Entry *mpaPtr;
+                if constexpr (RUNTIME) {
+                    mpaPtr = mpaTable->lookup(refIteration, dzr, dzi);
+                } else {
+                    mpaPtr = mpaTable->lookup<SELECTION, COMPRESSION>(refIteration, dzr, dzi);
+                }
+                if (mpaPtr != nullptr) {
+                    const LightPA::Entry &mpa = *mpaPtr;
                     // MPAによるスキップ計算
                     const double dzr1 = mpa.anr * dzr - mpa.ani * dzi + mpa.bnr * dcr1 - mpa.bni * dci1;
                     const double dzi1 = mpa.anr * dzi + mpa.ani * dzr + mpa.bnr * dci1 + mpa.bni * dcr1;
@@ -101,19 +160,30 @@ namespace merutilm::rff2 {
                     dzr = dzr1;
                     dzi = dzi1;
 
+                    if (interior) {
+                        const double derR1 = mpa.anr * derR - mpa.ani * derI;
+                        derI = mpa.anr * derI + mpa.ani * derR;
+                        derR = derR1;
+                    }
+
                     const uint32_t skip = mpa.skip;
                     iteration += skip;
                     refIteration += skip; // ここでrefIterationが大きく進む可能性がある
                     absIteration++;       // 元コードではskip時もabsIterationは+1のみ
 
+                    if (interior && derR * derR + derI * derI < derThreshold) {
+                        continuation.iteration = MandelbrotContinuation::INTERIOR;
+                        return static_cast<double>(maxIteration);
+                    }
                     if (iteration >= maxIteration) {
+                        suspend();
                         return static_cast<double>(isAbs ? absIteration : maxIteration);
                     }
                     
                     // MPAスキップ後、参照軌道のキャッシュを更新する必要がある
-                    index = ArrayCompressor::compress(refObj->compressor, refIteration);
-                    curRefR = refObj->refReal[index];
-                    curRefI = refObj->refImag[index];
+                    index = cursor.seek(refIteration);
+                    curRefR = orbit[index].real;
+                    curRefI = orbit[index].imag;
                     
                     // ここで continue するとループ条件チェックへ戻る
                     continue;
@@ -129,6 +199,15 @@ namespace merutilm::rff2 {
                 // Optimization: 2.0倍は加算の方が速い場合がある (コンパイラ最適化に委ねても良いが明示)
                 // z = 2*Z*z + z^2 + c
                 // Real: 2(Zr*zr - Zi*zi) + (zr^2 - zi^2) + cr -> (2Zr + zr)*zr - (2Zi + zi)*zi + cr
+                // dz/dz1 = 2z * dz/dz1, from z1 because z0 is zero
+                if (interior && iteration > 0) {
+                    const double zr0 = curRefR + dzr;
+                    const double zi0 = curRefI + dzi;
+                    const double derR1 = 2 * (zr0 * derR - zi0 * derI);
+                    derI = 2 * (zr0 * derI + zi0 * derR);
+                    derR = derR1;
+                }
+
                 const double twoZr_p_dzr = curRefR + curRefR + dzr;
                 const double twoZi_p_dzi = curRefI + curRefI + dzi;
                 
@@ -142,11 +221,12 @@ namespace merutilm::rff2 {
                 ++iteration;
                 ++absIteration;
                 
-                // 次の参照軌道を取得 (ArrayCompressor呼び出しをここに移動)
+                // 次の参照軌道を取得 (refIterationは+1のみなのでカーソルを1つ進める)
                 // indexはループスコープ外の変数を利用
-                index = ArrayCompressor::compress(refObj->compressor, refIteration);
-                curRefR = refObj->refReal[index];
-                curRefI = refObj->refImag[index];
+                index = cursor.next();
+                orbit.prefetch(index);
+                curRefR = orbit[index].real;
+                curRefI = orbit[index].imag;
             }
             
             // 現在の z = Ref + delta
@@ -155,6 +235,7 @@ namespace merutilm::rff2 {
 
             // Glitch / Validity check
             if (zi == 0.0 && zr < 0.25 && zr >= -2.0) {
+                continuation.iteration = MandelbrotContinuation::INTERIOR;
                 return static_cast<double>(maxIteration);
             }
 
@@ -163,20 +244,38 @@ namespace merutilm::rff2 {
 
             // Rebasing / Reference wrapping logic
             if (refIteration == maxRefIteration || cd < dzr * dzr + dzi * dzi) {
+                if (interior) {
+                    if (const double dr = zr - savedZr, di = zi - savedZi;
+                        dr * dr + di * di < periodicityEpsilon * cd) {
+                        continuation.iteration = MandelbrotContinuation::INTERIOR;
+                        return static_cast<double>(maxIteration);
+                    }
+                    if (++rebases == nextSave) {
+                        savedZr = zr;
+                        savedZi = zi;
+                        nextSave <<= 1;
+                    }
+                }
+
                 refIteration = 0;
                 dzr = zr;
                 dzi = zi;
                 
                 // 参照軌道をリセットしたため、キャッシュも更新
-                index = ArrayCompressor::compress(refObj->compressor, 0);
-                curRefR = refObj->refReal[index];
-                curRefI = refObj->refImag[index];
+                index = cursor.seek(0);
+                curRefR = orbit[index].real;
+                curRefI = orbit[index].imag;
             }
 
             if (cd > bailout2) {
                 break;
             }
 
+            if (interior && derR * derR + derI * derI < derThreshold) {
+                continuation.iteration = MandelbrotContinuation::INTERIOR;
+                return static_cast<double>(maxIteration);
+            }
+
             // Optimization: Modulo removal
             if (--checkCounter == 0) {
                 if (state.interruptRequested()) return 0.0;
@@ -184,12 +283,15 @@ namespace merutilm::rff2 {
             }
         }
 
-        if (isAbs) {
-            return static_cast<double>(absIteration);
+        if (iteration >= maxIteration) {
+            suspend();
+            return static_cast<double>(isAbs ? absIteration : maxIteration);
         }
 
-        if (iteration >= maxIteration) {
-            return static_cast<double>(maxIteration);
+        continuation.iteration = MandelbrotContinuation::ESCAPED;
+
+        if (isAbs) {
+            return static_cast<double>(absIteration);
         }
 
         pd = std::sqrt(pd);
@@ -198,6 +300,419 @@ namespace merutilm::rff2 {
         return getDoubleValueIteration(iteration, pd, cd, calc.decimalizeIterationMethod, bailout);
     }
 
+    void LightMandelbrotPerturbator::iterateBatch(const std::span<const dex> dcr, const std::span<const dex> dci,
+                                                  const std::span<double> out,
+                                                  const std::span<MandelbrotContinuation> continuations) const {
+#ifdef RFF_SIMD_X86
+        // The lanes handle the MPA lookups one by one, so the dense tables are left to the scalar code.
+        const bool sparseTable = table == nullptr || table->mpaPeriod == nullptr ||
+                                 table->mpaPeriod->tablePeriod.front() >=
+                                 (table->mpaSettings.mpaCompressionMethod == FrtMPACompressionMethod::NO_COMPRESSION
+                                      ? Constants::Fractal::BATCH_MIN_UNCOMPRESSED_TABLE_PERIOD
+                                      : Constants::Fractal::BATCH_MIN_TABLE_PERIOD);
+        switch (sparseTable ? rff_simd::level() : rff_simd::Level::SCALAR) {
+            using enum rff_simd::Level;
+            case AVX512: {
+                iterateBatchAVX512(dcr, dci, out, continuations);
+                return;
+            }
+            case AVX2: {
+                iterateBatchAVX2(dcr, dci, out, continuations);
+                return;
+            }
+            default: {
+                break;
+            }
+        }
+#endif
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = continuations.empty() ? iterate(dcr[i], dci[i]) : iterate(dcr[i], dci[i], continuations[i]);
+        }
+    }
+
+#ifdef RFF_SIMD_X86
+    namespace {
+        using double4 = double __attribute__((vector_size(32)));
+        using mask4 = int64_t __attribute__((vector_size(32)));
+        using double8 = double __attribute__((vector_size(64)));
+        using mask8 = int64_t __attribute__((vector_size(64)));
+
+        constexpr ReferenceOrbitStore::Pair NO_REFERENCE = {0, 0};
+
+        /**
+         * Loads the real and the imaginary part of the pair of each lane's address. The vectors are built in the registers without any branch.
+         */
+        template<typename V, typename M, size_t... L>
+        [[gnu::always_inline]] inline void loadLanes(V &real, V &imag, const M &address, std::index_sequence<L...>) {
+            real = V{reinterpret_cast<const ReferenceOrbitStore::Pair *>(address[L])->real...};
+            imag = V{reinterpret_cast<const ReferenceOrbitStore::Pair *>(address[L])->imag...};
+        }
+    }
+
+    template<typename V, typename M>
+    [[gnu::always_inline]] inline void LightMandelbrotPerturbator::iterateLanes(
+        const std::span<const dex> dcr, const std::span<const dex> dci, const std::span<double> out,
+        const std::span<MandelbrotContinuation> continuations) const {
+        // Same recurrence as iterate(), one pixel per lane.
+        // The lanes step together while nothing happens, and only the lanes with an event
+        // (MPA lookup, end of contiguous reference, rebase, escape) are handled one by one.
+        // The vectors are only touched inline, since passing V by value out of the target function changes the ABI.
+        constexpr size_t LANES = sizeof(V) / sizeof(double);
+        constexpr size_t NO_PIXEL = SIZE_MAX;
+
+        const size_t length = out.size();
+        if (state.interruptRequested()) {
+            std::ranges::fill(out, 0.0);
+            return;
+        }
+
+        const auto *refObj = reference.get();
+        const auto *mpaTable = table.get();
+        const auto maxRefIteration = static_cast<int64_t>(refObj->longestPeriod());
+        const bool isAbs = calc.absoluteIterationMode;
+        const auto maxIteration = static_cast<int64_t>(calc.maxIteration);
+        const float bailout = calc.bailout;
+        const float bailout2 = bailout * bailout;
+        const int exitCheckInterval = Constants::Fractal::EXIT_CHECK_INTERVAL;
+        const auto interiorDetectionMethod = isAbs ? FrtInteriorDetectionMethod::NONE : calc.interiorDetectionMethod;
+        const bool interiorDetection = interiorDetectionMethod != FrtInteriorDetectionMethod::NONE;
+        const double derThreshold = interiorDetection ? Constants::Fractal::INTERIOR_DERIVATIVE_THRESHOLD : 0;
+        const double periodicityEpsilon = interiorDetectionMethod == FrtInteriorDetectionMethod::DERIVATIVE_AND_PERIODICITY
+                                              ? Constants::Fractal::INTERIOR_PERIODICITY_EPSILON
+                                              : 0;
+
+        V dzr = {};
+        V dzi = {};
+        V cr = {};
+        V ci = {};
+        V refR = {};
+        V refI = {};
+        V cd = {};
+        V pd = {};
+        M iteration = {};
+        M refIteration = {};
+        M absIteration = {};
+        M mpaCountdown = {};
+        M active = {};
+        V derR = {};
+        V derI = {};
+
+        size_t pixel[LANES];
+        double savedZr[LANES];
+        double savedZi[LANES];
+        uint64_t rebases[LANES];
+        uint64_t nextSave[LANES];
+        // The reference is read from the addresses of the pairs, which are moved by the vector step.
+        M refAddress = {};
+        M refRun = {};
+        bool referenceMoved = true;
+
+        auto cursors = std::vector<CompressedReferenceCursor>();
+        cursors.reserve(LANES);
+        for (size_t l = 0; l < LANES; ++l) {
+            cursors.emplace_back(refObj->compressor, refObj->compressorOffsets);
+        }
+
+        size_t nextPixel = 0;
+        size_t activeLanes = 0;
+
+        const auto anyLane = [](const M &mask) {
+            bool result = false;
+            for (size_t l = 0; l < LANES; ++l) {
+                result |= mask[l] != 0;
+            }
+            return result;
+        };
+
+        const auto loadReference = [&](const size_t l) {
+            // Keeps the pointers while the compressed index is contiguous, to skip the cursor and the segment lookup.
+            const uint64_t index = cursors[l].seek(static_cast<uint64_t>(refIteration[l]));
+            const auto pairs = refObj->orbit.segmentSpan(index);
+            referenceMoved = true;
+            refAddress[l] = reinterpret_cast<int64_t>(pairs.data());
+            refRun[l] = static_cast<int64_t>(std::min<uint64_t>(cursors[l].getRemaining(), pairs.size() - 1));
+        };
+
+        const auto refill = [&](const size_t l) {
+            iteration[l] = 0;
+            refIteration[l] = 0;
+            absIteration[l] = 0;
+            mpaCountdown[l] = 0;
+            dzr[l] = 0;
+            dzi[l] = 0;
+            cd[l] = 0;
+            pd[l] = 0;
+            derR[l] = 1;
+            derI[l] = 0;
+            savedZr[l] = 0;
+            savedZi[l] = 0;
+            rebases[l] = 0;
+            nextSave[l] = 1;
+
+            if (nextPixel >= length) {
+                pixel[l] = NO_PIXEL;
+                active[l] = 0;
+                cr[l] = 0;
+                ci[l] = 0;
+                refAddress[l] = reinterpret_cast<int64_t>(&NO_REFERENCE);
+                refRun[l] = 0;
+                referenceMoved = true;
+                return false;
+            }
+
+            const size_t p = nextPixel++;
+            pixel[l] = p;
+            active[l] = -1;
+            cr[l] = static_cast<double>(dcr[p]) + offR;
+            ci[l] = static_cast<double>(dci[p]) + offI;
+            if (series != nullptr) {
+                const MandelbrotContinuation start = series->evaluate(dex::value(cr[l]), dex::value(ci[l]));
+                iteration[l] = static_cast<int64_t>(start.iteration);
+                refIteration[l] = static_cast<int64_t>(start.refIteration);
+                dzr[l] = static_cast<double>(start.dzr);
+                dzi[l] = static_cast<double>(start.dzi);
+                derR[l] = static_cast<double>(start.derR);
+                derI[l] = static_cast<double>(start.derI);
+                cd[l] = start.cd;
+                pd[l] = start.pd;
+            }
+            loadReference(l);
+            return true;
+        };
+
+        const auto release = [&](const size_t l, const double result) {
+            out[pixel[l]] = result;
+            if (!refill(l)) {
+                --activeLanes;
+            }
+        };
+
+        // The lanes always start from zero or the series, and only store where they stopped.
+        const auto finish = [&](const size_t l, const double result, const uint64_t marker) {
+            if (!continuations.empty()) {
+                continuations[pixel[l]].iteration = marker;
+            }
+            release(l, result);
+        };
+
+        const auto suspend = [&](const size_t l, const double result) {
+            if (!continuations.empty()) {
+                continuations[pixel[l]] = MandelbrotContinuation{
+                    .dzr = dex::value(dzr[l]), .dzi = dex::value(dzi[l]),
+                    .derR = dex::value(derR[l]), .derI = dex::value(derI[l]),
+                    .iteration = static_cast<uint64_t>(iteration[l]),
+                    .refIteration = static_cast<uint64_t>(refIteration[l]), .cd = cd[l], .pd = pd[l]
+                };
+            }
+            release(l, result);
+        };
+
+        for (size_t l = 0; l < LANES; ++l) {
+            if (refill(l)) {
+                ++activeLanes;
+            }
+        }
+
+        int checkCounter = exitCheckInterval;
+
+        while (activeLanes > 0) {
+            M live = active;
+
+            // MPA : the lookup is done only where the table can exist.
+            if (mpaTable != nullptr) {
+                if (const M due = active & (mpaCountdown == 0); anyLane(due)) {
+                    for (size_t l = 0; l < LANES; ++l) {
+                        if (due[l] == 0) {
+                            continue;
+                        }
+
+                        // Skips are chained as "continue" in iterate(), and the lane steps after the last lookup.
+                        while (true) {
+                            const auto r = static_cast<uint64_t>(refIteration[l]);
+                            if (const uint64_t distance = mpaTable->distanceToNextTable(r); distance > 0) {
+                                mpaCountdown[l] = static_cast<int64_t>(std::min<uint64_t>(distance, INT64_MAX));
+                                break;
+                            }
+
+                            const LightPA::Entry *mpaPtr = mpaTable->lookup(r, dzr[l], dzi[l]);
+                            if (mpaPtr == nullptr) {
+                                const uint64_t distance = mpaTable->distanceToNextTable(r + 1);
+                                mpaCountdown[l] = static_cast<int64_t>(std::min<uint64_t>(distance, INT64_MAX - 1) + 1);
+                                break;
+                            }
+
+                            const LightPA::Entry &mpa = *mpaPtr;
+                            const double dzr0 = dzr[l];
+                            const double dzi0 = dzi[l];
+                            dzr[l] = mpa.anr * dzr0 - mpa.ani * dzi0 + mpa.bnr * cr[l] - mpa.bni * ci[l];
+                            dzi[l] = mpa.anr * dzi0 + mpa.ani * dzr0 + mpa.bnr * ci[l] + mpa.bni * cr[l];
+                            if (interiorDetection) {
+                                const double derR0 = derR[l];
+                                const double derI0 = derI[l];
+                                derR[l] = mpa.anr * derR0 - mpa.ani * derI0;
+                                derI[l] = mpa.anr * derI0 + mpa.ani * derR0;
+                            }
+                            iteration[l] += static_cast<int64_t>(mpa.skip);
+                            refIteration[l] += static_cast<int64_t>(mpa.skip);
+                            ++absIteration[l];
+
+                            if (derR[l] * derR[l] + derI[l] * derI[l] < derThreshold) {
+                                // The refilled lane starts at the next step.
+                                live[l] = 0;
+                                finish(l, static_cast<double>(maxIteration), MandelbrotContinuation::INTERIOR);
+                                break;
+                            }
+                            if (iteration[l] >= maxIteration) {
+                                live[l] = 0;
+                                suspend(l, static_cast<double>(isAbs ? absIteration[l] : maxIteration));
+                                break;
+                            }
+                            loadReference(l);
+                        }
+                    }
+                }
+            }
+
+            // Perturbation : dz = (2Z + dz) * dz + dc
+            if (referenceMoved) {
+                loadLanes(refR, refI, refAddress, std::make_index_sequence<LANES>{});
+                referenceMoved = false;
+            }
+            const M step = live & (refIteration != maxRefIteration);
+            if (interiorDetection) {
+                // dz/dz1 = 2z * dz/dz1, from z1 because z0 is zero
+                const M derStep = step & (iteration != 0);
+                const V zr0 = refR + dzr;
+                const V zi0 = refI + dzi;
+                const V nextDerR = 2.0 * (zr0 * derR - zi0 * derI);
+                const V nextDerI = 2.0 * (zr0 * derI + zi0 * derR);
+                derR = reinterpret_cast<V>((reinterpret_cast<M>(nextDerR) & derStep) | (reinterpret_cast<M>(derR) & ~derStep));
+                derI = reinterpret_cast<V>((reinterpret_cast<M>(nextDerI) & derStep) | (reinterpret_cast<M>(derI) & ~derStep));
+            }
+            const V twoZrPlusDzr = refR + refR + dzr;
+            const V twoZiPlusDzi = refI + refI + dzi;
+            const V nextDzr = twoZrPlusDzr * dzr - twoZiPlusDzi * dzi + cr;
+            const V nextDzi = twoZrPlusDzr * dzi + twoZiPlusDzi * dzr + ci;
+            dzr = reinterpret_cast<V>((reinterpret_cast<M>(nextDzr) & step) | (reinterpret_cast<M>(dzr) & ~step));
+            dzi = reinterpret_cast<V>((reinterpret_cast<M>(nextDzi) & step) | (reinterpret_cast<M>(dzi) & ~step));
+            iteration -= step;
+            refIteration -= step;
+            absIteration -= step;
+            mpaCountdown += step;
+
+            // The contiguous reference is followed by the addresses, and only the lanes at the end of it are reloaded.
+            refAddress += step & static_cast<int64_t>(sizeof(ReferenceOrbitStore::Pair));
+            refRun += step;
+            if (const M reload = step & (refRun < 0); anyLane(reload)) {
+                for (size_t l = 0; l < LANES; ++l) {
+                    if (reload[l] != 0) {
+                        loadReference(l);
+                    }
+                }
+            }
+            loadLanes(refR, refI, refAddress, std::make_index_sequence<LANES>{});
+            referenceMoved = false;
+
+            // z = Z + dz
+            const V zr = refR + dzr;
+            const V zi = refI + dzi;
+            const V currCd = zr * zr + zi * zi;
+            const V dzd = dzr * dzr + dzi * dzi;
+            pd = reinterpret_cast<V>((reinterpret_cast<M>(cd) & live) | (reinterpret_cast<M>(pd) & ~live));
+            cd = reinterpret_cast<V>((reinterpret_cast<M>(currCd) & live) | (reinterpret_cast<M>(cd) & ~live));
+
+            const M glitched = (zi == 0.0) & (zr < 0.25) & (zr >= -2.0);
+            const M rebased = (refIteration == maxRefIteration) | (cd < dzd);
+            const M escaped = cd > static_cast<double>(bailout2);
+            const M exceeded = iteration >= maxIteration;
+            const M interior = derR * derR + derI * derI < derThreshold;
+
+            if (const M events = live & (glitched | rebased | escaped | exceeded | interior); anyLane(events)) {
+                for (size_t l = 0; l < LANES; ++l) {
+                    if (events[l] == 0) {
+                        continue;
+                    }
+
+                    if (glitched[l] != 0) {
+                        finish(l, static_cast<double>(maxIteration), MandelbrotContinuation::INTERIOR);
+                        continue;
+                    }
+
+                    if (rebased[l] != 0) {
+                        if (const double dr = zr[l] - savedZr[l], di = zi[l] - savedZi[l];
+                            dr * dr + di * di < periodicityEpsilon * cd[l]) {
+                            finish(l, static_cast<double>(maxIteration), MandelbrotContinuation::INTERIOR);
+                            continue;
+                        }
+                        if (++rebases[l] == nextSave[l]) {
+                            savedZr[l] = zr[l];
+                            savedZi[l] = zi[l];
+                            nextSave[l] <<= 1;
+                        }
+
+                        refIteration[l] = 0;
+                        dzr[l] = zr[l];
+                        dzi[l] = zi[l];
+                        mpaCountdown[l] = 0;
+                        loadReference(l);
+                    }
+
+                    if (escaped[l] != 0) {
+                        if (iteration[l] >= maxIteration) {
+                            // Escaped at the max iteration, which is decimalized when it is continued.
+                            suspend(l, static_cast<double>(isAbs ? absIteration[l] : maxIteration));
+                        } else if (isAbs) {
+                            finish(l, static_cast<double>(absIteration[l]), MandelbrotContinuation::ESCAPED);
+                        } else {
+                            finish(l, getDoubleValueIteration(static_cast<uint64_t>(iteration[l]), std::sqrt(pd[l]),
+                                                              std::sqrt(cd[l]), calc.decimalizeIterationMethod,
+                                                              bailout), MandelbrotContinuation::ESCAPED);
+                        }
+                        continue;
+                    }
+
+                    if (interior[l] != 0) {
+                        finish(l, static_cast<double>(maxIteration), MandelbrotContinuation::INTERIOR);
+                    } else if (exceeded[l] != 0) {
+                        suspend(l, static_cast<double>(isAbs ? absIteration[l] : maxIteration));
+                    }
+                }
+            }
+
+            if (--checkCounter == 0) {
+                if (state.interruptRequested()) {
+                    for (size_t l = 0; l < LANES; ++l) {
+                        if (pixel[l] != NO_PIXEL) {
+                            out[pixel[l]] = 0.0;
+                        }
+                    }
+                    std::fill(out.begin() + static_cast<ptrdiff_t>(nextPixel), out.end(), 0.0);
+                    return;
+                }
+                checkCounter = exitCheckInterval;
+            }
+        }
+    }
+
+    __attribute__((target("avx2,fma")))
+    void LightMandelbrotPerturbator::iterateBatchAVX2(const std::span<const dex> dcr, const std::span<const dex> dci,
+                                                      const std::span<double> out,
+                                                      const std::span<MandelbrotContinuation> continuations) const {
+        iterateLanes<double4, mask4>(dcr, dci, out, continuations);
+    }
+
+    __attribute__((target("avx512f")))
+    void LightMandelbrotPerturbator::iterateBatchAVX512(const std::span<const dex> dcr, const std::span<const dex> dci,
+                                                        const std::span<double> out,
+                                                        const std::span<MandelbrotContinuation> continuations) const {
+        iterateLanes<double8, mask8>(dcr, dci, out, continuations);
+    }
+#endif
+
+
+    void LightMandelbrotPerturbator::approximateSeries(const std::span<const std::array<dex, 2> > probes) {
+        series = SeriesApproximation::create(state, *reference, calc, probes, dex::value(offR), dex::value(offI));
+    }
 
     std::unique_ptr<LightMandelbrotPerturbator> LightMandelbrotPerturbator::reuse(
         const FractalAttribute &calc, const double dcMax, ApproxTableCache &tableRef) {
@@ -4,14 +4,19 @@
 
 #pragma once
 
+#include <span>
+
 #include "LightMandelbrotReference.h"
+#include "MandelbrotKernelTable.h"
 #include "MandelbrotPerturbator.h"
 #include "../mrthy/LightMPATable.h"
+#include "../calc/rff_simd.h"
 
 namespace merutilm::rff2 {
     class LightMandelbrotPerturbator final : public MandelbrotPerturbator{
         std::unique_ptr<LightMandelbrotReference> reference = nullptr;
         std::unique_ptr<LightMPATable> table = nullptr;
+        MandelbrotKernelTable<LightMandelbrotPerturbator>::Kernel kernel = nullptr;
 
         const double dcMax;
         const double offR;
@@ -28,6 +33,27 @@ namespace merutilm::rff2 {
 
         double iterate(const dex &dcr, const dex &dci) const override;
 
+        double iterate(const dex &dcr, const dex &dci, MandelbrotContinuation &continuation) const override;
+
+        /**
+         * Iterates the given pixels in lockstep, 4 (AVX2) or 8 (AVX-512) pixels at once. <br/>
+         * The lane that escaped or finished is refilled with the next pixel, so the lanes are kept busy. <br/>
+         * Falls back to iterate() for each pixel when the CPU supports neither of them, or when the MPA table is too dense.
+         *
+         * @param dcr the real part of the pixel offsets
+         * @param dci the imaginary part of the pixel offsets
+         * @param out the iterations of the pixels, the same length as the offsets
+         * @param continuations the states where the pixels stopped, the same length as the offsets. They are not stored when it is empty.
+         */
+        void iterateBatch(std::span<const dex> dcr, std::span<const dex> dci, std::span<double> out,
+                          std::span<MandelbrotContinuation> continuations = {}) const;
+
+        /**
+         * Replaces the specialized kernel with the RUNTIME kernel, which dispatches the settings in the loop. <br/>
+         * It is the baseline of the kernel benchmark, and is never used for rendering.
+         */
+        void useRuntimeKernel();
+
         std::unique_ptr<LightMandelbrotPerturbator> reuse(const FractalAttribute &calc, double dcMax, ApproxTableCache &tableRef);
 
         const LightMandelbrotReference *getReference() const override;
@@ -37,6 +63,31 @@ namespace merutilm::rff2 {
         double getDcMax() const;
 
         dex getDcMaxAsDoubleExp() const override;
+
+        void approximateSeries(std::span<const std::array<dex, 2> > probes) override;
+
+    private:
+        friend class MandelbrotKernelTable<LightMandelbrotPerturbator>;
+
+        /**
+         * The iteration of a pixel, which is specialized for the settings of the frame.
+         * The RUNTIME kernel ignores the other parameters, and tests the settings in the loop instead.
+         * @see MandelbrotKernelTable
+         */
+        template<bool INTERIOR, bool MPA, FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION, bool RUNTIME = false>
+        double iterateKernel(const dex &dcr, const dex &dci, MandelbrotContinuation &continuation) const;
+
+#ifdef RFF_SIMD_X86
+        void iterateBatchAVX2(std::span<const dex> dcr, std::span<const dex> dci, std::span<double> out,
+                              std::span<MandelbrotContinuation> continuations) const;
+
+        void iterateBatchAVX512(std::span<const dex> dcr, std::span<const dex> dci, std::span<double> out,
+                              std::span<MandelbrotContinuation> continuations) const;
+
+        template<typename V, typename M>
+        void iterateLanes(std::span<const dex> dcr, std::span<const dex> dci, std::span<double> out,
+                          std::span<MandelbrotContinuation> continuations) const;
+#endif
     };
 
 
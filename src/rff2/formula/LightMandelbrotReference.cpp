@@ -11,14 +11,17 @@
 
 #include "../calc/rff_math.h"
 #include "../mrthy/ArrayCompressor.h"
+#include "ParallelReferenceStepper.h"
+#include "../calc/fp_fixed_complex.h"
+#include "../io/RFFReferenceCheckpoint.h"
 #include "../mrthy/SegmentedVector.h" // 追加
 #include "../constants/Constants.hpp"
 
 namespace merutilm::rff2 {
     // コンストラクタの定義変更 (std::vector -> SegmentedVector)
     LightMandelbrotReference::LightMandelbrotReference(fp_complex &&center, 
-                                                       SegmentedVector<double> &&refReal,
-                                                       SegmentedVector<double> &&refImag,
+                                                       ReferenceOrbitStore::Part &&refReal,
+                                                       ReferenceOrbitStore::Part &&refImag,
                                                        std::vector<ArrayCompressionTool> &&compressor,
                                                        std::vector<uint64_t> &&period,
                                                        fp_complex &&fpgReference,
@@ -27,8 +30,7 @@ namespace merutilm::rff2 {
                                                                                  std::move(period),
                                                                                  std::move(fpgReference),
                                                                                  std::move(fpgBn)),
-                                                                             refReal(std::move(refReal)),
-                                                                             refImag(std::move(refImag)) {
+                                                                             orbit(std::move(refReal), std::move(refImag)) {
     }
 
     std::unique_ptr<LightMandelbrotReference> LightMandelbrotReference::createReference(
@@ -44,8 +46,8 @@ namespace merutilm::rff2 {
         // 【変更】std::vector から SegmentedVector へ
         // これにより、巨大な連続領域確保が不要になり、ページ単位でのメモリ確保となるため
         // bad_alloc (メモリ断片化) を回避しつつ、スワップ領域を限界まで使用可能になる。
-        auto rr = SegmentedVector<double>();
-        auto ri = SegmentedVector<double>();
+        auto rr = ReferenceOrbitStore::Part(SegmentStorage(calc.referenceStorageMethod, calc.scratchDirectory));
+        auto ri = ReferenceOrbitStore::Part(SegmentStorage(calc.referenceStorageMethod, calc.scratchDirectory));
 
         // SegmentedVectorは内部で動的に拡張するため、事前のreserveは必須ではないが
         // 概算サイズがわかるならヒントとして与えても良い（ここでは削除してもOK）
@@ -55,10 +57,10 @@ namespace merutilm::rff2 {
         ri.push_back(0);
 
         fp_complex center = calc.center;
-        auto c = center.edit(exp10);
-        auto z = fp_complex_calculator(0, 0, exp10);
+        const mp_size_t fixedSize = fp_fixed::exp10ToSize(exp10);
+        const auto c = fp_fixed_complex(center.edit(exp10), fixedSize);
+        auto z = fp_fixed_complex(fixedSize);
         auto fpgBn = fp_complex_calculator(0, 0, exp10);
-        auto one = fp_complex_calculator(1.0, 0.0, exp10);
         double bailoutSqr = calc.bailout * calc.bailout;
 
         double fpgBnr = 1;
@@ -71,6 +73,7 @@ namespace merutilm::rff2 {
         auto periodArray = std::vector<uint64_t>();
 
         auto minZRadius = DBL_MAX;
+        auto fpgMargin = DBL_MAX;
         uint64_t reuseIndex = 0;
 
         auto tools = std::vector<ArrayCompressionTool>();
@@ -82,10 +85,41 @@ namespace merutilm::rff2 {
         bool canReuse = withoutNormalize;
 
         std::unique_ptr<fp_complex> fpgReference = nullptr;
+        const auto stepper = ParallelReferenceStepper::create(exp10, calc.threadedReferenceMinBits, strictFPG);
+        const auto checkpoint = RFFReferenceCheckpoint<double>::create(calc, exp10, strictFPG, c);
+
+        if (checkpoint != nullptr) {
+            if (auto resumed = checkpoint->resume(z, fpgBn, rr, ri, maxIteration, initialPeriod, dcMax)) {
+                iteration = resumed->iteration;
+                period = std::max<uint64_t>(iteration, 1);
+                reuseIndex = resumed->reuseIndex;
+                compressed = resumed->compressed;
+                canReuse = resumed->canReuse;
+                zr = resumed->zr;
+                zi = resumed->zi;
+                fpgBnr = resumed->fpgBnr;
+                fpgBni = resumed->fpgBni;
+                minZRadius = resumed->minZRadius;
+                fpgMargin = resumed->fpgMargin;
+                periodArray = std::move(resumed->periodArray);
+                tools = std::move(resumed->tools);
+            }
+        }
 
         while (zr * zr + zi * zi < bailoutSqr && iteration < maxIteration) {
-            if (iteration % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 && state.interruptRequested()) {
-                return Constants::NullPointer::PROCESS_TERMINATED_REFERENCE;
+            if (iteration % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 || iteration == maxIteration - 1) {
+                const bool interrupted = state.interruptRequested();
+                if (checkpoint != nullptr && checkpoint->due(interrupted || iteration == maxIteration - 1)) {
+                    checkpoint->save({
+                                         .iteration = iteration, .reuseIndex = reuseIndex, .compressed = compressed,
+                                         .canReuse = canReuse, .zr = zr, .zi = zi, .fpgBnr = fpgBnr, .fpgBni = fpgBni,
+                                         .minZRadius = minZRadius, .fpgMargin = fpgMargin, .periodArray = periodArray,
+                                         .tools = tools
+                                     }, z, fpgBn, rr, ri);
+                }
+                if (interrupted) {
+                    return Constants::NullPointer::PROCESS_TERMINATED_REFERENCE;
+                }
             }
 
             // use Fast-Period-Guessing, and create MPA Table
@@ -111,25 +145,19 @@ namespace merutilm::rff2 {
                 if ((fpgReference == nullptr && fpgRadius > fpgLimit) || radius2 == 0 || (
                         initialPeriod != 0 && initialPeriod == iteration)) {
                     periodArray.push_back(iteration);
-                    fpgReference = std::make_unique<fp_complex>(z);
+                    fpgReference = std::make_unique<fp_complex>(z.calculator_value(exp10));
                     break;
                 }
 
+                fpgMargin = std::min(fpgMargin, radius2 / fpgRadius);
                 fpgBnr = fpgBnrTemp;
                 fpgBni = fpgBniTemp;
             }
 
 
-            if (strictFPG) {
-                fpgBn *= z.doubled();
-                fpgBn += one;
-                z.halved();
-            }
-
             //Let's do arbitrary-precision operation!!
             func(iteration);
-            z.square();
-            z += c;
+            stepper->step(z, c, fpgBn);
             zr = z.getReal().double_value();
             zi = z.getImag().double_value();
 
@@ -189,13 +217,21 @@ namespace merutilm::rff2 {
                 } else {
                     rr[index] = zr;
                     ri[index] = zi;
+                    if (checkpoint != nullptr) {
+                        checkpoint->markDirty(index);
+                    }
                 }
             }
         }
 
 
+        // the checkpoint at the max iteration is kept, to continue when it is raised.
+        if (checkpoint != nullptr && iteration != maxIteration - 1) {
+            checkpoint->remove();
+        }
+
         if (!strictFPG) fpgBn = fp_complex_calculator(fpgBnr, fpgBni, exp10);
-        if (fpgReference == nullptr) fpgReference = std::make_unique<fp_complex>(z);
+        if (fpgReference == nullptr) fpgReference = std::make_unique<fp_complex>(z.calculator_value(exp10));
 
         // SegmentedVector は resize を実装していませんが、
         // 上記ループのロジック上、push_back で正しいサイズになっているはずなので resize は不要です。
@@ -210,16 +246,16 @@ namespace merutilm::rff2 {
 
 
     double LightMandelbrotReference::real(const uint64_t refIteration) const {
-        return refReal[ArrayCompressor::compress(compressor, refIteration)];
+        return orbit[ArrayCompressor::compress(compressor, refIteration)].real;
     }
 
     double LightMandelbrotReference::imag(const uint64_t refIteration) const {
-        return refImag[ArrayCompressor::compress(compressor, refIteration)];
+        return orbit[ArrayCompressor::compress(compressor, refIteration)].imag;
     }
 
 
     size_t LightMandelbrotReference::length() const {
-        return refReal.size();
+        return orbit.size();
     }
 
 
@@ -14,6 +14,7 @@
 // 【追加】SegmentedVector をインクルード
 // (ArrayCompressorと同じフォルダにあると仮定しています)
 #include "../mrthy/SegmentedVector.h" 
+#include "../mrthy/ReferenceOrbitStore.h"
 
 #include "../parallel/ParallelRenderState.h"
 #include "../attr/FractalAttribute.h"
@@ -21,17 +22,15 @@
 namespace merutilm::rff2 {
     struct LightMandelbrotReference final : public MandelbrotReference{
 
-        // 【変更】std::vector<double> -> SegmentedVector<double>
-        // これにより、数億〜数十億ポイントの巨大な参照軌道データを
-        // 連続領域を必要とせずにメモリに格納できるようになります。
-        const SegmentedVector<double> refReal;
-        const SegmentedVector<double> refImag;
+        // The orbit is built in the separated parts, and interleaved when the reference is created.
+        // The pair of each step is read at once by the perturbator and the PA generator.
+        const ReferenceOrbitStore orbit;
 
 
         // 【変更】コンストラクタの引数も SegmentedVector に変更
         explicit LightMandelbrotReference(fp_complex &&center, 
-                                 SegmentedVector<double> &&refReal,
-                                 SegmentedVector<double> &&refImag, 
+                                 ReferenceOrbitStore::Part &&refReal,
+                                 ReferenceOrbitStore::Part &&refImag, 
                                  std::vector<ArrayCompressionTool> &&compressor,
                                  std::vector<uint64_t> &&period, fp_complex &&fpgReference, fp_complex &&fpgBn);
 
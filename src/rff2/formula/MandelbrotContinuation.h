@@ -0,0 +1,43 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <cstdint>
+
+#include "../calc/dex.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Mandelbrot Continuation</b>
+     * <br/>
+     * The state of the pixel where its iteration stopped at the max iteration.
+     * The pixel is iterated again from here when the max iteration is raised, instead of from zero.
+     * <li> The derivative of the interior detection is kept, because the small one from the stopped point does not mean the interior.
+     * The saved z of the periodicity check starts again, since the attracting cycle is found from any point.</li>
+     * <li> The iteration is one of the markers when the pixel cannot be continued.</li>
+     */
+    struct MandelbrotContinuation {
+        /**
+         * The pixel escaped under the max iteration.
+         */
+        static constexpr uint64_t ESCAPED = UINT64_MAX;
+        /**
+         * The pixel is detected as the interior, or stopped by the invalid delta.
+         */
+        static constexpr uint64_t INTERIOR = UINT64_MAX - 1;
+
+        dex dzr = dex::ZERO;
+        dex dzi = dex::ZERO;
+        dex derR = dex::ONE;
+        dex derI = dex::ZERO;
+        uint64_t iteration = 0;
+        uint64_t refIteration = 0;
+        double cd = 0;
+        double pd = 0;
+
+        [[nodiscard]] bool isContinuable() const {
+            return iteration < INTERIOR;
+        }
+    };
+}
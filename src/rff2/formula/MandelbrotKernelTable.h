@@ -0,0 +1,79 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "MandelbrotContinuation.h"
+#include "../attr/FractalAttribute.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Mandelbrot Kernel Table</b>
+     * <br/>
+     * The dispatch table of the iteration kernels of the perturbator, which are specialized for the settings fixed in a frame.
+     * The kernel is selected once when the perturbator is created, so its loop has no branches of these settings.
+     * <li> INTERIOR : the interior detection is used. It is never used in the absolute iteration mode.</li>
+     * <li> MPA : the table has the periods to look up.</li>
+     * <li> SELECTION, COMPRESSION : the selection and the compression method of the table lookup.</li>
+     * <li> RUNTIME : the fallback kernel, which ignores the other parameters and tests the settings in the loop.
+     * It is never selected by this table. The perturbator sets it in @code useRuntimeKernel()@endcode, as the baseline of the kernel benchmark.</li>
+     * <br/>
+     * The perturbator must befriend this table, and has the kernel
+     * @code template<bool INTERIOR, bool MPA, FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION, bool RUNTIME = false>
+     * double iterateKernel(const dex &dcr, const dex &dci, MandelbrotContinuation &continuation) const@endcode
+     */
+    template<typename P>
+    class MandelbrotKernelTable {
+    public:
+        using Kernel = double (P::*)(const dex &, const dex &, MandelbrotContinuation &) const;
+
+        /**
+         * @param calc the attribute of the perturbator
+         * @param mpa whether the table has the periods to look up
+         * @return the kernel for the settings
+         */
+        static Kernel select(const FractalAttribute &calc, bool mpa);
+
+    private:
+        static constexpr size_t SELECTIONS = 2;
+        static constexpr size_t COMPRESSIONS = 3;
+
+        template<size_t I>
+        static constexpr Kernel entry() {
+            constexpr bool interior = I % 2 != 0;
+            constexpr bool mpa = I / 2 % 2 != 0;
+            constexpr auto selection = static_cast<FrtMPASelectionMethod>(I / 4 % SELECTIONS);
+            constexpr auto compression = static_cast<FrtMPACompressionMethod>(I / 4 / SELECTIONS);
+            return &P::template iterateKernel<interior, mpa, selection, compression>;
+        }
+
+        template<size_t... I>
+        static constexpr std::array<Kernel, sizeof...(I)> createKernels(std::index_sequence<I...>) {
+            return {entry<I>()...};
+        }
+    };
+
+    // DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE
+    // DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE
+    // DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE
+    // DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE
+    // DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE  DEFINITION OF MANDELBROT KERNEL TABLE
+
+
+    template<typename P>
+    typename MandelbrotKernelTable<P>::Kernel MandelbrotKernelTable<P>::select(const FractalAttribute &calc,
+                                                                                const bool mpa) {
+        static constexpr auto KERNELS = createKernels(std::make_index_sequence<4 * SELECTIONS * COMPRESSIONS>{});
+
+        const bool interior = !calc.absoluteIterationMode &&
+                              calc.interiorDetectionMethod != FrtInteriorDetectionMethod::NONE;
+        // The kernels without the table do not depend on the methods, so only the first ones are used.
+        const size_t selection = mpa ? static_cast<size_t>(calc.mpaAttribute.mpaSelectionMethod) : 0;
+        const size_t compression = mpa ? static_cast<size_t>(calc.mpaAttribute.mpaCompressionMethod) : 0;
+        return KERNELS[interior + 2 * mpa + 4 * (selection + SELECTIONS * compression)];
+    }
+}
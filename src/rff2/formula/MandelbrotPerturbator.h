@@ -3,9 +3,15 @@
 //
 
 #pragma once
+#include <array>
+#include <memory>
+#include <span>
+
+#include "MandelbrotContinuation.h"
 #include "MandelbrotReference.h"
 #include "Perturbator.h"
 #include "../mrthy/MPATable.h"
+#include "../mrthy/SeriesApproximation.h"
 #include "../parallel/ParallelRenderState.h"
 #include "../attr/FractalAttribute.h"
 
@@ -13,6 +19,7 @@ namespace merutilm::rff2 {
     struct MandelbrotPerturbator : public Perturbator {
         ParallelRenderState &state;
         const FractalAttribute calc;
+        std::unique_ptr<SeriesApproximation> series = nullptr;
 
         explicit MandelbrotPerturbator(ParallelRenderState &state,
                                        const FractalAttribute &calculationSettings) : state(state),
@@ -29,6 +36,31 @@ namespace merutilm::rff2 {
 
         virtual dex getDcMaxAsDoubleExp() const = 0;
 
+        /**
+         * Creates the series approximation of the frame, which is used by all pixels which start from zero.
+         * It must be called before the pixels are iterated, and is disabled by the zero terms of the MPA attribute.
+         * @param probes the offsets of the farthest pixels, usually the corners of the frame
+         */
+        virtual void approximateSeries(std::span<const std::array<dex, 2> > probes) = 0;
+
+        /**
+         * @return the iterations skipped by the series approximation, or zero if it is not used.
+         */
+        uint64_t getSeriesSkip() const {
+            return series == nullptr ? 0 : series->getSkip();
+        }
+
         virtual double iterate(const dex &dcr, const dex &dci) const = 0;
+
+        /**
+         * Iterates the pixel from the given state, and stores the state where it stopped. <br/>
+         * The pixel which reached the max iteration can be continued with the higher max iteration,
+         * as long as the reference and the table are not changed.
+         * @param dcr the real part of the pixel offset
+         * @param dci the imaginary part of the pixel offset
+         * @param continuation the state to start from. The default one starts from zero, or from the series approximation.
+         * @return the iteration of the pixel
+         */
+        virtual double iterate(const dex &dcr, const dex &dci, MandelbrotContinuation &continuation) const = 0;
     };
 }
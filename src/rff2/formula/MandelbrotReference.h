@@ -3,22 +3,30 @@
 //
 
 #pragma once
+#include <atomic>
 #include <vector>
 
 #include "../calc/fp_complex.h"
 #include "../mrthy/ArrayCompressionTool.h"
+#include "../mrthy/CompressedReferenceCursor.h"
 
 namespace merutilm::rff2 {
     struct MandelbrotReference {
         const fp_complex center;
         const std::vector<ArrayCompressionTool> compressor;
+        const std::vector<uint64_t> compressorOffsets;
         const std::vector<uint64_t> period;
         const fp_complex fpgReference;
         const fp_complex fpgBn;
+        /**
+         * The unique number of this reference in the process. Unlike the address, it is never given to a new reference.
+         */
+        const uint64_t generation = nextGeneration();
 
         MandelbrotReference(fp_complex &&center, std::vector<ArrayCompressionTool> &&compressor,
         std::vector<uint64_t> &&period, fp_complex &&fpgReference, fp_complex &&fpgBn) : center(std::move(center)),
                                                     compressor(std::move(compressor)),
+                                                    compressorOffsets(CompressedReferenceCursor::createPulledOffsets(this->compressor)),
                                                     period(std::move(period)),
                                                     fpgReference(std::move(fpgReference)),
                                                     fpgBn(std::move(fpgBn)){}
@@ -31,5 +39,11 @@ namespace merutilm::rff2 {
         virtual size_t length() const = 0;
 
         virtual uint64_t longestPeriod() const = 0;
+
+    private:
+        static uint64_t nextGeneration() {
+            static auto counter = std::atomic<uint64_t>(0);
+            return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#include "ParallelReferenceStepper.h"
+
+namespace merutilm::rff2 {
+    ParallelReferenceStepper::ParallelReferenceStepper(const int exp10, const uint32_t lanes, const bool strictFPG) :
+        strictFPG(strictFPG), workers(lanes), one(1.0, exp10) {
+        const mp_size_t size = fp_fixed::exp10ToSize(exp10);
+        for (auto &product: zProducts) {
+            product = fp_fixed(size);
+        }
+        for (auto &sum: zSums) {
+            sum = fp_fixed(size);
+        }
+        for (auto &product: bnProducts) {
+            product = fp_decimal_calculator(0.0, exp10);
+        }
+        bnDifference = fp_decimal_calculator(0.0, exp10);
+        for (auto &s: scratch) {
+            s.resize(fp_fixed::scratchSize(size));
+        }
+    }
+
+    std::unique_ptr<ParallelReferenceStepper> ParallelReferenceStepper::create(
+        const int exp10, const uint32_t minBits, const bool strictFPG) {
+        const auto bits = static_cast<int64_t>(-fp_decimal_calculator::exp10ToExp2(exp10));
+        uint32_t lanes = strictFPG ? STRICT_FPG_LANES : LANES;
+        if (minBits == 0 || bits <= minBits || std::thread::hardware_concurrency() < lanes) {
+            lanes = 1;
+        }
+        return std::make_unique<ParallelReferenceStepper>(exp10, lanes, strictFPG);
+    }
+
+    void ParallelReferenceStepper::step(fp_fixed_complex &z, const fp_fixed_complex &c,
+                                        fp_complex_calculator &fpgBn) {
+        const uint32_t lanes = workers.getLanes();
+        if (lanes == 1 && !strictFPG) {
+            z.squareAdd(c);
+            return;
+        }
+
+        fp_fixed &zr = z.getReal();
+        fp_fixed &zi = z.getImag();
+        fp_decimal_calculator &br = fpgBn.getReal();
+        fp_decimal_calculator &bi = fpgBn.getImag();
+
+        fp_fixed::fp_add(zSums[0], zr, zi);
+        fp_fixed::fp_sub(zSums[1], zr, zi);
+        if (strictFPG) {
+            fp_decimal_calculator::fp_sub(bnDifference, br, bi);
+        }
+
+        // every job only reads the old z and fpgBn, and writes its own product.
+        const uint32_t jobs = strictFPG ? 5 : 2;
+        workers.run([&](const uint32_t lane) {
+            for (uint32_t job = lane; job < jobs; job += lanes) {
+                multiply(job, z, fpgBn, scratch[lane].data());
+            }
+        });
+
+        if (strictFPG) {
+            //fpgBn * z = (p0 - p1 + p2) + (p1 + p2)i
+            fp_decimal_calculator::fp_sub(br, bnProducts[0], bnProducts[1]);
+            fp_decimal_calculator::fp_add(br, br, bnProducts[2]);
+            fp_decimal_calculator::fp_dbl(br, br);
+            fp_decimal_calculator::fp_add(br, br, one);
+            fp_decimal_calculator::fp_add(bi, bnProducts[1], bnProducts[2]);
+            fp_decimal_calculator::fp_dbl(bi, bi);
+        }
+
+        fp_fixed::fp_add(zr, zProducts[0], c.getReal());
+        fp_fixed::fp_dbl(zi, zProducts[1]);
+        fp_fixed::fp_add(zi, zi, c.getImag());
+    }
+
+    void ParallelReferenceStepper::multiply(const uint32_t job, const fp_fixed_complex &z,
+                                            fp_complex_calculator &fpgBn, mp_limb_t *laneScratch) {
+        switch (job) {
+            case 0: {
+                fp_fixed::fp_mul(zProducts[0], zSums[0], zSums[1], laneScratch);
+                break;
+            }
+            case 1: {
+                fp_fixed::fp_mul(zProducts[1], z.getReal(), z.getImag(), laneScratch);
+                break;
+            }
+            case 2: {
+                fp_fixed::fp_mul(bnProducts[0], bnDifference, zSums[0]);
+                break;
+            }
+            case 3: {
+                fp_fixed::fp_mul(bnProducts[1], fpgBn.getReal(), z.getImag());
+                break;
+            }
+            default: {
+                fp_fixed::fp_mul(bnProducts[2], fpgBn.getImag(), z.getReal());
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <array>
+#include <memory>
+
+#include "../calc/fp_fixed_complex.h"
+#include "../parallel/ParallelSpinWorkers.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Parallel Reference Stepper</b>
+     * <br/>
+     * Runs one iteration of the reference orbit, and the independent arbitrary-precision multiplications of it on the spin workers.
+     * <li> z = z^2 + c needs (zr + zi)(zr - zi) and zr * zi.</li>
+     * <li> With the strict FPG, fpgBn = 2 * fpgBn * z + 1 adds three more multiplications of the same old z.
+     * fpgBn is not bounded like z, so it stays as the unbounded decimal.</li>
+     * <li> The multiplications are assigned to the lanes in turn. The sums and the shifts are done by the caller, because they are cheap.</li>
+     * <li> With one lane, z uses the fused square-add of @code fp_fixed_complex@endcode.</li>
+     */
+    class ParallelReferenceStepper final {
+        static constexpr uint32_t LANES = 2;
+        static constexpr uint32_t STRICT_FPG_LANES = 3;
+
+        const bool strictFPG;
+        ParallelSpinWorkers workers;
+        std::array<fp_fixed, 2> zProducts;
+        std::array<fp_fixed, 2> zSums;
+        std::array<fp_decimal_calculator, 3> bnProducts;
+        fp_decimal_calculator bnDifference;
+        fp_decimal_calculator one;
+        std::array<std::vector<mp_limb_t>, STRICT_FPG_LANES> scratch;
+
+    public:
+        explicit ParallelReferenceStepper(int exp10, uint32_t lanes, bool strictFPG);
+
+        /**
+         * Creates the stepper. It uses the threads only when the precision is high enough that the multiplication cost dominates the synchronization cost.
+         * @param exp10 the exponent of 10 for arbitrary-precision operation
+         * @param minBits the minimum precision in bits to use the threads. Zero disables them.
+         * @param strictFPG use arbitrary-precision operation for fpg_bn calculation
+         * @return the stepper
+         */
+        static std::unique_ptr<ParallelReferenceStepper> create(int exp10, uint32_t minBits, bool strictFPG);
+
+        /**
+         * z = z^2 + c, and fpgBn = 2 * fpgBn * z + 1 with the old z when the strict FPG is used.
+         */
+        void step(fp_fixed_complex &z, const fp_fixed_complex &c, fp_complex_calculator &fpgBn);
+
+    private:
+        void multiply(uint32_t job, const fp_fixed_complex &z, fp_complex_calculator &fpgBn, mp_limb_t *laneScratch);
+    };
+}
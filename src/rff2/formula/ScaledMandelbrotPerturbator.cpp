@@ -0,0 +1,570 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#include "ScaledMandelbrotPerturbator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace merutilm::rff2 {
+    namespace {
+        /**
+         * @return the exponent e of the normalized value, which satisfies |v| < 2^e. the very small number is returned for zero.
+         */
+        int exponentOf(const dex &v) {
+            if (v.sgn() == 0) {
+                return std::numeric_limits<int>::min() / 2;
+            }
+            return v.get_exp2();
+        }
+
+        /**
+         * @return the exponent e of the normal double, which satisfies |v| < 2^e.
+         */
+        int exponentOf(const double v) {
+            return static_cast<int>(std::bit_cast<uint64_t>(v) >> 52 & 0x7ff) - 1022;
+        }
+
+        /**
+         * @return 2^exponent, or zero when it is too small for the normal double.
+         */
+        double powerOfTwo(const int exponent) {
+            if (exponent < std::numeric_limits<double>::min_exponent - 1) {
+                return 0;
+            }
+            return std::bit_cast<double>(static_cast<uint64_t>(exponent + 1023) << 52);
+        }
+
+        /**
+         * @return v / 2^scale. The scale must not be smaller than the exponent of v.
+         */
+        double scaledMantissa(const dex &v, const int scale) {
+            if (v.sgn() == 0) {
+                return 0;
+            }
+            return dex::ldexp_neg(v.get_mantissa(), v.get_exp2() - scale);
+        }
+
+        /**
+         * @return the double of v. The exponent of the mantissa is moved by the bits when the result stays normal,
+         * and ldexp is used only for the rest.
+         */
+        double toDouble(const dex &v) {
+            const auto bits = std::bit_cast<uint64_t>(v.get_mantissa());
+            const int field = static_cast<int>(bits >> 52 & 0x7ff);
+            if (const int moved = field + v.get_exp2(); field == 0 || field == 0x7ff || moved <= 0 || moved >= 0x7ff) {
+                return static_cast<double>(v);
+            }
+            return std::bit_cast<double>(bits + (static_cast<uint64_t>(v.get_exp2()) << 52));
+        }
+
+        dex scaledToDex(const double mantissa, const int scale) {
+            dex result = dex(scale, mantissa);
+            dex::normalize(&result);
+            return result;
+        }
+    }
+
+
+    ScaledMandelbrotPerturbator::ScaledMandelbrotPerturbator(ParallelRenderState &state, const FractalAttribute &calc,
+                                                             const dex &dcMax, const int exp10,
+                                                             const uint64_t initialPeriod,
+                                                             ApproxTableCache &tableRef,
+                                                             std::function<void(uint64_t)> &&actionPerRefCalcIteration,
+                                                             std::function<void(uint64_t, double)> &&
+                                                             actionPerCreatingTableIteration,
+                                                             const bool arbitraryPrecisionFPGBn,
+                                                             std::unique_ptr<DeepMandelbrotReference> reusedReference,
+                                                             std::unique_ptr<DeepMPATable> reusedTable,
+                                                             const dex &offR,
+                                                             const dex &offI) : MandelbrotPerturbator(state, calc),
+                                                                                dcMax(dcMax), offR(offR), offI(offI) {
+        if (reusedReference == nullptr) {
+            reference = DeepMandelbrotReference::createReference(state, calc, exp10, initialPeriod, dcMax,
+                                                                 arbitraryPrecisionFPGBn,
+                                                                 std::move(actionPerRefCalcIteration));
+        } else {
+            reference = std::move(reusedReference);
+        }
+
+        if (reference == Constants::NullPointer::PROCESS_TERMINATED_REFERENCE) {
+            return;
+        }
+
+        if (reusedTable == nullptr) {
+            table = std::make_unique<DeepMPATable>(state, *reference, &calc.mpaAttribute, dcMax,
+                                                   tableRef,
+                                                   std::move(actionPerCreatingTableIteration));
+        } else {
+            table = std::move(reusedTable);
+        }
+        kernel = MandelbrotKernelTable<ScaledMandelbrotPerturbator>::select(calc, table->mpaPeriod != nullptr);
+    }
+
+
+    std::array<double, 2> ScaledMandelbrotPerturbator::doubleReference(const uint64_t index) const {
+        const auto zr = toDouble(reference->orbit.real(index));
+        const auto zi = toDouble(reference->orbit.imag(index));
+        if (std::max(std::abs(zr), std::abs(zi)) < SMALL_REFERENCE) {
+            return {0, 0};
+        }
+        return {zr, zi};
+    }
+
+
+    double ScaledMandelbrotPerturbator::iterate(const dex &dcr, const dex &dci) const {
+        auto continuation = MandelbrotContinuation();
+        return iterate(dcr, dci, continuation);
+    }
+
+    double ScaledMandelbrotPerturbator::iterate(const dex &dcr, const dex &dci,
+                                                MandelbrotContinuation &continuation) const {
+        return (this->*kernel)(dcr, dci, continuation);
+    }
+
+    void ScaledMandelbrotPerturbator::useRuntimeKernel() {
+        kernel = &ScaledMandelbrotPerturbator::iterateKernel<false, false, FrtMPASelectionMethod::LOWEST,
+            FrtMPACompressionMethod::NO_COMPRESSION, true>;
+    }
+
+    template<bool INTERIOR, bool MPA, FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION, bool RUNTIME>
+    double ScaledMandelbrotPerturbator::iterateKernel(const dex &dcr, const dex &dci,
+                                                      MandelbrotContinuation &continuation) const {
+        if (state.interruptRequested()) return 0.0;
+
+        const dex dcr1 = dcr + offR;
+        const dex dci1 = dci + offI;
+        if (series != nullptr && continuation.iteration == 0) {
+            continuation = series->evaluate(dcr1, dci1);
+        }
+        const int dcExponent = std::max(exponentOf(dcr1), exponentOf(dci1));
+
+        uint64_t iteration = continuation.iteration;
+        uint64_t refIteration = continuation.refIteration;
+        int absIteration = 0;
+        const uint64_t maxRefIteration = reference->longestPeriod();
+
+        // dz = w * 2^scale, dc = u * 2^scale
+        int scale = 0;
+        double s = 0; // 2^scale, it becomes zero when the scale is too small for double.
+        double wr = 0;
+        double wi = 0;
+        double ur = 0;
+        double ui = 0;
+        double uMax = 0;
+
+        const auto setScale = [&](const int exponent) {
+            // The scale is never smaller than the exponent of dc, so the shifts are not positive.
+            scale = exponent;
+            s = powerOfTwo(scale);
+            ur = scaledMantissa(dcr1, scale);
+            ui = scaledMantissa(dci1, scale);
+            uMax = std::max(std::abs(ur), std::abs(ui));
+        };
+
+        const auto setDelta = [&](const dex &dzr, const dex &dzi) {
+            setScale(std::max({exponentOf(dzr), exponentOf(dzi), dcExponent}));
+            wr = scaledMantissa(dzr, scale);
+            wi = scaledMantissa(dzi, scale);
+        };
+
+        setDelta(continuation.dzr, continuation.dzi);
+
+        const dex zrMin = dex::value(-2);
+        const dex zrMax = dex::value(0.25);
+
+        double cd = continuation.cd;
+        double pd = continuation.pd;
+        const bool isAbs = calc.absoluteIterationMode;
+        const uint64_t maxIteration = calc.maxIteration;
+        const float bailout = calc.bailout;
+        const float bailout2 = bailout * bailout;
+        auto temps = std::array<dex, 4>();
+        auto cursor = CompressedReferenceCursor(reference->compressor, reference->compressorOffsets);
+        uint64_t tableDistance = 0;
+
+        // The runtime kernel reads the settings here, and tests them in the loop.
+        const bool interior = RUNTIME
+                                  ? !isAbs && calc.interiorDetectionMethod != FrtInteriorDetectionMethod::NONE
+                                  : INTERIOR;
+        const bool mpa = RUNTIME ? table->mpaPeriod != nullptr : MPA;
+
+        // Interior detection : dz/dz1 is multiplied by 2z every iteration, and by A of the PA when skipped.
+        // dz/dz1 = d * 2^derScale, and the threshold is scaled together. The zero threshold disables the check.
+        const bool periodicityDetection = interior &&
+                                          calc.interiorDetectionMethod == FrtInteriorDetectionMethod::DERIVATIVE_AND_PERIODICITY;
+        const dex periodicityEpsilon = dex::value(Constants::Fractal::INTERIOR_PERIODICITY_EPSILON);
+        const dex &derivativeR = continuation.derR;
+        const dex &derivativeI = continuation.derI;
+        int derScale = derivativeR.sgn() == 0 && derivativeI.sgn() == 0
+                           ? 0
+                           : std::max(exponentOf(derivativeR), exponentOf(derivativeI));
+        double derR = scaledMantissa(derivativeR, derScale);
+        double derI = scaledMantissa(derivativeI, derScale);
+        double derThreshold = interior
+                                  ? std::ldexp(Constants::Fractal::INTERIOR_DERIVATIVE_THRESHOLD, -2 * derScale)
+                                  : 0;
+        // Brent's method : z is saved at the rebases of the powers of two, and compared at every rebase.
+        dex savedZr = dex::ZERO;
+        dex savedZi = dex::ZERO;
+        uint64_t rebases = 0;
+        uint64_t nextSave = 1;
+
+        // d = (fr + fi i) * d. The mantissa is bounded by the bailout, so it is rescaled only sometimes.
+        const auto multiplyDerivative = [&derR, &derI](const double fr, const double fi) {
+            const double nextDerR = fr * derR - fi * derI;
+            derI = fr * derI + fi * derR;
+            derR = nextDerR;
+        };
+
+        // dz/dz1 = d * 2^(derScale + e)
+        const auto rescaleDerivative = [&](const int e) {
+            int shift = e;
+            if (const double m = std::max(std::abs(derR), std::abs(derI));
+                m != 0 && (m > RESCALE_MAX || m < RESCALE_MIN)) {
+                const int exponent = std::ilogb(m) + 1;
+                derR = std::ldexp(derR, -exponent);
+                derI = std::ldexp(derI, -exponent);
+                shift += exponent;
+            }
+            if (shift != 0) {
+                derScale += shift;
+                derThreshold = std::ldexp(Constants::Fractal::INTERIOR_DERIVATIVE_THRESHOLD, -2 * derScale);
+            }
+        };
+
+        // d = (fr + fi i) * d, which is not bounded.
+        const auto multiplyDerivativeDex = [&multiplyDerivative, &rescaleDerivative](const dex &fr, const dex &fi) {
+            if (fr.sgn() == 0 && fi.sgn() == 0) {
+                multiplyDerivative(0, 0);
+                return;
+            }
+            const int e = std::max(exponentOf(fr), exponentOf(fi));
+            multiplyDerivative(scaledMantissa(fr, e), scaledMantissa(fi, e));
+            rescaleDerivative(e);
+        };
+
+        const auto suspend = [&] {
+            continuation = MandelbrotContinuation{
+                .dzr = scaledToDex(wr, scale), .dzi = scaledToDex(wi, scale),
+                .derR = scaledToDex(derR, derScale), .derI = scaledToDex(derI, derScale), .iteration = iteration,
+                .refIteration = refIteration, .cd = cd, .pd = pd
+            };
+        };
+
+        const auto isPeriodic = [&](const dex &zr, const dex &zi) {
+            if ((zr - savedZr) * (zr - savedZr) + (zi - savedZi) * (zi - savedZi) <
+                periodicityEpsilon * (zr * zr + zi * zi)) {
+                return true;
+            }
+            if (++rebases == nextSave) {
+                savedZr = zr;
+                savedZi = zi;
+                nextSave <<= 1;
+            }
+            return false;
+        };
+
+
+        // The pixel which escaped at the previous max iteration is not iterated again.
+        while (iteration < maxIteration && cd <= bailout2) {
+            // The delta is converted to dex only where the table can exist. No table starts from zero.
+            if (mpa && refIteration != 0 && tableDistance == 0) {
+                tableDistance = table->distanceToNextTable(refIteration);
+            }
+            if (mpa && refIteration != 0 && tableDistance == 0) {
+                dex dzr = scaledToDex(wr, scale);
+                dex dzi = scaledToDex(wi, scale);
+
+                if (const DeepPA::Entry *mpaPtr = RUNTIME
+                                                      ? table->lookup(refIteration, dzr, dzi, temps)
+                                                      : table->lookup<SELECTION, COMPRESSION>(refIteration, dzr, dzi, temps);
+                    mpaPtr != nullptr) {
+                    const DeepPA::Entry &mpa = *mpaPtr;
+                    const dex anr = mpa.anr();
+                    const dex ani = mpa.ani();
+                    const dex bnr = mpa.bnr();
+                    const dex bni = mpa.bni();
+
+                    dex::mul(&temps[0], anr, dzr);
+                    dex::mul(&temps[1], ani, dzi);
+                    dex::sub(&temps[0], temps[0], temps[1]);
+                    dex::mul(&temps[1], bnr, dcr1);
+                    dex::add(&temps[0], temps[0], temps[1]);
+                    dex::mul(&temps[1], bni, dci1);
+                    dex::sub(&temps[0], temps[0], temps[1]);
+                    dex::mul(&temps[1], anr, dzi);
+                    dex::mul(&temps[2], ani, dzr);
+                    dex::add(&temps[1], temps[1], temps[2]);
+                    dex::mul(&temps[2], bnr, dci1);
+                    dex::add(&temps[1], temps[1], temps[2]);
+                    dex::mul(&temps[2], bni, dcr1);
+                    dex::cpy(&dzr, temps[0]);
+                    dex::add(&dzi, temps[1], temps[2]);
+                    dex::normalize(&dzr);
+                    dex::normalize(&dzi);
+                    setDelta(dzr, dzi);
+
+                    if (interior) {
+                        multiplyDerivativeDex(anr, ani);
+                    }
+
+                    iteration += mpa.skip;
+                    refIteration += mpa.skip;
+                    ++absIteration;
+
+                    if (interior && derR * derR + derI * derI < derThreshold) {
+                        continuation.iteration = MandelbrotContinuation::INTERIOR;
+                        return static_cast<double>(maxIteration);
+                    }
+                    if (iteration >= maxIteration) {
+                        suspend();
+                        return static_cast<double>(isAbs ? absIteration : maxIteration);
+                    }
+                    continue;
+                }
+            }
+
+
+            if (refIteration != maxRefIteration) {
+                const uint64_t index = cursor.seek(refIteration);
+                // dz/dz1 = 2z * dz/dz1, from z1 because z0 is zero
+                const bool derivativeStep = interior && iteration > 0;
+
+                if (const auto [zr, zi] = doubleReference(index); zr != 0 || zi != 0) {
+                    if (derivativeStep) {
+                        multiplyDerivative(2 * (zr + s * wr), 2 * (zi + s * wi));
+                    }
+
+                    // dz = (2Z + dz) * dz + dc
+                    // -> w = (2Z + 2^scale * w) * w + u
+                    const double tr = zr + zr + s * wr;
+                    const double ti = zi + zi + s * wi;
+                    const double nwr = tr * wr - ti * wi + ur;
+                    const double nwi = tr * wi + ti * wr + ui;
+                    wr = nwr;
+                    wi = nwi;
+                } else if (const double mw = std::max(std::abs(wr), std::abs(wi)); index == 0 && (mw == 0 || mw >= RESCALE_MIN)) {
+                    // dz = dz^2 + dc
+                    // The square can be much smaller than the current scale, so it is computed on the scale of the result.
+                    if (derivativeStep) {
+                        multiplyDerivative(2 * wr, 2 * wi);
+                        rescaleDerivative(scale);
+                    }
+                    if (mw == 0) {
+                        wr = ur;
+                        wi = ui;
+                    } else {
+                        const int resultScale = std::max(2 * (scale + exponentOf(mw)), dcExponent);
+                        const double f = powerOfTwo(2 * scale - resultScale);
+                        const double nwr = (wr * wr - wi * wi) * f;
+                        const double nwi = 2 * wr * wi * f;
+                        setScale(resultScale);
+                        wr = nwr + ur;
+                        wi = nwi + ui;
+                    }
+                } else {
+                    // The reference is too small for double, so the square of the delta is not negligible.
+                    dex dzr = scaledToDex(wr, scale);
+                    dex dzi = scaledToDex(wi, scale);
+
+                    if (derivativeStep) {
+                        dex::add(&temps[0], reference->orbit.real(index), dzr);
+                        dex::add(&temps[1], reference->orbit.imag(index), dzi);
+                        dex::mul_2exp(&temps[0], temps[0], 1);
+                        dex::mul_2exp(&temps[1], temps[1], 1);
+                        multiplyDerivativeDex(temps[0], temps[1]);
+                    }
+
+                    if (index == 0) {
+                        dex::cpy(&temps[0], dzr);
+                        dex::cpy(&temps[1], dzi);
+                    } else {
+                        dex::mul_2exp(&temps[0], reference->orbit.real(index), 1);
+                        dex::mul_2exp(&temps[1], reference->orbit.imag(index), 1);
+                        dex::add(&temps[0], temps[0], dzr);
+                        dex::add(&temps[1], temps[1], dzi);
+                    }
+
+                    if (temps[0].sgn() == 0 && temps[1].sgn() == 0) {
+                        dex::cpy(&dzr, dcr1);
+                        dex::cpy(&dzi, dci1);
+                    } else {
+                        dex::mul(&temps[2], temps[0], dzr);
+                        dex::mul(&temps[3], temps[1], dzi);
+                        dex::sub(&temps[3], temps[2], temps[3]);
+                        dex::mul(&temps[2], temps[0], dzi);
+                        dex::mul(&temps[0], temps[1], dzr);
+                        dex::add(&temps[2], temps[2], temps[0]);
+                        dex::add(&dzr, temps[3], dcr1);
+                        dex::add(&dzi, temps[2], dci1);
+                    }
+                    dex::normalize(&dzr);
+                    dex::normalize(&dzi);
+                    setDelta(dzr, dzi);
+                }
+
+                ++refIteration;
+                ++iteration;
+                ++absIteration;
+                if (tableDistance > 0) {
+                    --tableDistance;
+                }
+            }
+
+            const uint64_t index = cursor.seek(refIteration);
+
+            if (const auto [zr0, zi0] = doubleReference(index); zr0 != 0 || zi0 != 0) {
+                const double dzr = s * wr;
+                const double dzi = s * wi;
+                const double zr = zr0 + dzr;
+                const double zi = zi0 + dzi;
+
+                // Ignore the zero made by the underflow of the delta.
+                if (zi == 0 && (dzi != 0 || wi == 0) && zr >= -2 && zr <= 0.25) {
+                    //IT IS NOT SATISFIED MPA SKIP RADIUS CONDITION.
+                    //WHEN THE MAX ITERATION IS HIGH, REPEATS SEMI-INFINITELY.
+                    continuation.iteration = MandelbrotContinuation::INTERIOR;
+                    return static_cast<double>(maxIteration);
+                }
+
+                pd = cd;
+                cd = zr * zr + zi * zi;
+
+                if (refIteration == maxRefIteration || cd < dzr * dzr + dzi * dzi) {
+                    if (periodicityDetection && isPeriodic(dex::value(zr), dex::value(zi))) {
+                        continuation.iteration = MandelbrotContinuation::INTERIOR;
+                        return static_cast<double>(maxIteration);
+                    }
+                    refIteration = 0;
+                    tableDistance = 0;
+                    setDelta(dex::value(zr), dex::value(zi));
+                }
+            } else {
+                const dex dzr = scaledToDex(wr, scale);
+                const dex dzi = scaledToDex(wi, scale);
+                dex zr = reference->orbit.real(index) + dzr;
+                dex zi = reference->orbit.imag(index) + dzi;
+                dex::normalize(&zr);
+                dex::normalize(&zi);
+
+                dex::sub(&temps[0], zr, zrMin);
+                dex::sub(&temps[1], zrMax, zr);
+
+                if (zi.sgn() == 0 && temps[0].sgn() != -1 && temps[1].sgn() != -1) {
+                    continuation.iteration = MandelbrotContinuation::INTERIOR;
+                    return static_cast<double>(maxIteration);
+                }
+
+                const auto zrValue = static_cast<double>(zr);
+                const auto ziValue = static_cast<double>(zi);
+
+                pd = cd;
+                cd = zrValue * zrValue + ziValue * ziValue;
+
+                if (refIteration == maxRefIteration || zr * zr + zi * zi < dzr * dzr + dzi * dzi) {
+                    if (periodicityDetection && isPeriodic(zr, zi)) {
+                        continuation.iteration = MandelbrotContinuation::INTERIOR;
+                        return static_cast<double>(maxIteration);
+                    }
+                    refIteration = 0;
+                    tableDistance = 0;
+                    setDelta(zr, zi);
+                }
+            }
+
+            if (cd > bailout2) break;
+            if (interior && absIteration % Constants::Fractal::INTERIOR_CHECK_INTERVAL == 0) {
+                rescaleDerivative(0);
+                if (derR * derR + derI * derI < derThreshold) {
+                    continuation.iteration = MandelbrotContinuation::INTERIOR;
+                    return static_cast<double>(maxIteration);
+                }
+            }
+
+            // Rescale only when the mantissa leaves the safe range.
+            if (const double m = std::max({std::abs(wr), std::abs(wi), uMax});
+                m > RESCALE_MAX || (m < RESCALE_MIN && m != 0)) {
+                const int e = std::ilogb(m) + 1;
+                wr = std::ldexp(wr, -e);
+                wi = std::ldexp(wi, -e);
+                setScale(scale + e);
+            }
+
+            if (absIteration % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 && state.interruptRequested()) return 0.0;
+        }
+
+        if (iteration >= maxIteration) {
+            suspend();
+            return static_cast<double>(isAbs ? absIteration : maxIteration);
+        }
+
+        continuation.iteration = MandelbrotContinuation::ESCAPED;
+
+        if (isAbs) {
+            return absIteration;
+        }
+
+        const double fpd = sqrt(pd);
+        const double fcd = sqrt(cd);
+
+        return getDoubleValueIteration(iteration, fpd, fcd, calc.decimalizeIterationMethod, bailout);
+    }
+
+
+    void ScaledMandelbrotPerturbator::approximateSeries(const std::span<const std::array<dex, 2> > probes) {
+        series = SeriesApproximation::create(state, *reference, calc, probes, offR, offI);
+    }
+
+    std::unique_ptr<ScaledMandelbrotPerturbator> ScaledMandelbrotPerturbator::reuse(
+        const FractalAttribute &calc, const dex &dcMax, ApproxTableCache &tableRef) {
+        dex offR = dex::ZERO;
+        dex offI = dex::ZERO;
+        uint64_t longestPeriod = 1;
+        std::unique_ptr<DeepMandelbrotReference> reusedReference = nullptr;
+
+        const int exp10 = logZoomToExp10(calc.logZoom);
+
+        if (reference == Constants::NullPointer::PROCESS_TERMINATED_REFERENCE) {
+            //try to use process-terminated reference
+            MessageBox(nullptr, "Please do not try to use PROCESS-TERMINATED Reference.", "Warning",
+                       MB_OK | MB_ICONWARNING);
+        } else {
+            fp_complex_calculator centerOffset = calc.center.edit(exp10);
+            centerOffset -= reference->center.edit(exp10);
+            centerOffset.getReal().double_exp_value(&offR);
+            centerOffset.getImag().double_exp_value(&offI);
+            longestPeriod = reference->longestPeriod();
+            reusedReference = std::move(reference);
+        }
+
+
+        return std::make_unique<ScaledMandelbrotPerturbator>(state, calc, dcMax, exp10, longestPeriod,
+                                                             tableRef,
+                                                             [](uint64_t) {
+                                                                 //no action because the reference is already declared
+                                                             }, [](uint64_t, double) {
+                                                                 //same reason
+                                                             }, false, std::move(reusedReference),
+                                                             std::move(table), offR, offI);
+    }
+
+    std::unique_ptr<DeepMandelbrotPerturbator> ScaledMandelbrotPerturbator::toDeep(ApproxTableCache &tableRef) {
+        const uint64_t longestPeriod = reference->longestPeriod();
+        return std::make_unique<DeepMandelbrotPerturbator>(state, calc, dcMax, logZoomToExp10(calc.logZoom), longestPeriod,
+                                                           tableRef,
+                                                           [](uint64_t) {
+                                                               //no action because the reference is already declared
+                                                           }, [](uint64_t, double) {
+                                                               //same reason
+                                                           }, false, std::move(reference),
+                                                           std::move(table), offR, offI);
+    }
+
+    bool ScaledMandelbrotPerturbator::isFasterThanDeep(const float logZoom, const DeepMPATable &table) {
+        return table.mpaPeriod == nullptr || logZoom <= Constants::Fractal::SCALED_MAX_ZOOM_WITH_MPA;
+    }
+}
@@ -0,0 +1,120 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include "DeepMandelbrotPerturbator.h"
+#include "DeepMandelbrotReference.h"
+#include "MandelbrotKernelTable.h"
+#include "MandelbrotPerturbator.h"
+#include "../mrthy/DeepMPATable.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Scaled Mandelbrot Perturbator</b>
+     * <br/>
+     * The perturbator between the light and the deep one. It uses the deep reference and table,
+     * but iterates the delta as the double mantissa with the shared exponent (rescaled iteration).
+     * <li> dz = w * 2^scale, dc = u * 2^scale, then w' = (2Z + 2^scale * w) * w + u </li>
+     * <li> The exponent is changed only when w leaves the safe range, so most iterations are plain double operations.</li>
+     * <li> The reference is bounded by the bailout, so it is read as double from the deep orbit. Only the reference too small for double uses the dex operations.</li>
+     */
+    class ScaledMandelbrotPerturbator final : public MandelbrotPerturbator {
+        std::unique_ptr<DeepMandelbrotReference> reference = nullptr;
+        std::unique_ptr<DeepMPATable> table = nullptr;
+        MandelbrotKernelTable<ScaledMandelbrotPerturbator>::Kernel kernel = nullptr;
+
+        const dex dcMax;
+        const dex offR;
+        const dex offI;
+
+    public:
+        static constexpr double RESCALE_MAX = 0x1p256;
+        static constexpr double RESCALE_MIN = 0x1p-256;
+        static constexpr double SMALL_REFERENCE = 0x1p-500;
+
+        explicit ScaledMandelbrotPerturbator(ParallelRenderState &state, const FractalAttribute &calc,
+                                             const dex &dcMax, int exp10,
+                                             uint64_t initialPeriod, ApproxTableCache &tableRef,
+                                             std::function<void(uint64_t)> &&actionPerRefCalcIteration,
+                                             std::function<void(uint64_t, double)> &&actionPerCreatingTableIteration,
+                                             bool arbitraryPrecisionFPGBn = false,
+                                             std::unique_ptr<DeepMandelbrotReference> reusedReference = nullptr,
+                                             std::unique_ptr<DeepMPATable> reusedTable = nullptr,
+                                             const dex &offR = dex::ZERO, const dex &offI = dex::ZERO);
+
+
+        [[nodiscard]] double iterate(const dex &dcr, const dex &dci) const override;
+
+        [[nodiscard]] double iterate(const dex &dcr, const dex &dci, MandelbrotContinuation &continuation) const override;
+
+        /**
+         * Replaces the specialized kernel with the RUNTIME kernel, which dispatches the settings in the loop. <br/>
+         * It is the baseline of the kernel benchmark, and is never used for rendering.
+         */
+        void useRuntimeKernel();
+
+        std::unique_ptr<ScaledMandelbrotPerturbator> reuse(const FractalAttribute &calc, const dex &dcMax,
+                                                           ApproxTableCache &tableRef);
+
+        /**
+         * Moves the reference and the table into the deep perturbator, without creating them again.
+         */
+        std::unique_ptr<DeepMandelbrotPerturbator> toDeep(ApproxTableCache &tableRef);
+
+        /**
+         * Whether this perturbator is faster than the deep one for the frame.
+         * <li> Without the MPA, the rescaled double is about 4-5x faster at every zoom.</li>
+         * <li> With the MPA, it is about 2x faster up to @code SCALED_MAX_ZOOM_WITH_MPA@endcode.
+         * Beyond it, the orbit rebases every few iterations, and the dex conversions around the table lookups make it slower.</li>
+         * @param logZoom the zoom of the frame
+         * @param table the table of the reference
+         */
+        [[nodiscard]] static bool isFasterThanDeep(float logZoom, const DeepMPATable &table);
+
+        [[nodiscard]] const DeepMandelbrotReference *getReference() const override;
+
+        [[nodiscard]] DeepMPATable &getTable() const;
+
+        [[nodiscard]] dex getDcMaxAsDoubleExp() const override;
+
+        void approximateSeries(std::span<const std::array<dex, 2> > probes) override;
+
+    private:
+        /**
+         * Reads the reference of the index as double, from the packed record of the deep orbit.
+         * The values smaller than @code SMALL_REFERENCE@endcode are read as zero,
+         * to mark that their iteration must use the dex operations.
+         */
+        [[nodiscard]] std::array<double, 2> doubleReference(uint64_t index) const;
+
+        friend class MandelbrotKernelTable<ScaledMandelbrotPerturbator>;
+
+        /**
+         * The iteration of a pixel, which is specialized for the settings of the frame.
+         * The RUNTIME kernel ignores the other parameters, and tests the settings in the loop instead.
+         * @see MandelbrotKernelTable
+         */
+        template<bool INTERIOR, bool MPA, FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION, bool RUNTIME = false>
+        double iterateKernel(const dex &dcr, const dex &dci, MandelbrotContinuation &continuation) const;
+    };
+
+    // DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR
+    // DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR
+    // DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR
+    // DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR
+    // DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR  DEFINITION OF SCALED MANDELBROT PERTURBATOR
+
+
+    inline const DeepMandelbrotReference *ScaledMandelbrotPerturbator::getReference() const {
+        return reference.get();
+    }
+
+    inline DeepMPATable &ScaledMandelbrotPerturbator::getTable() const {
+        return *table;
+    }
+
+    inline dex ScaledMandelbrotPerturbator::getDcMaxAsDoubleExp() const {
+        return dcMax;
+    }
+}
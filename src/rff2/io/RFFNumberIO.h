@@ -0,0 +1,112 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <algorithm>
+#include <fstream>
+#include <type_traits>
+
+#include "../calc/fp_decimal_calculator.h"
+#include "../calc/fp_fixed.h"
+#include "../ui/IOUtilities.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Number IO</b>
+     * <br/>
+     * Writes the numbers of the reference in their memory representation, to read them back exactly.
+     * They are only for the files of this machine, such as the checkpoints and the caches.
+     */
+    struct RFFNumberIO {
+        RFFNumberIO() = delete;
+
+        static void writeFixed(std::ofstream &out, const fp_fixed &value);
+
+        /**
+         * @return whether the value is read. It fails when the stored size is not the size of the value.
+         */
+        static bool readFixed(std::ifstream &in, fp_fixed &value);
+
+        static void writeDecimal(std::ofstream &out, const fp_decimal_calculator &value);
+
+        /**
+         * @return whether the value is read. It fails when the stored precision is not the precision of the value.
+         */
+        static bool readDecimal(std::ifstream &in, fp_decimal_calculator &value);
+
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        static void writeRaw(std::ofstream &out, const T &value);
+
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        static void readRaw(std::ifstream &in, T *value);
+
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        static void writeRaw(std::ofstream &out, const T *values, uint64_t count);
+
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        static void readRaw(std::ifstream &in, T *values, uint64_t count);
+    };
+
+    inline void RFFNumberIO::writeFixed(std::ofstream &out, const fp_fixed &value) {
+        IOUtilities::encodeAndWrite(out, static_cast<uint64_t>(value.size()));
+        IOUtilities::encodeAndWrite(out, value.negative);
+        writeRaw(out, value.limbs.data(), value.limbs.size());
+    }
+
+    inline bool RFFNumberIO::readFixed(std::ifstream &in, fp_fixed &value) {
+        uint64_t size = 0;
+        IOUtilities::readAndDecode(in, &size);
+        if (!in || size != static_cast<uint64_t>(value.size())) {
+            return false;
+        }
+        IOUtilities::readAndDecode(in, &value.negative);
+        readRaw(in, value.limbs.data(), value.limbs.size());
+        return static_cast<bool>(in);
+    }
+
+    inline void RFFNumberIO::writeDecimal(std::ofstream &out, const fp_decimal_calculator &value) {
+        const size_t size = mpz_size(value.value);
+        IOUtilities::encodeAndWrite(out, value.exp2);
+        IOUtilities::encodeAndWrite(out, mpz_sgn(value.value));
+        IOUtilities::encodeAndWrite(out, static_cast<uint64_t>(size));
+        writeRaw(out, mpz_limbs_read(value.value), size);
+    }
+
+    inline bool RFFNumberIO::readDecimal(std::ifstream &in, fp_decimal_calculator &value) {
+        int exp2 = 0;
+        int sign = 0;
+        uint64_t size = 0;
+        IOUtilities::readAndDecode(in, &exp2);
+        IOUtilities::readAndDecode(in, &sign);
+        IOUtilities::readAndDecode(in, &size);
+        if (!in || exp2 != value.exp2) {
+            return false;
+        }
+        mp_limb_t *limbs = mpz_limbs_write(value.value, static_cast<mp_size_t>(std::max<uint64_t>(size, 1)));
+        readRaw(in, limbs, size);
+        const auto length = static_cast<mp_size_t>(size);
+        mpz_limbs_finish(value.value, sign < 0 ? -length : length);
+        return static_cast<bool>(in);
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    void RFFNumberIO::writeRaw(std::ofstream &out, const T &value) {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    void RFFNumberIO::readRaw(std::ifstream &in, T *value) {
+        in.read(reinterpret_cast<char *>(value), sizeof(T));
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    void RFFNumberIO::writeRaw(std::ofstream &out, const T *values, const uint64_t count) {
+        out.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(T)));
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    void RFFNumberIO::readRaw(std::ifstream &in, T *values, const uint64_t count) {
+        in.read(reinterpret_cast<char *>(values), static_cast<std::streamsize>(count * sizeof(T)));
+    }
+}
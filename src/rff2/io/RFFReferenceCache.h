@@ -0,0 +1,421 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../vulkan_helper/core/logger.hpp"
+#include "../attr/FractalAttribute.h"
+#include "../calc/fp_fixed_complex.h"
+#include "../constants/Constants.hpp"
+#include "../data/ApproxTableCache.h"
+#include "../formula/DeepMandelbrotReference.h"
+#include "../formula/LightMandelbrotReference.h"
+#include "RFFNumberIO.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Reference Cache</b>
+     * <br/>
+     * Keeps the completed references and their MPA tables in the work directory, to skip them when the same location is rendered again.
+     * e.g. the other resolution, the other shader settings, or the next launch.
+     * <li> The file is named by the hash of the key. The key is the exact center, the precision, maxIteration and the settings which change the reference or the table.</li>
+     * <li> The table is also decided by dcMax, but it is valid for any smaller dcMax. dcMax is stored and compared instead of being keyed,
+     * because it changes slightly with the resolution.</li>
+     * <li> All sections of the file are the arrays in the memory representation, and they are aligned by 8 bytes.
+     * The table is written as the offsets of each table index and the PA records, same as @code CompactPATable@endcode.</li>
+     * <li> The files which are not used recently are removed when the total size exceeds the capacity.</li>
+     */
+    class RFFReferenceCache final {
+        static constexpr uint32_t VERSION = 1;
+        static constexpr auto ENTRY_EXTENSION = L".bin";
+        static constexpr auto ENTRY_TEMP_EXTENSION = L".tmp";
+        static constexpr uint64_t ORBIT_BUFFER_SIZE = 65536;
+
+        template<typename Ref>
+        using Num = std::conditional_t<std::is_same_v<Ref, LightMandelbrotReference>, double, dex>;
+
+        std::filesystem::path directory;
+        uint64_t capacity;
+
+    public:
+        explicit RFFReferenceCache(std::filesystem::path directory, uint64_t capacity);
+
+        /**
+         * Creates the cache of the references.
+         * @param calc calculation settings
+         * @return the cache, or @code nullptr@endcode if it is disabled
+         */
+        static std::unique_ptr<RFFReferenceCache> create(const FractalAttribute &calc);
+
+        /**
+         * Reads the reference of the location, and restores its table to the table cache.
+         * Nothing is changed if there is no entry which can be used.
+         * @tparam Ref @code LightMandelbrotReference@endcode or @code DeepMandelbrotReference@endcode
+         * @param calc calculation settings
+         * @param exp10 the exponent of 10 for arbitrary-precision operation
+         * @param dcMax the length of center-to-vertex of screen.
+         * @param tableRef the table cache to restore
+         * @return the reference, or @code nullptr@endcode
+         */
+        template<typename Ref>
+        std::unique_ptr<Ref> load(const FractalAttribute &calc, int exp10, const Num<Ref> &dcMax,
+                                  ApproxTableCache &tableRef) const;
+
+        /**
+         * Writes the completed reference and its table, and removes the old entries exceeding the capacity.
+         */
+        template<typename Ref>
+        void store(const FractalAttribute &calc, int exp10, const Num<Ref> &dcMax,
+                   const Ref &reference, const ApproxTableCache &tableRef) const;
+
+    private:
+        template<typename Ref>
+        static std::vector<char> createKey(const FractalAttribute &calc, int exp10);
+
+        static std::filesystem::path entryName(const std::vector<char> &key);
+
+        void evict() const;
+    };
+
+    // DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE
+    // DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE
+    // DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE
+    // DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE  DEFINITION OF REFERENCE CACHE
+
+
+    inline RFFReferenceCache::RFFReferenceCache(std::filesystem::path directory, const uint64_t capacity) :
+        directory(std::move(directory)), capacity(capacity) {
+    }
+
+    inline std::unique_ptr<RFFReferenceCache> RFFReferenceCache::create(const FractalAttribute &calc) {
+        if (calc.referenceCacheCapacity == 0) {
+            return nullptr;
+        }
+        return std::make_unique<RFFReferenceCache>(
+            std::filesystem::temp_directory_path() / Constants::Fractal::REFERENCE_CACHE_DIRECTORY,
+            static_cast<uint64_t>(calc.referenceCacheCapacity) << 20);
+    }
+
+    template<typename Ref>
+    std::unique_ptr<Ref> RFFReferenceCache::load(const FractalAttribute &calc, const int exp10,
+                                                 const Num<Ref> &dcMax,
+                                                 ApproxTableCache &tableRef) const {
+        using T = Num<Ref>;
+        constexpr bool light = std::is_same_v<Ref, LightMandelbrotReference>;
+        using PAB = std::conditional_t<light, LightPA, DeepPA>;
+
+        const auto key = createKey<Ref>(calc, exp10);
+        const auto path = directory / entryName(key);
+        std::ifstream in(path, std::ios::in | std::ios::binary);
+        if (!in.is_open()) {
+            return nullptr;
+        }
+
+        uint64_t len = 0;
+        IOUtilities::readAndDecode(in, &len);
+        if (!in || len != key.size()) {
+            return nullptr;
+        }
+        auto storedKey = std::vector<char>(len);
+        IOUtilities::readAndDecode(in, len, storedKey.data());
+        in.seekg(static_cast<std::streamoff>((8 - len % 8) % 8), std::ios::cur);
+        if (!in || storedKey != key) {
+            return nullptr;
+        }
+
+        T storedDcMax;
+        uint64_t orbitLength = 0;
+        uint64_t toolsLength = 0;
+        uint64_t periodLength = 0;
+        uint64_t tableLength = 0;
+        uint64_t paLength = 0;
+        RFFNumberIO::readRaw(in, &storedDcMax);
+        IOUtilities::readAndDecode(in, &orbitLength);
+        IOUtilities::readAndDecode(in, &toolsLength);
+        IOUtilities::readAndDecode(in, &periodLength);
+        IOUtilities::readAndDecode(in, &tableLength);
+        IOUtilities::readAndDecode(in, &paLength);
+        if (!in) {
+            return nullptr;
+        }
+
+        // the table is too small for the larger screen.
+        if constexpr (light) {
+            if (dcMax > storedDcMax) {
+                return nullptr;
+            }
+        } else {
+            T difference;
+            dex::sub(&difference, storedDcMax, dcMax);
+            if (difference.sgn() < 0) {
+                return nullptr;
+            }
+        }
+
+        auto fpgReference = fp_complex_calculator(0, 0, exp10);
+        auto fpgBn = fp_complex_calculator(0, 0, exp10);
+        if (!RFFNumberIO::readDecimal(in, fpgReference.getReal()) ||
+            !RFFNumberIO::readDecimal(in, fpgReference.getImag()) ||
+            !RFFNumberIO::readDecimal(in, fpgBn.getReal()) || !RFFNumberIO::readDecimal(in, fpgBn.getImag())) {
+            return nullptr;
+        }
+
+        // The reference packs the parts of the orbit into its store when it is created.
+        using Orbit = std::conditional_t<light, ReferenceOrbitStore::Part, DeepReferenceOrbitStore::Part>;
+        auto rr = Orbit(SegmentStorage(calc.referenceStorageMethod, calc.scratchDirectory));
+        auto ri = Orbit(SegmentStorage(calc.referenceStorageMethod, calc.scratchDirectory));
+        auto buffer = std::vector<T>(ORBIT_BUFFER_SIZE);
+        for (auto *orbit: {&rr, &ri}) {
+            for (uint64_t i = 0; i < orbitLength && in; i += ORBIT_BUFFER_SIZE) {
+                const uint64_t count = std::min(ORBIT_BUFFER_SIZE, orbitLength - i);
+                RFFNumberIO::readRaw(in, buffer.data(), count);
+                for (uint64_t j = 0; j < count; ++j) {
+                    orbit->push_back(buffer[j]);
+                }
+            }
+        }
+
+        auto tools = std::vector<ArrayCompressionTool>();
+        tools.reserve(toolsLength);
+        for (uint64_t i = 0; i < toolsLength; ++i) {
+            uint64_t rebase, start, end;
+            IOUtilities::readAndDecode(in, &rebase);
+            IOUtilities::readAndDecode(in, &start);
+            IOUtilities::readAndDecode(in, &end);
+            tools.emplace_back(rebase, start, end);
+        }
+
+        auto period = std::vector<uint64_t>(periodLength);
+        RFFNumberIO::readRaw(in, period.data(), periodLength);
+
+        // The table is read aside, so the table cache is kept when the entry turns out to be broken.
+        auto table = CompactPATable<PAB, T>(tableRef.storage);
+        table.offsets.resize(tableLength + 1);
+        RFFNumberIO::readRaw(in, table.offsets.data(), table.offsets.size());
+        if (!in || table.offsets.back() != paLength) {
+            return nullptr;
+        }
+
+        table.pas.reserve(paLength);
+        table.bounds.reserve(paLength);
+        for (uint64_t i = 0; i < paLength && in; ++i) {
+            uint64_t skip;
+            T anr, ani, bnr, bni, radius;
+            RFFNumberIO::readRaw(in, &skip);
+            RFFNumberIO::readRaw(in, &anr);
+            RFFNumberIO::readRaw(in, &ani);
+            RFFNumberIO::readRaw(in, &bnr);
+            RFFNumberIO::readRaw(in, &bni);
+            RFFNumberIO::readRaw(in, &radius);
+            table.add(PAB(anr, ani, bnr, bni, skip, radius));
+        }
+
+        if (!in) {
+            return nullptr;
+        }
+        in.close();
+
+        if constexpr (light) {
+            tableRef.lightTable = std::move(table);
+        } else {
+            tableRef.deepTable = std::move(table);
+        }
+
+        // recently used
+        std::error_code error;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+        return std::make_unique<Ref>(fp_complex(calc.center), std::move(rr), std::move(ri), std::move(tools),
+                                     std::move(period), fp_complex(fpgReference), fp_complex(fpgBn));
+    }
+
+    template<typename Ref>
+    void RFFReferenceCache::store(const FractalAttribute &calc, const int exp10,
+                                  const Num<Ref> &dcMax, const Ref &reference,
+                                  const ApproxTableCache &tableRef) const {
+        using T = Num<Ref>;
+        constexpr bool light = std::is_same_v<Ref, LightMandelbrotReference>;
+
+        const auto key = createKey<Ref>(calc, exp10);
+        const auto *table = [&tableRef] {
+            if constexpr (light) {
+                return &tableRef.lightTable;
+            } else {
+                return &tableRef.deepTable;
+            }
+        }();
+        const uint64_t tableLength = table->size();
+        const uint64_t paLength = table->pas.size();
+
+        try {
+            std::filesystem::create_directories(directory);
+            const auto name = entryName(key);
+            const auto tempPath = directory / name.stem().concat(ENTRY_TEMP_EXTENSION);
+
+            if (std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc); out.is_open()) {
+                constexpr uint64_t padding = 0;
+                IOUtilities::encodeAndWrite(out, static_cast<uint64_t>(key.size()));
+                IOUtilities::encodeAndWrite(out, key.data(), key.size());
+                RFFNumberIO::writeRaw(out, reinterpret_cast<const char *>(&padding), (8 - key.size() % 8) % 8);
+
+                RFFNumberIO::writeRaw(out, dcMax);
+                IOUtilities::encodeAndWrite(out, static_cast<uint64_t>(reference.length()));
+                IOUtilities::encodeAndWrite(out, static_cast<uint64_t>(reference.compressor.size()));
+                IOUtilities::encodeAndWrite(out, static_cast<uint64_t>(reference.period.size()));
+                IOUtilities::encodeAndWrite(out, tableLength);
+                IOUtilities::encodeAndWrite(out, paLength);
+
+                const auto fpgReference = reference.fpgReference.edit(exp10);
+                const auto fpgBn = reference.fpgBn.edit(exp10);
+                RFFNumberIO::writeDecimal(out, fpgReference.getRealClone());
+                RFFNumberIO::writeDecimal(out, fpgReference.getImagClone());
+                RFFNumberIO::writeDecimal(out, fpgBn.getRealClone());
+                RFFNumberIO::writeDecimal(out, fpgBn.getImagClone());
+
+                if constexpr (light) {
+                    auto buffer = std::vector<T>(ORBIT_BUFFER_SIZE);
+                    const auto &orbit = reference.orbit;
+                    for (const auto part: {&ReferenceOrbitStore::Pair::real, &ReferenceOrbitStore::Pair::imag}) {
+                        for (uint64_t i = 0; i < orbit.size(); i += ORBIT_BUFFER_SIZE) {
+                            const uint64_t count = std::min<uint64_t>(ORBIT_BUFFER_SIZE, orbit.size() - i);
+                            for (uint64_t j = 0; j < count; ++j) {
+                                buffer[j] = orbit[i + j].*part;
+                            }
+                            RFFNumberIO::writeRaw(out, buffer.data(), count);
+                        }
+                    }
+                } else {
+                    auto buffer = std::vector<T>(ORBIT_BUFFER_SIZE);
+                    const auto &orbit = reference.orbit;
+                    for (const auto part: {&DeepReferenceOrbitStore::real, &DeepReferenceOrbitStore::imag}) {
+                        for (uint64_t i = 0; i < orbit.size(); i += ORBIT_BUFFER_SIZE) {
+                            const uint64_t count = std::min<uint64_t>(ORBIT_BUFFER_SIZE, orbit.size() - i);
+                            for (uint64_t j = 0; j < count; ++j) {
+                                buffer[j] = (orbit.*part)(i + j);
+                            }
+                            RFFNumberIO::writeRaw(out, buffer.data(), count);
+                        }
+                    }
+                }
+
+                for (const auto &tool: reference.compressor) {
+                    IOUtilities::encodeAndWrite(out, tool.rebase);
+                    IOUtilities::encodeAndWrite(out, tool.start);
+                    IOUtilities::encodeAndWrite(out, tool.end);
+                }
+                RFFNumberIO::writeRaw(out, reference.period.data(), reference.period.size());
+                if (tableLength == 0) {
+                    IOUtilities::encodeAndWrite(out, paLength);
+                } else {
+                    RFFNumberIO::writeRaw(out, table->offsets.data(), table->offsets.size());
+                }
+                // The entries are unpacked, so the records are the same as the generated PAs.
+                for (uint64_t j = 0; j < paLength; ++j) {
+                    const auto &pa = table->pas[j];
+                    RFFNumberIO::writeRaw(out, static_cast<uint64_t>(pa.skip));
+                    if constexpr (light) {
+                        RFFNumberIO::writeRaw(out, pa.anr);
+                        RFFNumberIO::writeRaw(out, pa.ani);
+                        RFFNumberIO::writeRaw(out, pa.bnr);
+                        RFFNumberIO::writeRaw(out, pa.bni);
+                    } else {
+                        RFFNumberIO::writeRaw(out, pa.anr());
+                        RFFNumberIO::writeRaw(out, pa.ani());
+                        RFFNumberIO::writeRaw(out, pa.bnr());
+                        RFFNumberIO::writeRaw(out, pa.bni());
+                    }
+                    RFFNumberIO::writeRaw(out, table->radius(j));
+                }
+                out.close();
+                if (!out) {
+                    vkh::logger::w_log(L"ERROR : Cannot save reference cache");
+                    std::filesystem::remove(tempPath);
+                    return;
+                }
+            } else {
+                vkh::logger::w_log(L"ERROR : Cannot save reference cache");
+                return;
+            }
+            std::filesystem::rename(tempPath, directory / name);
+            evict();
+        } catch (const std::filesystem::filesystem_error &) {
+            vkh::logger::w_log(L"ERROR : Cannot save reference cache");
+        }
+    }
+
+    template<typename Ref>
+    std::vector<char> RFFReferenceCache::createKey(const FractalAttribute &calc, const int exp10) {
+        using T = Num<Ref>;
+        const auto &[compressCriteria, compressionThresholdPower, noCompressorNormalization] = calc.referenceCompAttribute;
+        const auto &[minSkipReference, maxMultiplierBetweenLevel, epsilonPower, mpaSelectionMethod,
+            mpaCompressionMethod, seriesApproximationTerms] = calc.mpaAttribute;
+        const auto c = fp_fixed_complex(calc.center.edit(exp10), fp_fixed::exp10ToSize(exp10));
+
+        auto key = std::vector<char>();
+        const auto append = [&key]<typename U>(const U &value) {
+            const auto arr = IOUtilities::toBinaryArray(value);
+            key.insert(key.end(), arr.begin(), arr.end());
+        };
+        append(VERSION);
+        append(sizeof(T));
+        append(exp10);
+        append(calc.maxIteration);
+        append(calc.bailout);
+        append(compressCriteria);
+        append(compressionThresholdPower);
+        append(noCompressorNormalization);
+        append(minSkipReference);
+        append(maxMultiplierBetweenLevel);
+        append(epsilonPower);
+        append(static_cast<int>(mpaSelectionMethod));
+        append(static_cast<int>(mpaCompressionMethod));
+        // seriesApproximationTerms is not keyed, since the series is created for each frame.
+        for (const fp_fixed *part: {&c.getReal(), &c.getImag()}) {
+            append(part->negative);
+            for (const mp_limb_t limb: part->limbs) {
+                append(limb);
+            }
+        }
+        return key;
+    }
+
+    inline std::filesystem::path RFFReferenceCache::entryName(const std::vector<char> &key) {
+        // FNV-1a
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const char k: key) {
+            hash = (hash ^ static_cast<uint8_t>(k)) * 0x100000001b3ULL;
+        }
+        return std::format(L"{:016x}{}", hash, ENTRY_EXTENSION);
+    }
+
+    inline void RFFReferenceCache::evict() const {
+        auto entries = std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path> >();
+        uint64_t total = 0;
+        std::error_code error;
+        for (const auto &entry: std::filesystem::directory_iterator(directory, error)) {
+            if (entry.path().extension() != ENTRY_EXTENSION) {
+                continue;
+            }
+            total += entry.file_size(error);
+            entries.emplace_back(entry.last_write_time(error), entry.path());
+        }
+        std::ranges::sort(entries);
+        for (const auto &[time, path]: entries) {
+            if (total <= capacity) {
+                break;
+            }
+            const uint64_t size = std::filesystem::file_size(path, error);
+            if (std::filesystem::remove(path, error)) {
+                total -= size;
+            }
+        }
+    }
+}
@@ -0,0 +1,501 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../../vulkan_helper/core/logger.hpp"
+#include "../attr/FractalAttribute.h"
+#include "../calc/fp_complex_calculator.h"
+#include "../calc/fp_fixed_complex.h"
+#include "../constants/Constants.hpp"
+#include "../mrthy/ArrayCompressionTool.h"
+#include "../mrthy/SegmentStorage.h"
+#include "RFFNumberIO.h"
+#include "../ui/IOUtilities.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Reference Checkpoint</b>
+     * <br/>
+     * Writes the state of the reference loop to the scratch directory periodically, and when the reference is cancelled after a long run.
+     * The next reference of the same key resumes from it.
+     * <li> The directory is named by the hash of the key. The key is the exact center, the precision, and the settings which change the orbit.</li>
+     * <li> maxIteration, initialPeriod and dcMax only decide where the loop stops. They are checked when resuming instead of being keyed.</li>
+     * <li> The orbit file is a sequence of records, which are the start index and the entries from it.
+     * Each checkpoint appends the entries from the first one overwritten by the compression since the last checkpoint.</li>
+     * <li> The state refers to the generation of the orbit file and its committed length, so the renaming of the state commits both.
+     * The bytes after the committed length are discarded, and the orbit is rewritten to the next generation when the records grow too long.</li>
+     * <li> The checkpoints which are not used recently are removed when the total size exceeds the capacity.</li>
+     * @tparam T the type of the orbit. @code double@endcode or @code dex@endcode
+     */
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    class RFFReferenceCheckpoint final {
+        static constexpr uint32_t VERSION = 2;
+        static constexpr auto STATE_FILE = L"state.bin";
+        static constexpr auto STATE_TEMP_FILE = L"state.tmp";
+        static constexpr auto ORBIT_FILE_PREFIX = L"orbit.";
+        static constexpr uint64_t ORBIT_BUFFER_SIZE = 65536;
+        static constexpr uint64_t ORBIT_RECORD_HEADER = sizeof(uint64_t) * 2;
+        static constexpr uint64_t ORBIT_ENTRY_SIZE = sizeof(T) * 2;
+
+    public:
+        /**
+         * The variables of the reference loop at the start of an iteration.
+         */
+        struct State {
+            uint64_t iteration;
+            uint64_t reuseIndex;
+            uint64_t compressed;
+            bool canReuse;
+            T zr;
+            T zi;
+            T fpgBnr;
+            T fpgBni;
+            T minZRadius;
+            /**
+             * The minimum of @code |z|^2 / |fpgBn|@endcode so far. The loop stops earlier when dcMax is not lower than it.
+             */
+            T fpgMargin;
+            std::vector<uint64_t> periodArray;
+            std::vector<ArrayCompressionTool> tools;
+        };
+
+    private:
+        std::filesystem::path root;
+        std::filesystem::path directory;
+        std::vector<char> key;
+        std::chrono::seconds interval;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point lastSaved;
+        uint64_t savedLength = 0;
+        uint64_t dirtyFrom = 0;
+        uint64_t generation = 0;
+        uint64_t orbitBytes = 0;
+        bool owned = false;
+
+    public:
+        explicit RFFReferenceCheckpoint(std::filesystem::path root, std::vector<char> &&key, uint32_t intervalSeconds);
+
+        /**
+         * Creates the checkpoint of the reference.
+         * @param calc calculation settings
+         * @param exp10 the exponent of 10 for arbitrary-precision operation
+         * @param strictFPG use arbitrary-precision operation for fpg_bn calculation
+         * @param c the center
+         * @return the checkpoint, or @code nullptr@endcode if it is disabled
+         */
+        static std::unique_ptr<RFFReferenceCheckpoint> create(const FractalAttribute &calc, int exp10, bool strictFPG,
+                                                              const fp_fixed_complex &c);
+
+        /**
+         * Reads the latest checkpoint of the key. Nothing is changed if there is no checkpoint which can be resumed.
+         * @return the state to resume, or @code std::nullopt@endcode
+         */
+        template<typename V>
+        std::optional<State> resume(fp_fixed_complex &z, fp_complex_calculator &fpgBn, V &rr, V &ri,
+                                    uint64_t maxIteration, uint64_t initialPeriod, const T &dcMax);
+
+        /**
+         * @param last whether it is the last chance to save, such as the cancellation.
+         * The last one is saved when the reference has run longer than the interval.
+         * @return whether the checkpoint should be saved now
+         */
+        [[nodiscard]] bool due(bool last) const;
+
+        template<typename V>
+        void save(const State &state, const fp_fixed_complex &z, const fp_complex_calculator &fpgBn, const V &rr,
+                  const V &ri);
+
+        /**
+         * Marks the orbit entry which is overwritten.
+         */
+        void markDirty(uint64_t index);
+
+        /**
+         * Removes the checkpoint when the reference is completed, if it is resumed or saved by this reference.
+         */
+        void remove() const;
+
+    private:
+        [[nodiscard]] std::filesystem::path orbitPath(uint64_t generation) const;
+
+        template<typename V>
+        bool writeOrbit(const std::filesystem::path &path, std::ios::openmode mode, uint64_t offset, uint64_t from,
+                        const V &rr, const V &ri) const;
+
+        void removeStaleOrbits() const;
+
+        void evict() const;
+    };
+
+    // DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT
+    // DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT
+    // DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT
+    // DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT  DEFINITION OF REFERENCE CHECKPOINT
+
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    RFFReferenceCheckpoint<T>::RFFReferenceCheckpoint(std::filesystem::path root, std::vector<char> &&key,
+                                                      const uint32_t intervalSeconds) :
+        root(std::move(root)), key(std::move(key)), interval(intervalSeconds), started(std::chrono::steady_clock::now()),
+        lastSaved(started) {
+        // FNV-1a
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const char k: this->key) {
+            hash = (hash ^ static_cast<uint8_t>(k)) * 0x100000001b3ULL;
+        }
+        directory = this->root / std::format(L"{:016x}", hash);
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    std::unique_ptr<RFFReferenceCheckpoint<T> > RFFReferenceCheckpoint<T>::create(
+        const FractalAttribute &calc, const int exp10, const bool strictFPG, const fp_fixed_complex &c) {
+        if (calc.referenceCheckpointInterval == 0) {
+            return nullptr;
+        }
+        const auto &[compressCriteria, compressionThresholdPower, noCompressorNormalization] = calc.referenceCompAttribute;
+        auto key = std::vector<char>();
+        const auto append = [&key]<typename U>(const U &value) {
+            const auto arr = IOUtilities::toBinaryArray(value);
+            key.insert(key.end(), arr.begin(), arr.end());
+        };
+        append(VERSION);
+        append(sizeof(T));
+        append(exp10);
+        append(calc.bailout);
+        append(compressCriteria);
+        append(compressionThresholdPower);
+        append(noCompressorNormalization);
+        append(strictFPG);
+        for (const fp_fixed *part: {&c.getReal(), &c.getImag()}) {
+            append(part->negative);
+            for (const mp_limb_t limb: part->limbs) {
+                append(limb);
+            }
+        }
+        return std::make_unique<RFFReferenceCheckpoint>(
+            SegmentStorage::scratchDirectory(calc.scratchDirectory) / Constants::Fractal::REFERENCE_CHECKPOINT_DIRECTORY,
+            std::move(key), calc.referenceCheckpointInterval);
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    template<typename V>
+    std::optional<typename RFFReferenceCheckpoint<T>::State> RFFReferenceCheckpoint<T>::resume(
+        fp_fixed_complex &z, fp_complex_calculator &fpgBn, V &rr, V &ri, const uint64_t maxIteration,
+        const uint64_t initialPeriod, const T &dcMax) {
+        std::ifstream in(directory / STATE_FILE, std::ios::in | std::ios::binary);
+        if (!in.is_open()) {
+            return std::nullopt;
+        }
+
+        uint64_t len = 0;
+        IOUtilities::readAndDecode(in, &len);
+        if (!in || len != key.size()) {
+            return std::nullopt;
+        }
+        auto storedKey = std::vector<char>(len);
+        IOUtilities::readAndDecode(in, len, storedKey.data());
+        if (!in || storedKey != key) {
+            return std::nullopt;
+        }
+
+        State state;
+        RFFNumberIO::readRaw(in, &state.iteration);
+        RFFNumberIO::readRaw(in, &state.reuseIndex);
+        RFFNumberIO::readRaw(in, &state.compressed);
+        RFFNumberIO::readRaw(in, &state.canReuse);
+        RFFNumberIO::readRaw(in, &state.zr);
+        RFFNumberIO::readRaw(in, &state.zi);
+        RFFNumberIO::readRaw(in, &state.fpgBnr);
+        RFFNumberIO::readRaw(in, &state.fpgBni);
+        RFFNumberIO::readRaw(in, &state.minZRadius);
+        RFFNumberIO::readRaw(in, &state.fpgMargin);
+
+        IOUtilities::readAndDecode(in, &len);
+        if (!in) {
+            return std::nullopt;
+        }
+        state.periodArray.resize(len);
+        RFFNumberIO::readRaw(in, state.periodArray.data(), len);
+
+        IOUtilities::readAndDecode(in, &len);
+        if (!in) {
+            return std::nullopt;
+        }
+        state.tools.reserve(len);
+        for (uint64_t i = 0; i < len; ++i) {
+            uint64_t rebase, start, end;
+            IOUtilities::readAndDecode(in, &rebase);
+            IOUtilities::readAndDecode(in, &start);
+            IOUtilities::readAndDecode(in, &end);
+            state.tools.emplace_back(rebase, start, end);
+        }
+
+        auto resumedZ = fp_fixed_complex(z.size());
+        auto resumedFpgBn = fp_complex_calculator(fpgBn);
+        uint64_t orbitLength = 0;
+        uint64_t orbitGeneration = 0;
+        uint64_t committedBytes = 0;
+        if (!RFFNumberIO::readFixed(in, resumedZ.getReal()) || !RFFNumberIO::readFixed(in, resumedZ.getImag()) ||
+            !RFFNumberIO::readDecimal(in, resumedFpgBn.getReal()) || !RFFNumberIO::readDecimal(in, resumedFpgBn.getImag())) {
+            return std::nullopt;
+        }
+        IOUtilities::readAndDecode(in, &orbitLength);
+        IOUtilities::readAndDecode(in, &orbitGeneration);
+        IOUtilities::readAndDecode(in, &committedBytes);
+
+        // the new run must not have stopped before the checkpoint.
+        if (!in || state.iteration >= maxIteration || (initialPeriod != 0 && initialPeriod < state.iteration) ||
+            !(dcMax < std::as_const(state.fpgMargin))) {
+            return std::nullopt;
+        }
+
+        std::ifstream orbit(orbitPath(orbitGeneration), std::ios::in | std::ios::binary);
+        if (!orbit.is_open()) {
+            return std::nullopt;
+        }
+        rr.clear();
+        ri.clear();
+        // replays the committed records. the later records overwrite the entries of the earlier ones.
+        auto buffer = std::vector<T>(ORBIT_BUFFER_SIZE * 2);
+        uint64_t consumed = 0;
+        while (orbit && consumed < committedBytes) {
+            uint64_t start = 0;
+            uint64_t length = 0;
+            RFFNumberIO::readRaw(orbit, &start);
+            RFFNumberIO::readRaw(orbit, &length);
+            consumed += ORBIT_RECORD_HEADER + length * ORBIT_ENTRY_SIZE;
+            if (!orbit || start > rr.size() || consumed > committedBytes) {
+                orbit.setstate(std::ios::failbit);
+                break;
+            }
+            for (uint64_t i = 0; i < length && orbit; i += ORBIT_BUFFER_SIZE) {
+                const uint64_t count = std::min(ORBIT_BUFFER_SIZE, length - i);
+                orbit.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(count * ORBIT_ENTRY_SIZE));
+                for (uint64_t j = 0; j < count; ++j) {
+                    if (const uint64_t index = start + i + j; index < rr.size()) {
+                        rr[index] = buffer[j * 2];
+                        ri[index] = buffer[j * 2 + 1];
+                    } else {
+                        rr.push_back(buffer[j * 2]);
+                        ri.push_back(buffer[j * 2 + 1]);
+                    }
+                }
+            }
+        }
+        if (!orbit || rr.size() != orbitLength) {
+            rr.clear();
+            ri.clear();
+            rr.push_back(T{});
+            ri.push_back(T{});
+            return std::nullopt;
+        }
+
+        z = std::move(resumedZ);
+        fpgBn = std::move(resumedFpgBn);
+        savedLength = orbitLength;
+        dirtyFrom = orbitLength;
+        generation = orbitGeneration;
+        orbitBytes = committedBytes;
+        owned = true;
+        lastSaved = std::chrono::steady_clock::now();
+        std::error_code error;
+        std::filesystem::last_write_time(directory / STATE_FILE, std::filesystem::file_time_type::clock::now(), error);
+        return state;
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    bool RFFReferenceCheckpoint<T>::due(const bool last) const {
+        const auto now = std::chrono::steady_clock::now();
+        return now - lastSaved >= interval || (last && now - started >= interval);
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    template<typename V>
+    void RFFReferenceCheckpoint<T>::save(const State &state, const fp_fixed_complex &z,
+                                         const fp_complex_calculator &fpgBn, const V &rr, const V &ri) {
+        lastSaved = std::chrono::steady_clock::now();
+        try {
+            if (!owned) {
+                // the files of the other run of the same key are not resumable, and must not be committed with the new orbit.
+                std::filesystem::remove_all(directory);
+            }
+            std::filesystem::create_directories(directory);
+
+            // the orbit first, and then the state which commits it.
+            // the records are appended after the committed bytes, or rewritten to the next generation when they grow twice the orbit.
+            const uint64_t from = std::min(dirtyFrom, savedLength);
+            const uint64_t recordBytes = ORBIT_RECORD_HEADER + (rr.size() - from) * ORBIT_ENTRY_SIZE;
+            const bool rewrite = !owned || orbitBytes + recordBytes > ORBIT_RECORD_HEADER + rr.size() * ORBIT_ENTRY_SIZE * 2;
+            const uint64_t nextGeneration = rewrite ? generation + 1 : generation;
+            const uint64_t nextFrom = rewrite ? 0 : from;
+            const uint64_t offset = rewrite ? 0 : orbitBytes;
+            const auto nextOrbitPath = orbitPath(nextGeneration);
+            if (!rewrite) {
+                std::filesystem::resize_file(nextOrbitPath, orbitBytes);
+            }
+            if (!writeOrbit(nextOrbitPath, rewrite
+                                               ? std::ios::out | std::ios::binary | std::ios::trunc
+                                               : std::ios::in | std::ios::out | std::ios::binary,
+                            offset, nextFrom, rr, ri)) {
+                vkh::logger::w_log(L"ERROR : Cannot save reference checkpoint");
+                return;
+            }
+            const uint64_t nextOrbitBytes = offset + ORBIT_RECORD_HEADER + (rr.size() - nextFrom) * ORBIT_ENTRY_SIZE;
+
+            const auto tempPath = directory / STATE_TEMP_FILE;
+            if (std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc); out.is_open()) {
+                IOUtilities::encodeAndWrite(out, static_cast<uint64_t>(key.size()));
+                IOUtilities::encodeAndWrite(out, key.data(), key.size());
+                RFFNumberIO::writeRaw(out, state.iteration);
+                RFFNumberIO::writeRaw(out, state.reuseIndex);
+                RFFNumberIO::writeRaw(out, state.compressed);
+                RFFNumberIO::writeRaw(out, state.canReuse);
+                RFFNumberIO::writeRaw(out, state.zr);
+                RFFNumberIO::writeRaw(out, state.zi);
+                RFFNumberIO::writeRaw(out, state.fpgBnr);
+                RFFNumberIO::writeRaw(out, state.fpgBni);
+                RFFNumberIO::writeRaw(out, state.minZRadius);
+                RFFNumberIO::writeRaw(out, state.fpgMargin);
+                IOUtilities::encodeAndWrite(out, static_cast<uint64_t>(state.periodArray.size()));
+                RFFNumberIO::writeRaw(out, state.periodArray.data(), state.periodArray.size());
+                IOUtilities::encodeAndWrite(out, static_cast<uint64_t>(state.tools.size()));
+                for (const auto &tool: state.tools) {
+                    IOUtilities::encodeAndWrite(out, tool.rebase);
+                    IOUtilities::encodeAndWrite(out, tool.start);
+                    IOUtilities::encodeAndWrite(out, tool.end);
+                }
+                RFFNumberIO::writeFixed(out, z.getReal());
+                RFFNumberIO::writeFixed(out, z.getImag());
+                RFFNumberIO::writeDecimal(out, fpgBn.getRealClone());
+                RFFNumberIO::writeDecimal(out, fpgBn.getImagClone());
+                IOUtilities::encodeAndWrite(out, static_cast<uint64_t>(rr.size()));
+                IOUtilities::encodeAndWrite(out, nextGeneration);
+                IOUtilities::encodeAndWrite(out, nextOrbitBytes);
+                out.close();
+                if (!out) {
+                    vkh::logger::w_log(L"ERROR : Cannot save reference checkpoint");
+                    return;
+                }
+            } else {
+                vkh::logger::w_log(L"ERROR : Cannot save reference checkpoint");
+                return;
+            }
+            std::filesystem::rename(tempPath, directory / STATE_FILE);
+            savedLength = rr.size();
+            dirtyFrom = savedLength;
+            generation = nextGeneration;
+            orbitBytes = nextOrbitBytes;
+            owned = true;
+            removeStaleOrbits();
+            evict();
+        } catch (const std::filesystem::filesystem_error &) {
+            vkh::logger::w_log(L"ERROR : Cannot save reference checkpoint");
+        }
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    void RFFReferenceCheckpoint<T>::markDirty(const uint64_t index) {
+        dirtyFrom = std::min(dirtyFrom, index);
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    void RFFReferenceCheckpoint<T>::remove() const {
+        if (!owned) {
+            return;
+        }
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    std::filesystem::path RFFReferenceCheckpoint<T>::orbitPath(const uint64_t generation) const {
+        return directory / std::format(L"{}{}.bin", ORBIT_FILE_PREFIX, generation);
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    template<typename V>
+    bool RFFReferenceCheckpoint<T>::writeOrbit(const std::filesystem::path &path, const std::ios::openmode mode,
+                                               const uint64_t offset, const uint64_t from, const V &rr,
+                                               const V &ri) const {
+        std::ofstream orbit(path, mode);
+        if (!orbit.is_open()) {
+            return false;
+        }
+        orbit.seekp(static_cast<std::streamoff>(offset));
+        RFFNumberIO::writeRaw(orbit, from);
+        RFFNumberIO::writeRaw(orbit, static_cast<uint64_t>(rr.size() - from));
+        auto buffer = std::vector<T>(ORBIT_BUFFER_SIZE * 2);
+        for (uint64_t i = from; i < rr.size(); i += ORBIT_BUFFER_SIZE) {
+            const uint64_t count = std::min<uint64_t>(ORBIT_BUFFER_SIZE, rr.size() - i);
+            for (uint64_t j = 0; j < count; ++j) {
+                buffer[j * 2] = rr[i + j];
+                buffer[j * 2 + 1] = ri[i + j];
+            }
+            orbit.write(reinterpret_cast<const char *>(buffer.data()),
+                        static_cast<std::streamsize>(count * ORBIT_ENTRY_SIZE));
+        }
+        orbit.close();
+        return static_cast<bool>(orbit);
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    void RFFReferenceCheckpoint<T>::removeStaleOrbits() const {
+        const auto current = orbitPath(generation).filename();
+        std::error_code error;
+        for (const auto &entry: std::filesystem::directory_iterator(directory, error)) {
+            if (const auto name = entry.path().filename();
+                name != current && name.wstring().starts_with(ORBIT_FILE_PREFIX)) {
+                std::filesystem::remove(entry.path(), error);
+            }
+        }
+    }
+
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    void RFFReferenceCheckpoint<T>::evict() const {
+        constexpr uint64_t capacity = static_cast<uint64_t>(Constants::Fractal::REFERENCE_CHECKPOINT_CAPACITY) << 20;
+        auto entries = std::vector<std::tuple<std::filesystem::file_time_type, uint64_t, std::filesystem::path> >();
+        uint64_t total = 0;
+        std::error_code error;
+        for (const auto &checkpoint: std::filesystem::directory_iterator(root, error)) {
+            if (!checkpoint.is_directory(error)) {
+                continue;
+            }
+            uint64_t size = 0;
+            for (const auto &file: std::filesystem::directory_iterator(checkpoint.path(), error)) {
+                if (file.is_regular_file(error)) {
+                    size += file.file_size(error);
+                }
+            }
+            total += size;
+            // the checkpoint without the state is the oldest, since it cannot be resumed.
+            auto time = std::filesystem::last_write_time(checkpoint.path() / STATE_FILE, error);
+            if (error) {
+                time = std::filesystem::file_time_type::min();
+            }
+            entries.emplace_back(time, size, checkpoint.path());
+        }
+        std::ranges::sort(entries);
+        for (const auto &[time, size, path]: entries) {
+            if (total <= capacity) {
+                break;
+            }
+            if (path == directory) {
+                continue;
+            }
+            if (std::filesystem::remove_all(path, error) != static_cast<std::uintmax_t>(-1)) {
+                total -= size;
+            }
+        }
+    }
+}
@@ -127,6 +127,7 @@ namespace merutilm::rff2 {
         const int doubledExp10 = Perturbator::logZoomToExp10(doubledLogZoom);
         auto e = doubledZoomCalc.center.edit(doubledExp10);
         doubledZoomCalc.absoluteIterationMode = false;
+        doubledZoomCalc.referenceCheckpointInterval = 0;
         doubledZoomCalc.center = fp_complex(e += findCenterOffset(*perturbator)->edit(doubledExp10));
         doubledZoomCalc.logZoom = doubledLogZoom;
 
@@ -0,0 +1,156 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "ArrayCompressionTool.h"
+
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Compressed Reference Cursor</b>
+     * <br/>
+     * A stateful replacement of @code ArrayCompressor::compress()@endcode for the hot loops. <br/>
+     * The compressed index is a piecewise-linear function of the iteration with slope 1,
+     * so the cursor remembers how many further iterations stay on the current linear run. <br/>
+     * <li> Advancing by one (or skipping within the run) is @code O(1)@endcode.</li>
+     * <li> Leaving the run, jumping backwards (rebase to 0) or jumping forward (MPA skip) repositions with a binary-search per nesting level of the tools.</li>
+     * <br/>
+     * <b>The given tools and offsets must outlive the cursor. The offsets must be created by createPulledOffsets() from the same tools.</b>
+     */
+    class CompressedReferenceCursor {
+        const std::vector<ArrayCompressionTool> &tools;
+        const std::vector<uint64_t> &pulledOffsets;
+        uint64_t iteration = 0;
+        uint64_t index = 0;
+        uint64_t remaining = 0;
+
+    public:
+        explicit CompressedReferenceCursor(const std::vector<ArrayCompressionTool> &tools,
+                                           const std::vector<uint64_t> &pulledOffsets);
+
+        /**
+         * Creates the prefix sum of the tools' ranges. <br/>
+         * The element @code i@endcode is the number of indices pulled by the first @code i@endcode tools.
+         *
+         * @param tools The Compression tools
+         * @return The offsets which has @code tools.size() + 1@endcode elements.
+         */
+        static std::vector<uint64_t> createPulledOffsets(const std::vector<ArrayCompressionTool> &tools);
+
+        /**
+         * Moves the cursor to the next iteration.
+         * @return The compressed index of the next iteration.
+         */
+        uint64_t next();
+
+        /**
+         * Moves the cursor to the given iteration.
+         * @param target the iteration to move
+         * @return The compressed index of the given iteration.
+         */
+        uint64_t seek(uint64_t target);
+
+        uint64_t getIteration() const;
+
+        uint64_t getIndex() const;
+
+        /**
+         * @return The number of next() calls in which the compressed index keeps increasing by one.
+         */
+        uint64_t getRemaining() const;
+
+    private:
+        void reposition(uint64_t target);
+    };
+
+    // DEFINITION OF COMPRESSED_REFERENCE_CURSOR  DEFINITION OF COMPRESSED_REFERENCE_CURSOR  DEFINITION OF COMPRESSED_REFERENCE_CURSOR  DEFINITION OF COMPRESSED_REFERENCE_CURSOR
+    // DEFINITION OF COMPRESSED_REFERENCE_CURSOR  DEFINITION OF COMPRESSED_REFERENCE_CURSOR  DEFINITION OF COMPRESSED_REFERENCE_CURSOR  DEFINITION OF COMPRESSED_REFERENCE_CURSOR
+    // DEFINITION OF COMPRESSED_REFERENCE_CURSOR  DEFINITION OF COMPRESSED_REFERENCE_CURSOR  DEFINITION OF COMPRESSED_REFERENCE_CURSOR  DEFINITION OF COMPRESSED_REFERENCE_CURSOR
+
+
+    inline CompressedReferenceCursor::CompressedReferenceCursor(const std::vector<ArrayCompressionTool> &tools,
+                                                                const std::vector<uint64_t> &pulledOffsets) : tools(tools),
+        pulledOffsets(pulledOffsets) {
+        reposition(0);
+    }
+
+    inline std::vector<uint64_t> CompressedReferenceCursor::createPulledOffsets(
+        const std::vector<ArrayCompressionTool> &tools) {
+        auto offsets = std::vector<uint64_t>(tools.size() + 1, 0);
+        for (size_t i = 0; i < tools.size(); ++i) {
+            offsets[i + 1] = offsets[i] + tools[i].range();
+        }
+        return offsets;
+    }
+
+    inline uint64_t CompressedReferenceCursor::next() {
+        ++iteration;
+        if (remaining > 0) {
+            --remaining;
+            return ++index;
+        }
+        reposition(iteration);
+        return index;
+    }
+
+    inline uint64_t CompressedReferenceCursor::seek(const uint64_t target) {
+        if (target >= iteration && target - iteration <= remaining) {
+            const uint64_t delta = target - iteration;
+            iteration = target;
+            index += delta;
+            remaining -= delta;
+            return index;
+        }
+        reposition(target);
+        return index;
+    }
+
+    inline uint64_t CompressedReferenceCursor::getIteration() const {
+        return iteration;
+    }
+
+    inline uint64_t CompressedReferenceCursor::getIndex() const {
+        return index;
+    }
+
+    inline uint64_t CompressedReferenceCursor::getRemaining() const {
+        return remaining;
+    }
+
+    inline void CompressedReferenceCursor::reposition(const uint64_t target) {
+        // Same result as ArrayCompressor::compress(), but also measures the length of the linear run.
+        // The rebased index of a tool is always smaller than its start, so the nested tools are resolved downwards.
+        uint64_t rebased = target;
+        uint64_t run = std::numeric_limits<uint64_t>::max();
+
+        while (true) {
+            const auto nextTool = std::upper_bound(tools.begin(), tools.end(), rebased,
+                                                   [](const uint64_t v, const ArrayCompressionTool &tool) {
+                                                       return v < tool.start;
+                                                   });
+            const auto next = static_cast<size_t>(nextTool - tools.begin());
+
+            if (next > 0 && rebased <= tools[next - 1].end) {
+                const ArrayCompressionTool &tool = tools[next - 1];
+                run = std::min(run, tool.end - rebased);
+                rebased -= tool.start - tool.rebase;
+                continue;
+            }
+
+            if (next < tools.size()) {
+                run = std::min(run, tools[next].start - 1 - rebased);
+            }
+            index = rebased - pulledOffsets[next];
+            break;
+        }
+
+        iteration = target;
+        remaining = run;
+    }
+}
@@ -3,6 +3,8 @@
 //
 
 #pragma once
+#include <cmath>
+
 #include "DeepPA.h"
 #include "MPATable.h"
 #include "../calc/double_exp_math.h"
@@ -21,6 +23,12 @@ namespace merutilm::rff2 {
         }
 
 
+        explicit DeepMPATable(const DeepMandelbrotReference &reference, const FrtMPAAttribute *mpaSettings,
+                      ApproxTableCache &tableRef) : MPATable(reference, mpaSettings, tableRef) {
+
+        }
+
+
         ~DeepMPATable() override = default;
 
         DeepMPATable(const DeepMPATable &) = delete;
@@ -31,9 +39,17 @@ namespace merutilm::rff2 {
 
         DeepMPATable &operator=(DeepMPATable &&) noexcept = delete;
 
-        DeepPA *lookup(uint64_t refIteration, const dex &dzr, const dex &dzi, std::array<dex, 4> &temps) const;
+        const DeepPA::Entry *lookup(uint64_t refIteration, const dex &dzr, const dex &dzi, std::array<dex, 4> &temps) const;
+
+        /**
+         * The same as lookup(), which is specialized for the selection and the compression method of the table.
+         */
+        template<FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION>
+        const DeepPA::Entry *lookup(uint64_t refIteration, const dex &dzr, const dex &dzi, std::array<dex, 4> &temps) const;
 
         size_t getLength() override;
+
+        uint64_t validateSelection() const override;
     };
 
     // DEFINITION OF DEEP MPA TABLE  DEFINITION OF DEEP MPA TABLE  DEFINITION OF DEEP MPA TABLE  DEFINITION OF DEEP MPA TABLE  DEFINITION OF DEEP MPA TABLE
@@ -43,57 +59,90 @@ namespace merutilm::rff2 {
     // DEFINITION OF DEEP MPA TABLE  DEFINITION OF DEEP MPA TABLE  DEFINITION OF DEEP MPA TABLE  DEFINITION OF DEEP MPA TABLE  DEFINITION OF DEEP MPA TABLE
 
 
-    inline DeepPA *DeepMPATable::lookup(const uint64_t refIteration, const dex &dzr, const dex &dzi, std::array<dex, 4> &temps) const {
+    inline const DeepPA::Entry *DeepMPATable::lookup(const uint64_t refIteration, const dex &dzr, const dex &dzi, std::array<dex, 4> &temps) const {
+        using enum FrtMPASelectionMethod;
+        using enum FrtMPACompressionMethod;
+        const bool lowest = mpaSettings.mpaSelectionMethod == LOWEST;
+        switch (mpaSettings.mpaCompressionMethod) {
+            case LITTLE_COMPRESSION:
+                return lowest
+                           ? lookup<LOWEST, LITTLE_COMPRESSION>(refIteration, dzr, dzi, temps)
+                           : lookup<HIGHEST, LITTLE_COMPRESSION>(refIteration, dzr, dzi, temps);
+            case STRONGEST:
+                return lowest
+                           ? lookup<LOWEST, STRONGEST>(refIteration, dzr, dzi, temps)
+                           : lookup<HIGHEST, STRONGEST>(refIteration, dzr, dzi, temps);
+            default:
+                return lowest
+                           ? lookup<LOWEST, NO_COMPRESSION>(refIteration, dzr, dzi, temps)
+                           : lookup<HIGHEST, NO_COMPRESSION>(refIteration, dzr, dzi, temps);
+        }
+    }
+
+    template<FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION>
+    const DeepPA::Entry *DeepMPATable::lookup(const uint64_t refIteration, const dex &dzr, const dex &dzi, std::array<dex, 4> &temps) const {
 
         if (refIteration == 0 || mpaPeriod == nullptr) {
             return nullptr;
         }
 
-        const uint64_t index = iterationToCompTableIndex(mpaSettings.mpaCompressionMethod, *mpaPeriod, pulledMPACompressor,
-                                                         refIteration);
+        const uint64_t index = iterationToCompTableIndex<COMPRESSION>(*mpaPeriod, pulledMPACompressor, refIteration);
 
-        if (index >= tableRef.deepTable.size()) {
+        const auto &table = tableRef.deepTable;
+        if (index >= table.size()) {
             return nullptr;
         }
 
-        std::vector<DeepPA> &table = this->tableRef.deepTable[index];
-        if (table.empty()) {
+        const uint64_t begin = table.offsets[index];
+        const uint64_t end = table.offsets[index + 1];
+        if (begin == end) {
             return nullptr;
         }
 
         dex_trigonometric::hypot_approx(&temps[0], dzr, dzi);
+        const DeepPA::RadiusKey key = DeepPA::RadiusKey::of(temps[0]);
+        const DeepPA::Bound *bounds = table.bounds.data();
+        const DeepPA::Entry *pas = table.pas.data();
+
+        const uint64_t j = selectPA<SELECTION>(begin, end, [bounds, pas, &key](const uint64_t i) {
+            return bounds[i].isValid(key, pas[i]);
+        });
+        return j == UINT64_MAX ? nullptr : &pas[j];
+    }
 
-        switch (mpaSettings.mpaSelectionMethod) {
-            using enum FrtMPASelectionMethod;
-            case LOWEST: {
-                DeepPA *pa = nullptr;
-
-                for (DeepPA &test: table) {
-                    if (test.isValid(&temps[1], temps[0])) {
-                        pa = &test;
-                    } else return pa;
-                }
-                return pa;
-            }
-            case HIGHEST: {
-                DeepPA &pa = table.front();
-                //This table cannot be empty because the pre-processing is done.
-
-                if (!pa.isValid(&temps[1], temps[0])) {
-                    return nullptr;
-                }
-
-                for (uint64_t j = table.size(); j > 0; --j) {
-                    DeepPA &test = table[j - 1];
-                    if (test.isValid(&temps[1], temps[0])) {
-                        return &test;
+    inline uint64_t DeepMPATable::validateSelection() const {
+        using enum FrtMPASelectionMethod;
+        const auto &table = tableRef.deepTable;
+        const bool lowest = mpaSettings.mpaSelectionMethod == LOWEST;
+        if (table.exactRadii.size() != table.pas.size()) {
+            return UINT64_MAX;
+        }
+        uint64_t mismatches = 0;
+
+        for (uint64_t index = 0; index < table.size(); ++index) {
+            const uint64_t begin = table.offsets[index];
+            const uint64_t end = table.offsets[index + 1];
+            for (uint64_t p = begin; p < end; ++p) {
+                const dex radius = table.exactRadii[p];
+                const int exp2 = radius.get_exp2();
+                const double mantissa = radius.get_mantissa();
+                for (const dex &r: {dex(exp2, std::nextafter(mantissa, 0.0)), radius, dex(exp2, std::nextafter(mantissa, 2.0))}) {
+                    const DeepPA::RadiusKey key = DeepPA::RadiusKey::of(r);
+                    const auto compact = [&table, &key](const uint64_t i) {
+                        return table.bounds[i].isValid(key, table.pas[i]);
+                    };
+                    const auto exact = [&table, &r](const uint64_t i) {
+                        return r < table.exactRadii[i];
+                    };
+                    if (lowest
+                            ? selectPA<LOWEST>(begin, end, compact) != selectPA<LOWEST>(begin, end, exact)
+                            : selectPA<HIGHEST>(begin, end, compact) != selectPA<HIGHEST>(begin, end, exact)) {
+                        ++mismatches;
                     }
                 }
-
-                return &pa;
             }
-            default: return nullptr;
         }
+        return mismatches;
     }
 
     inline size_t DeepMPATable::getLength() {
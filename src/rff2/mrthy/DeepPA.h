@@ -3,6 +3,9 @@
 //
 
 #pragma once
+#include <bit>
+#include <climits>
+#include <cstdint>
 #include <vector>
 
 #include "ArrayCompressionTool.h"
@@ -13,6 +16,78 @@
 
 namespace merutilm::rff2 {
     struct DeepPA final : public PA{
+        struct Entry;
+
+        /**
+         * The radius or the distance as the normalized exponent and the bits of the mantissa,
+         * which are in the same order as the positive values.
+         * The value which is never valid is the lowest one, and NaN is the highest one.
+         */
+        struct RadiusKey {
+            int32_t exp2;
+            uint64_t mantissa;
+
+            static RadiusKey of(const dex &v);
+        };
+
+        /**
+         * The exponent and the upper 32 bits of the mantissa of the radius, which the compact table scans from its own array.
+         * It is the radius rounded down to the float of the exponent range of dex,
+         * and the lower bits in the entry are read only when the upper bits are the same as the compared one.
+         */
+        struct Bound {
+            int32_t radiusExp2;
+            uint32_t radiusHigh;
+
+            Bound() = default;
+
+            explicit Bound(const DeepPA &pa);
+
+            /**
+             * The same as DeepPA::isValid, except for the zero distance.
+             * The subtraction flushes the radius below 2^-1022 to zero against it, but this is valid for any positive radius.
+             * @param key the key of the distance
+             * @param entry the entry of this bound, which is read only when the upper bits are the same
+             */
+            [[nodiscard]] bool isValid(const RadiusKey &key, const Entry &entry) const;
+        };
+
+        /**
+         * The PA kept in the compact table.
+         * The exponents of the coefficients are packed together after their mantissas, so it is 56 bytes instead of 88.
+         * The skip is 32-bit, and is packed next to the lower bits of the radius.
+         * The values are not changed at all, so the selected PA and the result are the same as the generated one.
+         */
+        struct Entry {
+            double anrMantissa;
+            double aniMantissa;
+            int32_t anrExp2;
+            int32_t aniExp2;
+            double bnrMantissa;
+            double bniMantissa;
+            int32_t bnrExp2;
+            int32_t bniExp2;
+            uint32_t skip;
+            uint32_t radiusLow;
+
+            Entry() = default;
+
+            explicit Entry(const DeepPA &pa);
+
+            /**
+             * @return the exact radius, from the exponent and the upper bits of the given bound
+             */
+            [[nodiscard]] dex radius(const Bound &bound) const;
+
+            [[nodiscard]] dex anr() const;
+
+            [[nodiscard]] dex ani() const;
+
+            [[nodiscard]] dex bnr() const;
+
+            [[nodiscard]] dex bni() const;
+        };
+
         const dex anr;
         const dex ani;
         const dex bnr;
@@ -25,6 +100,11 @@ namespace merutilm::rff2 {
 
         dex getRadius() const;
 
+        /**
+         * @return the key of the radius kept in the compact table.
+         * The radius which is never valid is the lowest key, also when the skip does not fit in 32 bits.
+         */
+        [[nodiscard]] RadiusKey compactRadius() const;
     };
 
     inline DeepPA::DeepPA(const dex &anr, const dex &ani, const dex &bnr, const dex &bni,
@@ -34,6 +114,72 @@ namespace merutilm::rff2 {
 
 
 
+    static_assert(sizeof(DeepPA::Entry) == 56);
+    static_assert(sizeof(DeepPA::Bound) == 8);
+
+    inline DeepPA::RadiusKey DeepPA::RadiusKey::of(const dex &v) {
+        if (v.isnan()) {
+            return {INT32_MAX, UINT64_MAX};
+        }
+        if (v.sgn() <= 0) {
+            return {INT32_MIN, 0};
+        }
+        if (v.isinf()) {
+            return {INT32_MAX, UINT64_MAX - 1};
+        }
+        dex normalized = v;
+        dex::normalize(&normalized);
+        return {normalized.get_exp2(), std::bit_cast<uint64_t>(normalized.get_mantissa())};
+    }
+
+    inline DeepPA::Bound::Bound(const DeepPA &pa) {
+        const RadiusKey key = pa.compactRadius();
+        radiusExp2 = key.exp2;
+        radiusHigh = static_cast<uint32_t>(key.mantissa >> 32);
+    }
+
+    inline bool DeepPA::Bound::isValid(const RadiusKey &key, const Entry &entry) const {
+        const auto high = static_cast<uint32_t>(key.mantissa >> 32);
+        return key.exp2 < radiusExp2 ||
+               (key.exp2 == radiusExp2 && (high < radiusHigh ||
+                                           (high == radiusHigh && static_cast<uint32_t>(key.mantissa) < entry.radiusLow)));
+    }
+
+    inline DeepPA::Entry::Entry(const DeepPA &pa) : anrMantissa(pa.anr.get_mantissa()), aniMantissa(pa.ani.get_mantissa()),
+                                                    anrExp2(pa.anr.get_exp2()), aniExp2(pa.ani.get_exp2()),
+                                                    bnrMantissa(pa.bnr.get_mantissa()), bniMantissa(pa.bni.get_mantissa()),
+                                                    bnrExp2(pa.bnr.get_exp2()), bniExp2(pa.bni.get_exp2()),
+                                                    skip(static_cast<uint32_t>(pa.skip)),
+                                                    radiusLow(static_cast<uint32_t>(pa.compactRadius().mantissa)) {
+    }
+
+    inline dex DeepPA::Entry::radius(const Bound &bound) const {
+        const uint64_t mantissa = (static_cast<uint64_t>(bound.radiusHigh) << 32) | radiusLow;
+        if (bound.radiusExp2 == INT32_MIN) {
+            return dex::ZERO;
+        }
+        if (bound.radiusExp2 == INT32_MAX) {
+            return dex::PINF;
+        }
+        return dex(bound.radiusExp2, std::bit_cast<double>(mantissa));
+    }
+
+    inline dex DeepPA::Entry::anr() const {
+        return dex(anrExp2, anrMantissa);
+    }
+
+    inline dex DeepPA::Entry::ani() const {
+        return dex(aniExp2, aniMantissa);
+    }
+
+    inline dex DeepPA::Entry::bnr() const {
+        return dex(bnrExp2, bnrMantissa);
+    }
+
+    inline dex DeepPA::Entry::bni() const {
+        return dex(bniExp2, bniMantissa);
+    }
+
     inline dex DeepPA::getRadius() const {
         return radius;
     }
@@ -43,4 +189,8 @@ namespace merutilm::rff2 {
         dex::sub(temp, radius, dzRad);
         return temp->sgn() > 0;
     }
+
+    inline DeepPA::RadiusKey DeepPA::compactRadius() const {
+        return skip <= UINT32_MAX && !radius.isnan() ? RadiusKey::of(radius) : RadiusKey{INT32_MIN, 0};
+    }
 }
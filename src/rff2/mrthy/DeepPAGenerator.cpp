@@ -4,18 +4,16 @@
 
 #include "DeepPAGenerator.h"
 
-#include "ArrayCompressor.h"
 #include "../calc/double_exp_math.h"
 
 namespace merutilm::rff2 {
     DeepPAGenerator::DeepPAGenerator(const DeepMandelbrotReference &reference, const double epsilon, const dex &dcMax,
-                                                    const uint64_t start, std::array<dex, 8> &temps) : PAGenerator(start, 0, reference.compressor, epsilon), anr(dex::ONE),
+                                                    const uint64_t start, std::array<dex, 8> &temps) : PAGenerator(start, 0, reference.compressor, reference.compressorOffsets, epsilon), anr(dex::ONE),
                                                                                          ani(dex::ZERO),
                                                                                          bnr(dex::ZERO), bni(dex::ZERO),
                                                                                          radius(dex::ONE),
                                                                                          temps(temps),
-                                                                                         refReal(reference.refReal),
-                                                                                         refImag(reference.refImag), dcMax(dcMax) {
+                                                                                         orbit(reference.orbit), dcMax(dcMax) {
     }
 
 
@@ -48,9 +46,9 @@ namespace merutilm::rff2 {
 
     void DeepPAGenerator::step() {
         const uint64_t iter = start + skip++; //n+k
-        const uint64_t index = ArrayCompressor::compress(compressors, iter);
-        dex::mul_2exp(&temps[0], refReal[index], 1);
-        dex::mul_2exp(&temps[1], refImag[index], 1);
+        const uint64_t index = cursor.seek(iter);
+        dex::mul_2exp(&temps[0], orbit.real(index), 1);
+        dex::mul_2exp(&temps[1], orbit.imag(index), 1);
         dex::mul(&temps[2], anr, temps[0]);
         dex::mul(&temps[3], ani, temps[1]);
         dex::sub(&temps[2], temps[2], temps[3]);
@@ -16,8 +16,7 @@ namespace merutilm::rff2 {
         dex bni;
         dex radius;
         std::array<dex, 8> &temps;
-        const std::vector<dex> &refReal;
-        const std::vector<dex> &refImag;
+        const DeepReferenceOrbitStore &orbit;
         dex dcMax;
 
     public:
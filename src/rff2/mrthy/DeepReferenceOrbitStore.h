@@ -0,0 +1,122 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "SegmentStorage.h"
+#include "SegmentedVector.h"
+#include "../calc/dex.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Deep Reference Orbit Store</b>
+     * <br/>
+     * The reference orbit of the deep perturbator, which keeps the real and the imaginary part of each iteration in one record.
+     * The dex is 16 bytes with the padding after its exponent, but the record of the two parts packs both exponents together.
+     * So an iteration is 24 bytes instead of 32, and the values are not changed at all.
+     * <li> The records are kept in the segments, so the huge orbit needs no contiguous memory, and it is not reallocated while growing.</li>
+     * <li> The segments are allocated by the same storage method as the parts, in their own arena.</li>
+     */
+    class DeepReferenceOrbitStore final {
+    public:
+        struct Record {
+            double realMantissa;
+            double imagMantissa;
+            int32_t realExp2;
+            int32_t imagExp2;
+        };
+
+        static_assert(sizeof(Record) == 24);
+
+        static constexpr size_t SEGMENT_BIT_SIZE = 16;
+        static constexpr size_t SEGMENT_SIZE = 1ULL << SEGMENT_BIT_SIZE;
+        static constexpr size_t MASK = SEGMENT_SIZE - 1;
+
+        using Storage = SegmentStorage;
+        using Part = SegmentedVector<dex, SEGMENT_BIT_SIZE, Storage>;
+
+    private:
+        std::vector<SegmentPointer<Record, Storage, SEGMENT_SIZE> > segments;
+        Storage storage;
+        size_t length = 0;
+
+    public:
+        DeepReferenceOrbitStore() = default;
+
+        /**
+         * Packs the parts of the orbit. Each segment of the parts is released as soon as it is packed,
+         * so the orbit is not held twice.
+         * @param real the real part of the orbit
+         * @param imag the imaginary part of the orbit, of the same size
+         */
+        DeepReferenceOrbitStore(Part &&real, Part &&imag);
+
+        DeepReferenceOrbitStore(const DeepReferenceOrbitStore &) = delete;
+
+        DeepReferenceOrbitStore &operator=(const DeepReferenceOrbitStore &) = delete;
+
+        DeepReferenceOrbitStore(DeepReferenceOrbitStore &&) noexcept = default;
+
+        DeepReferenceOrbitStore &operator=(DeepReferenceOrbitStore &&) noexcept = default;
+
+        [[nodiscard]] dex real(uint64_t index) const;
+
+        [[nodiscard]] dex imag(uint64_t index) const;
+
+        [[nodiscard]] size_t size() const;
+
+    private:
+        [[nodiscard]] const Record &record(uint64_t index) const;
+    };
+
+    // DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE
+    // DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE
+    // DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE
+    // DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE
+    // DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE  DEFINITION OF DEEP REFERENCE ORBIT STORE
+
+
+    inline DeepReferenceOrbitStore::DeepReferenceOrbitStore(Part &&real, Part &&imag)
+        : storage(real.get_storage()), length(real.size()) {
+        const size_t count = (length + MASK) >> SEGMENT_BIT_SIZE;
+        segments.reserve(count);
+
+        for (size_t s = 0; s < count; ++s) {
+            segments.push_back(allocateSegment<Record, SEGMENT_SIZE>(storage));
+            Record *segment = segments.back().get();
+
+            const size_t begin = s << SEGMENT_BIT_SIZE;
+            const auto realSpan = real.segment_span(begin);
+            const auto imagSpan = imag.segment_span(begin);
+            // The unallocated segment of the parts is zero.
+            for (size_t i = 0; i < SEGMENT_SIZE; ++i) {
+                const dex &r = realSpan.empty() ? dex::ZERO : realSpan[i];
+                const dex &m = imagSpan.empty() ? dex::ZERO : imagSpan[i];
+                segment[i] = Record{r.get_mantissa(), m.get_mantissa(), r.get_exp2(), m.get_exp2()};
+            }
+            real.release_segment(begin);
+            imag.release_segment(begin);
+        }
+    }
+
+    inline const DeepReferenceOrbitStore::Record &DeepReferenceOrbitStore::record(const uint64_t index) const {
+        return segments[index >> SEGMENT_BIT_SIZE][index & MASK];
+    }
+
+    inline dex DeepReferenceOrbitStore::real(const uint64_t index) const {
+        const Record &r = record(index);
+        return dex(r.realExp2, r.realMantissa);
+    }
+
+    inline dex DeepReferenceOrbitStore::imag(const uint64_t index) const {
+        const Record &r = record(index);
+        return dex(r.imagExp2, r.imagMantissa);
+    }
+
+    inline size_t DeepReferenceOrbitStore::size() const {
+        return length;
+    }
+}
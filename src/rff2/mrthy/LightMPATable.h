@@ -3,6 +3,7 @@
 //
 
 #pragma once
+#include <cmath>
 #include <vector>
 
 #include "LightPA.h"
@@ -24,6 +25,12 @@ namespace merutilm::rff2 {
         };
 
 
+        explicit LightMPATable(const LightMandelbrotReference &reference, const FrtMPAAttribute *mpaSettings,
+                      ApproxTableCache &tableRef) : MPATable(reference, mpaSettings, tableRef) {
+
+        }
+
+
         ~LightMPATable() override = default;
 
         LightMPATable(const LightMPATable &) = delete;
@@ -34,10 +41,18 @@ namespace merutilm::rff2 {
 
         LightMPATable &operator=(LightMPATable &&) noexcept = delete;
 
-        LightPA *lookup(uint64_t refIteration, double dzr, double dzi) const;
+        const LightPA::Entry *lookup(uint64_t refIteration, double dzr, double dzi) const;
+
+        /**
+         * The same as lookup(), which is specialized for the selection and the compression method of the table.
+         */
+        template<FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION>
+        const LightPA::Entry *lookup(uint64_t refIteration, double dzr, double dzi) const;
 
         size_t getLength() override;
 
+        uint64_t validateSelection() const override;
+
     };
 
     // DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE
@@ -46,55 +61,86 @@ namespace merutilm::rff2 {
     // DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE
     // DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE  DEFINITION OF LIGHT MPA TABLE
 
-    inline LightPA *LightMPATable::lookup(const uint64_t refIteration, const double dzr, const double dzi) const {
+    inline const LightPA::Entry *LightMPATable::lookup(const uint64_t refIteration, const double dzr, const double dzi) const {
+        using enum FrtMPASelectionMethod;
+        using enum FrtMPACompressionMethod;
+        const bool lowest = mpaSettings.mpaSelectionMethod == LOWEST;
+        switch (mpaSettings.mpaCompressionMethod) {
+            case LITTLE_COMPRESSION:
+                return lowest
+                           ? lookup<LOWEST, LITTLE_COMPRESSION>(refIteration, dzr, dzi)
+                           : lookup<HIGHEST, LITTLE_COMPRESSION>(refIteration, dzr, dzi);
+            case STRONGEST:
+                return lowest
+                           ? lookup<LOWEST, STRONGEST>(refIteration, dzr, dzi)
+                           : lookup<HIGHEST, STRONGEST>(refIteration, dzr, dzi);
+            default:
+                return lowest
+                           ? lookup<LOWEST, NO_COMPRESSION>(refIteration, dzr, dzi)
+                           : lookup<HIGHEST, NO_COMPRESSION>(refIteration, dzr, dzi);
+        }
+    }
+
+    template<FrtMPASelectionMethod SELECTION, FrtMPACompressionMethod COMPRESSION>
+    const LightPA::Entry *LightMPATable::lookup(const uint64_t refIteration, const double dzr, const double dzi) const {
         if (refIteration == 0 || mpaPeriod == nullptr) {
             return nullptr;
         }
-        const uint64_t index = iterationToCompTableIndex(mpaSettings.mpaCompressionMethod, *mpaPeriod, pulledMPACompressor,
-                                                         refIteration);
+        const uint64_t index = iterationToCompTableIndex<COMPRESSION>(*mpaPeriod, pulledMPACompressor, refIteration);
 
-        if (index >= tableRef.lightTable.size()) {
+        const auto &table = tableRef.lightTable;
+        if (index >= table.size()) {
             return nullptr;
         }
 
-        std::vector<LightPA> &table = tableRef.lightTable[index];
-        if (table.empty()) {
+        const uint64_t begin = table.offsets[index];
+        const uint64_t end = table.offsets[index + 1];
+        if (begin == end) {
             return nullptr;
         }
 
-        const double r = rff_math::hypot_approx(dzr, dzi);
+        const uint64_t key = LightPA::Bound::key(rff_math::hypot_approx(dzr, dzi));
+        const LightPA::Bound *bounds = table.bounds.data();
+        const LightPA::Entry *pas = table.pas.data();
 
-        switch (mpaSettings.mpaSelectionMethod) {
-            using enum FrtMPASelectionMethod;
-            case LOWEST: {
-                LightPA *pa = nullptr;
-
-                for (LightPA &test: table) {
-                    if (test.isValid(r)) {
-                        pa = &test;
-                    } else return pa;
-                }
-                return pa;
-            }
-            case HIGHEST: {
-                LightPA &pa = table.front();
-                //This table cannot be empty because the pre-processing is done.
-
-                if (!pa.isValid(r)) {
-                    return nullptr;
-                }
+        const uint64_t j = selectPA<SELECTION>(begin, end, [bounds, pas, key](const uint64_t i) {
+            return bounds[i].isValid(key, pas[i]);
+        });
+        return j == UINT64_MAX ? nullptr : &pas[j];
+    }
 
-                for (uint64_t j = table.size(); j > 0; --j) {
-                    LightPA &test = table[j - 1];
-                    if (test.isValid(r)) {
-                        return &test;
+    inline uint64_t LightMPATable::validateSelection() const {
+        using enum FrtMPASelectionMethod;
+        const auto &table = tableRef.lightTable;
+        const bool lowest = mpaSettings.mpaSelectionMethod == LOWEST;
+        if (table.exactRadii.size() != table.pas.size()) {
+            return UINT64_MAX;
+        }
+        uint64_t mismatches = 0;
+
+        for (uint64_t index = 0; index < table.size(); ++index) {
+            const uint64_t begin = table.offsets[index];
+            const uint64_t end = table.offsets[index + 1];
+            for (uint64_t p = begin; p < end; ++p) {
+                const double radius = table.exactRadii[p];
+                for (const double r: {std::nextafter(radius, 0.0), radius, std::nextafter(radius, INFINITY)}) {
+                    const uint64_t key = LightPA::Bound::key(r);
+                    const auto compact = [&table, key](const uint64_t i) {
+                        return table.bounds[i].isValid(key, table.pas[i]);
+                    };
+                    // same as LightPA::isValid
+                    const auto exact = [&table, r](const uint64_t i) {
+                        return r < table.exactRadii[i];
+                    };
+                    if (lowest
+                            ? selectPA<LOWEST>(begin, end, compact) != selectPA<LOWEST>(begin, end, exact)
+                            : selectPA<HIGHEST>(begin, end, compact) != selectPA<HIGHEST>(begin, end, exact)) {
+                        ++mismatches;
                     }
                 }
-
-                return &pa;
             }
-            default: return nullptr;
         }
+        return mismatches;
     }
 
     inline size_t LightMPATable::getLength() {
@@ -3,11 +3,63 @@
 //
 
 #pragma once
+#include <bit>
+#include <cstdint>
+
 #include "../formula/LightMandelbrotReference.h"
 #include "PA.h"
 
 namespace merutilm::rff2 {
     struct LightPA final : public PA {
+        struct Entry;
+
+        /**
+         * The upper 32 bits of the radius, which the compact table scans from its own array.
+         * It is the radius rounded down to the float of the exponent range of double,
+         * and the lower bits in the entry are read only when the upper bits are the same as the compared one.
+         */
+        struct Bound {
+            uint32_t radiusHigh;
+
+            Bound() = default;
+
+            explicit Bound(const LightPA &pa);
+
+            /**
+             * @return the bits of the given distance to compare with the radius. The sign is dropped, so the negative zero is zero.
+             */
+            static uint64_t key(double dzRad);
+
+            /**
+             * The same as LightPA::isValid.
+             * @param key the key of the distance
+             * @param entry the entry of this bound, which is read only when the upper bits are the same
+             */
+            [[nodiscard]] bool isValid(uint64_t key, const Entry &entry) const;
+        };
+
+        /**
+         * The PA kept in the compact table. The skip is 32-bit, and is packed next to the lower bits of the radius.
+         * The coefficients and the radius are exact, so the selected PA and the result are the same as the generated one.
+         */
+        struct Entry {
+            double anr;
+            double ani;
+            double bnr;
+            double bni;
+            uint32_t skip;
+            uint32_t radiusLow;
+
+            Entry() = default;
+
+            explicit Entry(const LightPA &pa);
+
+            /**
+             * @return the exact radius, from the upper bits of the given bound
+             */
+            [[nodiscard]] double radius(const Bound &bound) const;
+        };
+
         const double anr;
         const double ani;
         const double bnr;
@@ -17,6 +69,12 @@ namespace merutilm::rff2 {
         LightPA(double anr, double ani, double bnr, double bni, uint64_t skip, double radius);
 
         bool isValid(double dzRad) const;
+
+        /**
+         * @return the bits of the radius kept in the compact table.
+         * The radius which is never valid is zero, also when the skip does not fit in 32 bits.
+         */
+        [[nodiscard]] uint64_t compactRadius() const;
     };
 
 
@@ -24,7 +82,36 @@ namespace merutilm::rff2 {
 
     }
 
+    static_assert(sizeof(LightPA::Entry) == 40);
+    static_assert(sizeof(LightPA::Bound) == 4);
+
+    inline LightPA::Bound::Bound(const LightPA &pa) : radiusHigh(static_cast<uint32_t>(pa.compactRadius() >> 32)) {
+    }
+
+    inline uint64_t LightPA::Bound::key(const double dzRad) {
+        return std::bit_cast<uint64_t>(dzRad) & 0x7fffffffffffffffULL;
+    }
+
+    inline bool LightPA::Bound::isValid(const uint64_t key, const Entry &entry) const {
+        // The bits of the positive doubles are in the same order as their values, so NaN is never valid.
+        const auto high = static_cast<uint32_t>(key >> 32);
+        return high < radiusHigh || (high == radiusHigh && static_cast<uint32_t>(key) < entry.radiusLow);
+    }
+
+    inline LightPA::Entry::Entry(const LightPA &pa) : anr(pa.anr), ani(pa.ani), bnr(pa.bnr), bni(pa.bni),
+                                                      skip(static_cast<uint32_t>(pa.skip)),
+                                                      radiusLow(static_cast<uint32_t>(pa.compactRadius())) {
+    }
+
+    inline double LightPA::Entry::radius(const Bound &bound) const {
+        return std::bit_cast<double>((static_cast<uint64_t>(bound.radiusHigh) << 32) | radiusLow);
+    }
+
     inline bool LightPA::isValid(const double dzRad) const {
         return dzRad < radius;
     }
+
+    inline uint64_t LightPA::compactRadius() const {
+        return skip <= UINT32_MAX && radius > 0 ? std::bit_cast<uint64_t>(radius) : 0;
+    }
 }
@@ -8,8 +8,8 @@
 
 namespace merutilm::rff2 {
     LightPAGenerator::LightPAGenerator(const LightMandelbrotReference &reference, const double epsilon, const double dcMax,
-                                                      const uint64_t start) : PAGenerator(start, 0, reference.compressor, epsilon), anr(1), ani(0), bnr(0), bni(0), radius(DBL_MAX),
-                                                                              refReal(reference.refReal), refImag(reference.refImag),
+                                                      const uint64_t start) : PAGenerator(start, 0, reference.compressor, reference.compressorOffsets, epsilon), anr(1), ani(0), bnr(0), bni(0), radius(DBL_MAX),
+                                                                              orbit(reference.orbit),
                                                                               dcMax(dcMax) {
     }
 
@@ -31,10 +31,11 @@ namespace merutilm::rff2 {
 
     void LightPAGenerator::step() {
         const uint64_t iter = start + skip++; //n+k
-        const uint64_t index = ArrayCompressor::compress(compressors, iter);
+        const uint64_t index = cursor.seek(iter);
 
-        const double z2r = 2 * refReal[index];
-        const double z2i = 2 * refImag[index];
+        const auto &[zr, zi] = orbit[index];
+        const double z2r = 2 * zr;
+        const double z2i = 2 * zi;
         const double anrStep = anr * z2r - ani * z2i;
         const double aniStep = anr * z2i + ani * z2r;
         const double bnrStep = bnr * z2r - bni * z2i + 1;
@@ -16,8 +16,7 @@ namespace merutilm::rff2 {
         double bnr;
         double bni;
         double radius;
-        const SegmentedVector<double>& refReal;
-        const SegmentedVector<double>& refImag;
+        const ReferenceOrbitStore &orbit;
         double dcMax;
 
     public:
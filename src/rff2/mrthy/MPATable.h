@@ -7,6 +7,10 @@
 
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <optional>
+#include <condition_variable>
+#include <mutex>
 
 #include "ArrayCompressionTool.h"
 #include "ArrayCompressor.h"
@@ -26,6 +30,10 @@ namespace merutilm::rff2 {
     template<typename Ref, typename Num>
     struct MPATable {
         static constexpr int REQUIRED_PERTURBATION = 2;
+        /**
+         * The table indices scanned at once to find the next stored PA, when the table index is the iteration.
+         */
+        static constexpr uint64_t NEXT_TABLE_SCAN_LIMIT = 64;
 
         const FrtMPAAttribute mpaSettings;
         std::vector<ArrayCompressionTool> pulledMPACompressor = std::vector<ArrayCompressionTool>();
@@ -38,6 +46,11 @@ namespace merutilm::rff2 {
                           std::function<void(uint64_t, double)> &&
                           actionPerCreatingTableIteration);
 
+        /**
+         * Creates the table which is already generated in the cache, such as the one read from the disk.
+         */
+        explicit MPATable(const Ref &reference, const FrtMPAAttribute *mpaSettings, ApproxTableCache &tableRef);
+
         virtual ~MPATable() = default;
 
     protected:
@@ -48,10 +61,85 @@ namespace merutilm::rff2 {
 
         static uint64_t binarySearch(const std::vector<uint64_t> &arr, uint64_t key);
 
+        /**
+         * The PA generator planned by the schedule, which is stored in the table. <br/>
+         * It depends only on the reference, its start and the PAs merged into it, so it can be generated on any thread.
+         */
+        struct ScheduledPA {
+            uint64_t start;
+            uint64_t skip = 0;
+            uint64_t steps = 0;
+            /**
+             * The steps before the merge, and the generator index of the merged PA.
+             */
+            std::vector<std::pair<uint64_t, uint64_t> > merges = {};
+            /**
+             * The index of the result kept for the merges. It is @code UINT64_MAX@endcode when the PA is never merged.
+             */
+            uint64_t merged = UINT64_MAX;
+        };
+
+        struct TableSchedule {
+            /**
+             * The generators which are stored in the table. The ones which are never stored are dropped while walking.
+             */
+            std::vector<ScheduledPA> generators;
+            /**
+             * The table index and the generator index, in the order that they are stored.
+             */
+            std::vector<std::pair<uint64_t, uint64_t> > pushes;
+            /**
+             * The table indices which exist even if no PA is stored.
+             */
+            std::vector<uint64_t> touched;
+            uint64_t mergedOutputs = 0;
+        };
+
+        /**
+         * The positions in the table of each generator, which are laid out from the pushes of the schedule.
+         * The positions of the generator g are @code positions[offsets[g]]@endcode to @code positions[offsets[g + 1] - 1]@endcode.
+         */
+        struct TableLayout {
+            std::vector<uint64_t> offsets;
+            std::vector<uint64_t> positions;
+        };
+
+        /**
+         * Generates the table into the table cache. <br/>
+         * The iterations are walked first without the PAs, to know which generator is stored where.
+         * The table is allocated from it, and the generators are run on the thread pool of the table cache.
+         * Each one is stored at its own positions as soon as it is built, so the table is the same whatever the number of threads is.
+         */
         template<typename PAB, typename PAG>
         void generateTable(const ParallelRenderState &state, const Ref &reference, Num dcMax,
+                           CompactPATable<PAB, Num> &table,
                            std::function<void(uint64_t, double)> &&actionPerCreatingTableIteration);
 
+        /**
+         * Walks the iterations of the table generation, only with the counts and the skips of the generators.
+         * @return @code false@endcode if interrupted
+         */
+        bool scheduleTable(const ParallelRenderState &state, TableSchedule &schedule) const;
+
+        /**
+         * Allocates the table for the pushes of the schedule, and lays out the positions of each generator.
+         * The pushes are released after that.
+         */
+        template<typename PAB>
+        TableLayout allocateTable(TableSchedule &schedule, CompactPATable<PAB, Num> &table) const;
+
+        /**
+         * Runs the generators of the schedule, and stores them at their positions of the table.
+         * Each thread takes the next generator, and waits for the main reference PAs before merging them.
+         * Only the main reference PAs are kept aside, for the merges.
+         * @return @code false@endcode if interrupted
+         */
+        template<typename PAB, typename PAG>
+        bool executeSchedule(const ParallelRenderState &state, const Ref &reference, const Num &dcMax,
+                             const TableSchedule &schedule, const TableLayout &layout,
+                             CompactPATable<PAB, Num> &table,
+                             const std::function<void(uint64_t, double)> &func) const;
+
         static uint64_t iterationToPulledTableIndex(const MPAPeriod &mpaPeriod, uint64_t iteration);
 
         static uint64_t iterationToCompTableIndex(const FrtMPACompressionMethod &mpaCompressionMethod,
@@ -59,8 +147,48 @@ namespace merutilm::rff2 {
                                                   const std::vector<ArrayCompressionTool> &pulledMPACompressor,
                                                   uint64_t iteration);
 
+        /**
+         * The same as iterationToCompTableIndex(), which is specialized for the compression method.
+         */
+        template<FrtMPACompressionMethod COMPRESSION>
+        static uint64_t iterationToCompTableIndex(const MPAPeriod &mpaPeriod,
+                                                  const std::vector<ArrayCompressionTool> &pulledMPACompressor,
+                                                  uint64_t iteration);
+
+        static uint64_t distanceToRemainder(const MPAPeriod &mpaPeriod, uint64_t iteration, uint64_t target);
+
+        /**
+         * Selects the PA of a table index by the selection method.
+         * @param begin the first position of the PAs of the table index
+         * @param end the position after the last PA, which is greater than the begin
+         * @param isValid whether the PA at the given position is valid for the distance
+         * @return the position of the selected PA, or @code UINT64_MAX@endcode when no PA is valid.
+         */
+        template<FrtMPASelectionMethod SELECTION, typename V>
+        static uint64_t selectPA(uint64_t begin, uint64_t end, V &&isValid);
+
     public:
         virtual size_t getLength() = 0;
+
+        /**
+         * Selects the PAs of the table by the compact radii and by the exact radii of the generated PAs,
+         * at each exact radius of the table and the next distances around it.
+         * It validates the compact table, and is not used for rendering.
+         * The table must be generated with @code keepExactRadii@endcode of the table cache.
+         * @return the number of the distances whose selected PAs are different,
+         * or @code UINT64_MAX@endcode when the table has no exact radii to compare with.
+         */
+        virtual uint64_t validateSelection() const = 0;
+
+        /**
+         * Gets the number of iterations from the given reference iteration in which no table can be found. <br/>
+         * It is a lower bound, and @code 0@endcode means the table may exist at the given iteration.
+         * The lookups in between can be skipped.
+         *
+         * @param refIteration the reference iteration
+         * @return the distance to the next iteration that may have the table.
+         */
+        uint64_t distanceToNextTable(uint64_t refIteration) const;
     };
 
     // ========================================================================
@@ -77,14 +205,20 @@ namespace merutilm::rff2 {
         initTable(reference);
 
         if constexpr (std::is_same_v<Ref, LightMandelbrotReference>) {
-            generateTable<LightPA, LightPAGenerator>(state, reference, dcMax,
+            generateTable<LightPA, LightPAGenerator>(state, reference, dcMax, tableRef.lightTable,
                                                      std::move(actionPerCreatingTableIteration));
         } else {
-            generateTable<DeepPA, DeepPAGenerator>(state, reference, dcMax,
+            generateTable<DeepPA, DeepPAGenerator>(state, reference, dcMax, tableRef.deepTable,
                                                     std::move(actionPerCreatingTableIteration));
         }
     }
 
+    template<typename Ref, typename Num>
+    MPATable<Ref, Num>::MPATable(const Ref &reference, const FrtMPAAttribute *mpaSettings, ApproxTableCache &tableRef)
+        : mpaSettings(*mpaSettings), tableRef(tableRef) {
+        initTable(reference);
+    }
+
     template<typename Ref, typename Num>
     void MPATable<Ref, Num>::initTable(const MandelbrotReference &reference) {
         const auto &referencePeriod = reference.period;
@@ -157,88 +291,147 @@ namespace merutilm::rff2 {
     template<typename PAB, typename PAG>
     void MPATable<Ref, Num>::generateTable(const ParallelRenderState &state, const Ref &reference,
                                             Num dcMax,
+                                           CompactPATable<PAB, Num> &table,
                                            std::function<void(uint64_t, double)> &&actionPerCreatingTableIteration) {
         const auto func = std::move(actionPerCreatingTableIteration);
         initTable(reference);
+        table.allocate({0}, tableRef.storage);
 
         if (mpaPeriod == nullptr) {
             return;
         }
 
-        SparseVector<std::vector<PAB>> *tablePtr;
+        if (mpaPeriod->tablePeriod.back() < mpaSettings.minSkipReference) {
+            return;
+        }
 
-        if constexpr (std::is_same_v<LightPA, PAB>) {
-            tablePtr = &tableRef.lightTable;
-        } else {
-            tablePtr = &tableRef.deepTable;
+        auto schedule = TableSchedule();
+        if (!scheduleTable(state, schedule)) {
+            return;
+        }
+
+        const TableLayout layout = allocateTable(schedule, table);
+        if (!executeSchedule<PAB, PAG>(state, reference, dcMax, schedule, layout, table, func)) {
+            table.allocate({0}, tableRef.storage);
+        }
+    }
+
+    template<typename Ref, typename Num>
+    template<typename PAB>
+    typename MPATable<Ref, Num>::TableLayout MPATable<Ref, Num>::allocateTable(TableSchedule &schedule,
+                                                                              CompactPATable<PAB, Num> &table) const {
+        uint64_t length = 0;
+        for (const uint64_t index: schedule.touched) {
+            length = std::max(length, index + 1);
+        }
+        for (const auto &[index, generator]: schedule.pushes) {
+            length = std::max(length, index + 1);
         }
 
-        auto &table = *tablePtr;
+        // The PAs of a table index are in the order of the pushes.
+        auto offsets = std::vector<uint64_t>(length + 1, 0);
+        for (const auto &[index, generator]: schedule.pushes) {
+            ++offsets[index + 1];
+        }
+        for (uint64_t i = 0; i < length; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+
+        auto layout = TableLayout{
+            .offsets = std::vector<uint64_t>(schedule.generators.size() + 1, 0),
+            .positions = std::vector<uint64_t>(schedule.pushes.size())
+        };
+        for (const auto &[index, generator]: schedule.pushes) {
+            ++layout.offsets[generator + 1];
+        }
+        for (uint64_t g = 0; g < schedule.generators.size(); ++g) {
+            layout.offsets[g + 1] += layout.offsets[g];
+        }
+
+        auto nextPosition = std::vector<uint64_t>(offsets.begin(), offsets.end() - 1);
+        auto nextSlot = std::vector<uint64_t>(layout.offsets.begin(), layout.offsets.end() - 1);
+        for (const auto &[index, generator]: schedule.pushes) {
+            layout.positions[nextSlot[generator]++] = nextPosition[index]++;
+        }
 
+        schedule.pushes = {};
+        schedule.touched = {};
+        table.allocate(std::move(offsets), tableRef.storage, tableRef.keepExactRadii);
+        return layout;
+    }
+
+    template<typename Ref, typename Num>
+    bool MPATable<Ref, Num>::scheduleTable(const ParallelRenderState &state, TableSchedule &schedule) const {
         const auto &tablePeriod = mpaPeriod->tablePeriod;
         const uint64_t longestPeriod = tablePeriod.back();
         const auto &tableElements = mpaPeriod->tableElements;
         const auto mpaCompressionMethod = mpaSettings.mpaCompressionMethod;
-        const auto epsilonPower = mpaSettings.epsilonPower;
-
-        if (longestPeriod < mpaSettings.minSkipReference) {
-            return;
-        }
 
-        const double epsilon = pow(10, epsilonPower);
         uint64_t iteration = 1;
         const size_t levels = tablePeriod.size();
         auto periodCount = std::vector<uint64_t>(levels, 0);
-        auto currentPA = std::vector<std::unique_ptr<PAG>>(levels);
-        auto dpTableTemps = std::array<dex, 8>();
+        // The generator of each level is kept here until it is stored, so the ones which are never stored are dropped.
+        auto currentPA = std::vector<std::optional<ScheduledPA> >(levels);
+        auto &generators = schedule.generators;
+
+        const auto step = [&currentPA](const uint64_t level) {
+            ++currentPA[level]->steps;
+            ++currentPA[level]->skip;
+        };
+
+        // table[0] is the main reference MPA, which is merged into the others while compressing.
+        auto mainReferenceMPA = std::vector<uint64_t>();
+
+        const auto pushStored = [&schedule, &mainReferenceMPA](const uint64_t index, const uint64_t generator) {
+            schedule.pushes.emplace_back(index, generator);
+            if (index == 0) {
+                if (ScheduledPA &pa = schedule.generators[generator]; pa.merged == UINT64_MAX) {
+                    pa.merged = schedule.mergedOutputs++;
+                }
+                mainReferenceMPA.push_back(generator);
+            }
+        };
 
-        table.clear();
+        const auto push = [&generators, &currentPA, &pushStored](const uint64_t index, const uint64_t level) {
+            generators.push_back(std::move(*currentPA[level]));
+            currentPA[level].reset();
+            pushStored(index, generators.size() - 1);
+        };
 
         // ============================================================================
-        // NO_COMPRESSION 
+        // NO_COMPRESSION
         // ============================================================================
         if (mpaCompressionMethod == FrtMPACompressionMethod::NO_COMPRESSION) {
             uint64_t absIteration = 0;
 
             while (iteration <= longestPeriod) {
-                if (absIteration % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 && 
+                if (absIteration % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 &&
                     state.interruptRequested()) {
-                    return;
+                    return false;
                 }
 
-                func(iteration, static_cast<double>(iteration) / static_cast<double>(longestPeriod));
-
                 bool resetLowerLevel = false;
 
                 for (uint64_t level = levels; level > 0; --level) {
                     const uint64_t i = level - 1;
 
                     if (periodCount[i] == 0) {
-                        if constexpr (std::is_same_v<PAG, LightPAGenerator>) {
-                            currentPA[i] = LightPAGenerator::create(reference, epsilon, dcMax, iteration);
-                        } else {
-                            currentPA[i] = DeepPAGenerator::create(reference, epsilon, dcMax,
-                                                                    iteration, dpTableTemps);
-                        }
+                        currentPA[i].emplace(ScheduledPA{.start = iteration});
                     }
 
-                    if (currentPA[i] != nullptr && 
+                    if (currentPA[i].has_value() &&
                         periodCount[i] + REQUIRED_PERTURBATION < tablePeriod[i]) {
-                        currentPA[i]->step();
+                        step(i);
                     }
 
                     periodCount[i]++;
 
                     if (periodCount[i] == tablePeriod[i]) {
-                        if (const PAG *currentLevel = currentPA[i].get();
-                            currentLevel != nullptr &&
-                            currentLevel->getSkip() == tablePeriod[i] - REQUIRED_PERTURBATION) {
-                            
-                            const uint64_t storeIndex = currentLevel->getStart();
-                            
-                            table[storeIndex].push_back(currentLevel->build());
+                        if (currentPA[i].has_value() &&
+                            currentPA[i]->skip == tablePeriod[i] - REQUIRED_PERTURBATION) {
+                            push(currentPA[i]->start, i);
                         }
-                        currentPA[i] = nullptr;
+                        currentPA[i].reset();
                         resetLowerLevel = true;
                     }
 
@@ -250,26 +443,22 @@ namespace merutilm::rff2 {
                 ++iteration;
                 ++absIteration;
             }
-            return;
+            return true;
         }
 
         // ============================================================================
         // STANDARD PATH (Compression Enabled)
         // ============================================================================
         uint64_t absIteration = 0;
-        
-        (void)table[0];
-        
-        const std::vector<PAB> &mainReferenceMPA = table[0];
+
+        schedule.touched.push_back(0);
 
         while (iteration <= longestPeriod) {
-            if (absIteration % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 && 
+            if (absIteration % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 &&
                 state.interruptRequested()) {
-                return;
+                return false;
             }
 
-            func(iteration, static_cast<double>(iteration) / static_cast<double>(longestPeriod));
-
             const uint64_t pulledTableIndex = iterationToPulledTableIndex(*mpaPeriod, iteration);
             const bool independent = ArrayCompressor::isIndependent(pulledMPACompressor, pulledTableIndex);
             const uint64_t containedIndex = ArrayCompressor::containedIndex(pulledMPACompressor,
@@ -282,29 +471,22 @@ namespace merutilm::rff2 {
                                                                 : &pulledMPACompressor[containedIndex];
                 containedTool != nullptr &&
                 containedTool->start == pulledTableIndex + 1) {
-                
+
                 const uint64_t level = binarySearch(tableElements,
                                                      containedTool->end - containedTool->start + 2);
                 const uint64_t compTableIndex = iterationToCompTableIndex(mpaCompressionMethod,
                                                                            *mpaPeriod,
-                                                                          pulledMPACompressor, 
+                                                                          pulledMPACompressor,
                                                                           iteration);
 
-                auto &pa = table[compTableIndex];
+                schedule.touched.push_back(compTableIndex);
 
                 if (level < mainReferenceMPA.size()) {
-                    const PAB &mainReferencePA = mainReferenceMPA[level];
-                    const uint64_t skip = mainReferencePA.skip;
+                    const uint64_t mainReferencePA = mainReferenceMPA[level];
+                    const uint64_t skip = generators[mainReferencePA].skip;
 
                     bool valid = true;
                     for (uint64_t i = level + 1; i < levels; ++i) {
-                        if (i <= level && periodCount[i] != 0) {
-                            vkh::logger::w_log_err(
-                                L"WARNING : Failed to compress!! \n what : the table period count {} is not zero.",
-                                periodCount[i]);
-                            valid = false;
-                            break;
-                        }
                         if (periodCount[i] + skip > tablePeriod[i] - REQUIRED_PERTURBATION) {
                             vkh::logger::w_log_err(
                                 L"WARNING : Failed to compress!! \n what : the table period count {} + skip {} exceeds its period {}.",
@@ -317,28 +499,20 @@ namespace merutilm::rff2 {
                     if (valid) {
                         for (uint64_t i = 0; i < levels; ++i) {
                             if (i <= level) {
-                                pa.push_back(mainReferenceMPA[i]);
+                                pushStored(compTableIndex, mainReferenceMPA[i]);
                                 uint64_t count = skip;
                                 for (uint64_t j = level; j > i; --j) {
                                     count %= tablePeriod[j - 1];
                                 }
-                                currentPA[i] = nullptr;
+                                currentPA[i].reset();
                                 periodCount[i] = count;
                             } else {
-                                if (currentPA[i] == nullptr) {
-                                    std::unique_ptr<PAG> generator = nullptr;
-                                    if constexpr (std::is_same_v<PAG, LightPAGenerator>) {
-                                        generator = LightPAGenerator::create(reference, epsilon,
-                                                                              dcMax, iteration);
-                                    } else {
-                                        generator = DeepPAGenerator::create(reference, epsilon,
-                                                                             dcMax, iteration, dpTableTemps);
-                                    }
-                                    generator->merge(mainReferencePA);
-                                    currentPA[i] = std::move(generator);
-                                } else {
-                                    currentPA[i]->merge(mainReferencePA);
+                                if (!currentPA[i].has_value()) {
+                                    currentPA[i].emplace(ScheduledPA{.start = iteration});
                                 }
+                                ScheduledPA &generator = *currentPA[i];
+                                generator.merges.emplace_back(generator.steps, mainReferencePA);
+                                generator.skip += skip;
                                 periodCount[i] += skip;
                             }
                         }
@@ -354,40 +528,33 @@ namespace merutilm::rff2 {
                 const uint64_t i = level - 1;
 
                 if (periodCount[i] == 0 && independent && notSkippedPureZero) {
-                    if constexpr (std::is_same_v<PAG, LightPAGenerator>) {
-                        currentPA[i] = LightPAGenerator::create(reference, epsilon, dcMax, iteration);
-                    } else {
-                        currentPA[i] = DeepPAGenerator::create(reference, epsilon, dcMax,
-                                                                iteration, dpTableTemps);
-                    }
+                    currentPA[i].emplace(ScheduledPA{.start = iteration});
                 }
 
-                if (currentPA[i] != nullptr && 
+                if (currentPA[i].has_value() &&
                     periodCount[i] + REQUIRED_PERTURBATION < tablePeriod[i]) {
-                    currentPA[i]->step();
+                    step(i);
                 }
 
                 periodCount[i]++;
 
                 if (periodCount[i] == tablePeriod[i]) {
-                    if (const PAG *currentLevel = currentPA[i].get();
-                        currentLevel != nullptr &&
-                        currentLevel->getSkip() == tablePeriod[i] - REQUIRED_PERTURBATION) {
-                        
+                    if (currentPA[i].has_value() &&
+                        currentPA[i]->skip == tablePeriod[i] - REQUIRED_PERTURBATION) {
+                        const uint64_t start = currentPA[i]->start;
                         const uint64_t compTableIndex = iterationToCompTableIndex(
-                            mpaCompressionMethod, *mpaPeriod, pulledMPACompressor, 
-                            currentLevel->getStart());
+                            mpaCompressionMethod, *mpaPeriod, pulledMPACompressor, start);
 
                         if (compTableIndex == UINT64_MAX) {
                             vkh::logger::w_log_err(
                                 L"FATAL : FAILED TO CREATING TABLE!!\n what : iteration {} is not pullable. aborting the table creation...",
-                                currentLevel->getStart());
-                            return;
+                                start);
+                            return true;
                         }
 
-                        table[compTableIndex].push_back(currentLevel->build());
+                        push(compTableIndex, i);
                     }
-                    currentPA[i] = nullptr;
+                    currentPA[i].reset();
                     resetLowerLevel = true;
                 }
 
@@ -399,6 +566,128 @@ namespace merutilm::rff2 {
             ++iteration;
             ++absIteration;
         }
+        return true;
+    }
+
+    template<typename Ref, typename Num>
+    template<typename PAB, typename PAG>
+    bool MPATable<Ref, Num>::executeSchedule(const ParallelRenderState &state, const Ref &reference,
+                                             const Num &dcMax, const TableSchedule &schedule,
+                                             const TableLayout &layout, CompactPATable<PAB, Num> &table,
+                                             const std::function<void(uint64_t, double)> &func) const {
+        const auto &generators = schedule.generators;
+        const double epsilon = pow(10, mpaSettings.epsilonPower);
+
+        // The main reference MPAs go first from the lowest level, because the others wait for them to merge.
+        // The rest are the longest first, to balance the threads.
+        auto order = std::vector<uint64_t>(generators.size());
+        uint64_t totalSteps = 0;
+        for (uint64_t g = 0; g < generators.size(); ++g) {
+            order[g] = g;
+            totalSteps += generators[g].steps;
+        }
+        std::ranges::stable_sort(order, [&generators](const uint64_t a, const uint64_t b) {
+            const ScheduledPA &pa = generators[a];
+            const ScheduledPA &pb = generators[b];
+            if ((pa.start == 1) != (pb.start == 1)) {
+                return pa.start == 1;
+            }
+            return pa.start == 1 ? pa.skip < pb.skip : pa.skip > pb.skip;
+        });
+
+        auto next = std::atomic<uint64_t>(0);
+        auto doneSteps = std::atomic<uint64_t>(0);
+        auto interrupted = std::atomic<bool>(false);
+
+        // The threads waiting for the merged PAs sleep until they are built, or the generation is interrupted.
+        auto merged = std::vector<std::optional<PAB> >(schedule.mergedOutputs);
+        std::mutex mergedMutex;
+        std::condition_variable mergedReady;
+
+        const auto interrupt = [&] {
+            {
+                std::scoped_lock lock(mergedMutex);
+                interrupted.store(true, std::memory_order_relaxed);
+            }
+            mergedReady.notify_all();
+        };
+
+        const auto work = [&](const bool reportProgress) {
+            auto dpTableTemps = std::array<dex, 8>();
+            uint64_t reportedSteps = 0;
+
+            for (uint64_t n = next.fetch_add(1); n < order.size(); n = next.fetch_add(1)) {
+                const uint64_t g = order[n];
+                const ScheduledPA &scheduled = generators[g];
+                std::unique_ptr<PAG> generator = nullptr;
+                if constexpr (std::is_same_v<PAG, LightPAGenerator>) {
+                    generator = LightPAGenerator::create(reference, epsilon, dcMax, scheduled.start);
+                } else {
+                    generator = DeepPAGenerator::create(reference, epsilon, dcMax, scheduled.start, dpTableTemps);
+                }
+
+                uint64_t stepped = 0;
+                const auto stepUntil = [&](const uint64_t steps) {
+                    for (; stepped < steps; ++stepped) {
+                        if (stepped % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 &&
+                            (interrupted.load(std::memory_order_relaxed) || state.interruptRequested())) {
+                            interrupt();
+                            return false;
+                        }
+                        generator->step();
+                        if (reportProgress) {
+                            func(++reportedSteps, static_cast<double>(doneSteps.load(std::memory_order_relaxed) + stepped) /
+                                                  static_cast<double>(totalSteps));
+                        }
+                    }
+                    return true;
+                };
+
+                for (const auto &[steps, mergedGenerator]: scheduled.merges) {
+                    if (!stepUntil(steps)) {
+                        return;
+                    }
+                    const uint64_t index = generators[mergedGenerator].merged;
+                    {
+                        std::unique_lock lock(mergedMutex);
+                        mergedReady.wait(lock, [&] {
+                            return merged[index].has_value() || interrupted.load(std::memory_order_relaxed);
+                        });
+                    }
+                    if (interrupted.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    generator->merge(*merged[index]);
+                }
+                if (!stepUntil(scheduled.steps)) {
+                    return;
+                }
+
+                const PAB pa = generator->build();
+                for (uint64_t p = layout.offsets[g]; p < layout.offsets[g + 1]; ++p) {
+                    table.set(layout.positions[p], pa);
+                }
+                if (scheduled.merged != UINT64_MAX) {
+                    {
+                        std::scoped_lock lock(mergedMutex);
+                        merged[scheduled.merged].emplace(pa);
+                    }
+                    mergedReady.notify_all();
+                }
+                doneSteps.fetch_add(scheduled.steps, std::memory_order_relaxed);
+            }
+        };
+
+        if (tableRef.threadPool == nullptr) {
+            work(true);
+        } else {
+            const auto threads = static_cast<uint32_t>(std::clamp<uint64_t>(tableRef.threads, 1, std::max<uint64_t>(order.size(), 1)));
+            tableRef.threadPool->run(threads, [&work](const uint32_t lane) {
+                work(lane == 0);
+            });
+        }
+
+        return !interrupted.load(std::memory_order_relaxed);
     }
 
     template<typename Ref, typename Num>
@@ -429,6 +718,77 @@ namespace merutilm::rff2 {
         return remainder == 1 ? index : UINT64_MAX;
     }
 
+    template<typename Ref, typename Num>
+    uint64_t MPATable<Ref, Num>::distanceToRemainder(const MPAPeriod &mpaPeriod, const uint64_t iteration,
+                                                     const uint64_t target) {
+        // Until the next boundary of any level, every remainder grows with the iteration,
+        // so the final remainder can only reach the target by counting up to it.
+        // At the boundary, the remainders of the lower levels are reset to 0 and count up to the target again.
+        const auto &tablePeriod = mpaPeriod.tablePeriod;
+
+        uint64_t distance = UINT64_MAX;
+        uint64_t remainder = iteration;
+
+        for (uint64_t i = tablePeriod.size(); i > 0; --i) {
+            const uint64_t period = tablePeriod[i - 1];
+            if (remainder >= period) {
+                remainder %= period;
+            }
+            distance = std::min(distance, period - remainder + target);
+        }
+
+        if (remainder <= target) {
+            distance = std::min(distance, target - remainder);
+        }
+        return distance;
+    }
+
+    template<typename Ref, typename Num>
+    template<FrtMPASelectionMethod SELECTION, typename V>
+    uint64_t MPATable<Ref, Num>::selectPA(const uint64_t begin, const uint64_t end, V &&isValid) {
+        if constexpr (SELECTION == FrtMPASelectionMethod::LOWEST) {
+            uint64_t j = begin;
+            while (j < end && isValid(j)) {
+                ++j;
+            }
+            return j == begin ? UINT64_MAX : j - 1;
+        } else {
+            //This table cannot be empty because the pre-processing is done.
+            if (!isValid(begin)) {
+                return UINT64_MAX;
+            }
+
+            for (uint64_t j = end; j > begin; --j) {
+                if (isValid(j - 1)) {
+                    return j - 1;
+                }
+            }
+
+            return begin;
+        }
+    }
+
+    template<typename Ref, typename Num>
+    uint64_t MPATable<Ref, Num>::distanceToNextTable(const uint64_t refIteration) const {
+        if (mpaPeriod == nullptr) {
+            return UINT64_MAX;
+        }
+        if (refIteration == 0) {
+            return 1;
+        }
+
+        if (mpaSettings.mpaCompressionMethod == FrtMPACompressionMethod::NO_COMPRESSION) {
+            // The table index is the iteration, so the offsets show where the PAs are stored, without any division.
+            // It also skips the levels whose PAs were all invalid.
+            if constexpr (std::is_same_v<Ref, LightMandelbrotReference>) {
+                return tableRef.lightTable.distanceToNextEntry(refIteration, NEXT_TABLE_SCAN_LIMIT);
+            } else {
+                return tableRef.deepTable.distanceToNextEntry(refIteration, NEXT_TABLE_SCAN_LIMIT);
+            }
+        }
+        return distanceToRemainder(*mpaPeriod, refIteration, 1);
+    }
+
     template<typename Ref, typename Num>
     uint64_t MPATable<Ref, Num>::iterationToCompTableIndex(
         const FrtMPACompressionMethod &mpaCompressionMethod,
@@ -438,16 +798,28 @@ namespace merutilm::rff2 {
         
         switch (mpaCompressionMethod) {
             using enum FrtMPACompressionMethod;
-            case NO_COMPRESSION: 
-                return iteration;
             case LITTLE_COMPRESSION: 
-                return iterationToPulledTableIndex(mpaPeriod, iteration);
-            case STRONGEST: {
-                const uint64_t index = iterationToPulledTableIndex(mpaPeriod, iteration);
-                return index == UINT64_MAX ? UINT64_MAX : ArrayCompressor::compress(pulledMPACompressor, index);
-            }
+                return iterationToCompTableIndex<LITTLE_COMPRESSION>(mpaPeriod, pulledMPACompressor, iteration);
+            case STRONGEST:
+                return iterationToCompTableIndex<STRONGEST>(mpaPeriod, pulledMPACompressor, iteration);
             default: 
-                return iteration;
+                return iterationToCompTableIndex<NO_COMPRESSION>(mpaPeriod, pulledMPACompressor, iteration);
+        }
+    }
+
+    template<typename Ref, typename Num>
+    template<FrtMPACompressionMethod COMPRESSION>
+    uint64_t MPATable<Ref, Num>::iterationToCompTableIndex(
+        const MPAPeriod &mpaPeriod,
+        const std::vector<ArrayCompressionTool> &pulledMPACompressor,
+        const uint64_t iteration) {
+        if constexpr (COMPRESSION == FrtMPACompressionMethod::LITTLE_COMPRESSION) {
+            return iterationToPulledTableIndex(mpaPeriod, iteration);
+        } else if constexpr (COMPRESSION == FrtMPACompressionMethod::STRONGEST) {
+            const uint64_t index = iterationToPulledTableIndex(mpaPeriod, iteration);
+            return index == UINT64_MAX ? UINT64_MAX : ArrayCompressor::compress(pulledMPACompressor, index);
+        } else {
+            return iteration;
         }
     }
 
@@ -5,6 +5,7 @@
 #pragma once
 #include <memory>
 
+#include "CompressedReferenceCursor.h"
 #include "PA.h"
 
 namespace merutilm::rff2 {
@@ -13,9 +14,10 @@ namespace merutilm::rff2 {
         uint64_t start;
         uint64_t skip;
         const std::vector<ArrayCompressionTool> &compressors;
+        CompressedReferenceCursor cursor;
         double epsilon;
 
-        explicit PAGenerator(uint64_t start, uint64_t skip, const std::vector<ArrayCompressionTool> &compressors, double epsilon);
+        explicit PAGenerator(uint64_t start, uint64_t skip, const std::vector<ArrayCompressionTool> &compressors, const std::vector<uint64_t> &compressorOffsets, double epsilon);
 
         uint64_t getStart() const;
 
@@ -29,8 +31,8 @@ namespace merutilm::rff2 {
 
     };
 
-    inline PAGenerator::PAGenerator(const uint64_t start, const uint64_t skip, const std::vector<ArrayCompressionTool> &compressors, const double epsilon) : start(
-        start), skip(skip), compressors(compressors), epsilon(epsilon) {
+    inline PAGenerator::PAGenerator(const uint64_t start, const uint64_t skip, const std::vector<ArrayCompressionTool> &compressors, const std::vector<uint64_t> &compressorOffsets, const double epsilon) : start(
+        start), skip(skip), compressors(compressors), cursor(compressors, compressorOffsets), epsilon(epsilon) {
     }
 
     inline uint64_t PAGenerator::getStart() const {
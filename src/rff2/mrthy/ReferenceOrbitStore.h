@@ -0,0 +1,130 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "SegmentStorage.h"
+#include "SegmentedVector.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Reference Orbit Store</b>
+     * <br/>
+     * The reference orbit of the light perturbator, which keeps the real and the imaginary part of each iteration side by side.
+     * A step of the perturbation reads one pair from one place, instead of the two segments of the separated parts.
+     * <li> The pairs are kept in the segments aligned to the cache line, so the huge orbit needs no contiguous memory.</li>
+     * <li> All segments up to the size are allocated, so the access has no null segment check.</li>
+     * <li> The segments are allocated by the same storage method as the parts, in their own arena.</li>
+     */
+    class ReferenceOrbitStore final {
+    public:
+        struct alignas(16) Pair {
+            double real;
+            double imag;
+        };
+
+        static constexpr size_t SEGMENT_BIT_SIZE = 16;
+        static constexpr size_t SEGMENT_SIZE = 1ULL << SEGMENT_BIT_SIZE;
+        static constexpr size_t MASK = SEGMENT_SIZE - 1;
+        static constexpr size_t CACHE_LINE = 64;
+        static constexpr size_t PAIRS_PER_LINE = CACHE_LINE / sizeof(Pair);
+        static constexpr size_t PREFETCH_DISTANCE = 2 * PAIRS_PER_LINE; // two cache lines ahead
+
+        using Storage = SegmentStorage;
+        using Part = SegmentedVector<double, SEGMENT_BIT_SIZE, Storage>;
+
+    private:
+        std::vector<SegmentPointer<Pair, Storage, SEGMENT_SIZE> > segments;
+        Storage storage;
+        size_t length = 0;
+
+    public:
+        ReferenceOrbitStore() = default;
+
+        /**
+         * Interleaves the parts of the orbit. Each segment of the parts is released as soon as it is moved,
+         * so the orbit is not held twice.
+         * @param real the real part of the orbit
+         * @param imag the imaginary part of the orbit, of the same size
+         */
+        ReferenceOrbitStore(Part &&real, Part &&imag);
+
+        ReferenceOrbitStore(const ReferenceOrbitStore &) = delete;
+
+        ReferenceOrbitStore &operator=(const ReferenceOrbitStore &) = delete;
+
+        ReferenceOrbitStore(ReferenceOrbitStore &&) noexcept = default;
+
+        ReferenceOrbitStore &operator=(ReferenceOrbitStore &&) noexcept = default;
+
+        [[nodiscard]] const Pair &operator[](uint64_t index) const;
+
+        /**
+         * @return the pairs from the given index to the end of its segment, which are contiguous in memory.
+         */
+        [[nodiscard]] std::span<const Pair> segmentSpan(uint64_t index) const;
+
+        /**
+         * Hints the CPU to load the pairs ahead of the given index, while the current one is iterated.
+         * It is done only at the first pair of each cache line, so it can be called at every step.
+         */
+        void prefetch(uint64_t index) const;
+
+        [[nodiscard]] size_t size() const;
+    };
+
+    // DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE
+    // DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE
+    // DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE
+    // DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE
+    // DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE  DEFINITION OF REFERENCE ORBIT STORE
+
+
+    inline ReferenceOrbitStore::ReferenceOrbitStore(Part &&real, Part &&imag)
+        : storage(real.get_storage()), length(real.size()) {
+        const size_t count = (length + MASK) >> SEGMENT_BIT_SIZE;
+        segments.reserve(count);
+
+        for (size_t s = 0; s < count; ++s) {
+            segments.push_back(allocateSegment<Pair, SEGMENT_SIZE>(storage));
+            Pair *segment = segments.back().get();
+
+            const size_t begin = s << SEGMENT_BIT_SIZE;
+            const auto realSpan = real.segment_span(begin);
+            const auto imagSpan = imag.segment_span(begin);
+            // The unallocated segment of the parts is zero.
+            for (size_t i = 0; i < SEGMENT_SIZE; ++i) {
+                segment[i] = Pair{
+                    realSpan.empty() ? 0 : realSpan[i],
+                    imagSpan.empty() ? 0 : imagSpan[i]
+                };
+            }
+            real.release_segment(begin);
+            imag.release_segment(begin);
+        }
+    }
+
+    inline const ReferenceOrbitStore::Pair &ReferenceOrbitStore::operator[](const uint64_t index) const {
+        return segments[index >> SEGMENT_BIT_SIZE][index & MASK];
+    }
+
+    inline std::span<const ReferenceOrbitStore::Pair> ReferenceOrbitStore::segmentSpan(const uint64_t index) const {
+        return {segments[index >> SEGMENT_BIT_SIZE].get() + (index & MASK), SEGMENT_SIZE - (index & MASK)};
+    }
+
+    inline void ReferenceOrbitStore::prefetch(const uint64_t index) const {
+#if defined(__GNUC__) || defined(__clang__)
+        if (const uint64_t ahead = index + PREFETCH_DISTANCE; (index & (PAIRS_PER_LINE - 1)) == 0 && ahead < length) {
+            __builtin_prefetch(&(*this)[ahead]);
+        }
+#endif
+    }
+
+    inline size_t ReferenceOrbitStore::size() const {
+        return length;
+    }
+}
@@ -0,0 +1,459 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#include "../attr/FrtSegmentStorageMethod.h"
+#include "../constants/FractalConstants.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Segment Arena</b>
+     * <br/>
+     * The chunks of the huge pages or of the scratch file, which the segments of a container are carved from.
+     * <li> The chunks are the multiples of the huge page, and each one is twice the previous one up to the max.
+     * So the segments are not rounded up to the huge page, and a huge container has a few mappings.</li>
+     * <li> The mapped file arena has one temporary file, which grows by each chunk. Each chunk maps its own range of it.</li>
+     * <li> The chunk is released when all its segments are released, and the arena moved on to the next one.</li>
+     * <li> The memory of the new chunk is zero, and no released memory is used again.</li>
+     */
+    class SegmentArena {
+    public:
+        static constexpr size_t HUGE_PAGE_SIZE = 2ULL << 20;
+        static constexpr size_t MAX_CHUNK_SIZE = 256ULL << 20;
+
+        /**
+         * The header of the chunk, which every segment of it points to.
+         */
+        struct Chunk;
+
+        SegmentArena(FrtSegmentStorageMethod method, std::filesystem::path directory);
+
+        ~SegmentArena();
+
+        SegmentArena(const SegmentArena &) = delete;
+
+        SegmentArena &operator=(const SegmentArena &) = delete;
+
+        SegmentArena(SegmentArena &&) = delete;
+
+        SegmentArena &operator=(SegmentArena &&) = delete;
+
+        /**
+         * @return the memory of the given bytes after the header, which points to its chunk.
+         */
+        [[nodiscard]] void *allocate(size_t bytes, size_t header);
+
+        /**
+         * Releases a segment of the chunk, and the chunk itself when it was the last one.
+         */
+        static void release(Chunk *chunk);
+
+    private:
+        struct File;
+
+        const FrtSegmentStorageMethod method;
+        const std::filesystem::path directory;
+        std::mutex mutex;
+        std::shared_ptr<File> file = nullptr;
+        Chunk *current = nullptr;
+        size_t used = 0;
+        size_t nextLength = HUGE_PAGE_SIZE;
+
+        Chunk *createChunk(size_t length);
+
+        static size_t roundUp(size_t bytes);
+    };
+
+    /**
+     * <b>Segment Storage</b>
+     * <br/>
+     * Where the segments of a container are allocated, which is chosen by the method.
+     * <li> The heap segments are aligned to the cache line. When the memory is full, the OS swaps them out.</li>
+     * <li> The huge page segments miss the TLB less on the random access of the iteration.
+     * The explicit huge pages are tried first. They need the reserved pages on Linux, and the "Lock pages in memory" privilege on Windows.
+     * Otherwise, the transparent huge pages are requested on Linux, and the normal pages are used on Windows.</li>
+     * <li> The mapped file segments are on the temporary file of the scratch directory, for the data larger than the memory.
+     * The OS writes back the cold pages to the file and reads them again on access, instead of the swap.
+     * The file is deleted when the arena is released, or when the process is terminated.</li>
+     * <li> Each container has its own arena, so the copied storage starts a new one.
+     * The segment is released without the storage, by the header before it.</li>
+     */
+    struct SegmentStorage {
+        static constexpr size_t ALIGNMENT = 64;
+        static constexpr size_t HEADER = ALIGNMENT;
+
+        FrtSegmentStorageMethod method = FrtSegmentStorageMethod::HEAP;
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / Constants::Fractal::SCRATCH_DIRECTORY;
+
+    private:
+        mutable std::unique_ptr<SegmentArena> arena = nullptr;
+
+    public:
+        SegmentStorage() = default;
+
+        /**
+         * @param method where the segments are allocated
+         * @param directory the scratch directory of the mapped file, the default one when it is empty
+         */
+        SegmentStorage(FrtSegmentStorageMethod method, const std::string &directory);
+
+        SegmentStorage(const SegmentStorage &other);
+
+        SegmentStorage &operator=(const SegmentStorage &other);
+
+        SegmentStorage(SegmentStorage &&) noexcept = default;
+
+        SegmentStorage &operator=(SegmentStorage &&) noexcept = default;
+
+        ~SegmentStorage() = default;
+
+        /**
+         * @param directory the scratch directory of the settings in UTF-8, the default one when it is empty
+         * @return the scratch directory to use
+         */
+        static std::filesystem::path scratchDirectory(const std::string &directory);
+
+        /**
+         * @return whether the allocated memory is zero, so the trivial elements need not be written.
+         */
+        [[nodiscard]] bool isZeroed() const;
+
+        [[nodiscard]] void *allocate(size_t bytes) const;
+
+        static void deallocate(void *segment, size_t bytes);
+    };
+
+    /**
+     * Destroys the elements of the segment and returns it to the storage.
+     */
+    template<typename T, typename Storage, size_t SIZE>
+    struct SegmentDeleter {
+        void operator()(T *segment) const {
+            std::destroy_n(segment, SIZE);
+            Storage::deallocate(segment, SIZE * sizeof(T));
+        }
+    };
+
+    template<typename T, typename Storage, size_t SIZE>
+    using SegmentPointer = std::unique_ptr<T[], SegmentDeleter<T, Storage, SIZE> >;
+
+    /**
+     * Allocates the segment from the storage, and value-initializes its elements.
+     * The trivial elements of the zeroed storage are not written, so the untouched pages are not committed.
+     */
+    template<typename T, size_t SIZE, typename Storage>
+    SegmentPointer<T, Storage, SIZE> allocateSegment(const Storage &storage) {
+        auto *segment = static_cast<T *>(storage.allocate(SIZE * sizeof(T)));
+        if (!storage.isZeroed() || !std::is_trivially_default_constructible_v<T>) {
+            std::uninitialized_value_construct_n(segment, SIZE);
+        }
+        return SegmentPointer<T, Storage, SIZE>(segment);
+    }
+
+    /**
+     * The allocator of the contiguous array on the storage, for @code std::vector@endcode.
+     */
+    template<typename T, typename Storage>
+    struct SegmentAllocator {
+        using value_type = T;
+
+        Storage storage;
+
+        SegmentAllocator() = default;
+
+        explicit SegmentAllocator(Storage storage) : storage(std::move(storage)) {
+        }
+
+        template<typename U>
+        explicit(false) SegmentAllocator(const SegmentAllocator<U, Storage> &other) : storage(other.storage) {
+        }
+
+        [[nodiscard]] T *allocate(const size_t n) const {
+            return static_cast<T *>(storage.allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T *p, const size_t n) const {
+            Storage::deallocate(p, n * sizeof(T));
+        }
+
+        // The memory of any storage is released without the storage itself.
+        template<typename U>
+        bool operator==(const SegmentAllocator<U, Storage> &) const {
+            return true;
+        }
+    };
+
+    // DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE
+    // DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE
+    // DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE
+    // DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE
+    // DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE  DEFINITION OF SEGMENT STORAGE
+
+
+    struct SegmentArena::File {
+#ifdef _WIN32
+        HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+        int descriptor = -1;
+#endif
+        uint64_t size = 0;
+
+        explicit File(const std::filesystem::path &directory) {
+            std::error_code error;
+            std::filesystem::create_directories(directory, error);
+#ifdef _WIN32
+            static std::atomic<uint64_t> sequence = 0;
+            const auto path = directory / (L"arena_" + std::to_wstring(GetCurrentProcessId()) + L"_" +
+                                           std::to_wstring(sequence.fetch_add(1, std::memory_order_relaxed)));
+            handle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_NEW,
+                                 FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE | FILE_FLAG_SEQUENTIAL_SCAN,
+                                 nullptr);
+            if (handle == INVALID_HANDLE_VALUE) {
+                throw std::bad_alloc();
+            }
+#else
+            auto path = (directory / "arena_XXXXXX").string();
+            descriptor = mkstemp(path.data());
+            if (descriptor < 0) {
+                throw std::bad_alloc();
+            }
+            // The descriptor and the mappings keep the file, so it is deleted when all of them are released.
+            unlink(path.c_str());
+#endif
+        }
+
+        ~File() {
+#ifdef _WIN32
+            CloseHandle(handle);
+#else
+            close(descriptor);
+#endif
+        }
+
+        File(const File &) = delete;
+
+        File &operator=(const File &) = delete;
+
+        File(File &&) = delete;
+
+        File &operator=(File &&) = delete;
+    };
+
+    struct SegmentArena::Chunk {
+        std::byte *base = nullptr;
+        size_t length = 0;
+        uint64_t offset = 0;
+        FrtSegmentStorageMethod method = FrtSegmentStorageMethod::HEAP;
+        std::shared_ptr<File> file = nullptr;
+        // The segments, and the arena while it is the current chunk. The own chunk of a large one has only it.
+        std::atomic<uint64_t> references = 1;
+    };
+
+    inline SegmentArena::SegmentArena(const FrtSegmentStorageMethod method, std::filesystem::path directory) : method(method),
+        directory(std::move(directory)) {
+    }
+
+    inline SegmentArena::~SegmentArena() {
+        if (current != nullptr) {
+            release(current);
+        }
+    }
+
+    inline size_t SegmentArena::roundUp(const size_t bytes) {
+        return (std::max<size_t>(bytes, 1) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+
+    inline void *SegmentArena::allocate(const size_t bytes, const size_t header) {
+        // The header is also the alignment of the segments.
+        const size_t needed = (bytes + 2 * header - 1) / header * header;
+        std::scoped_lock lock(mutex);
+        Chunk *chunk;
+        std::byte *memory;
+        if (needed > nextLength) {
+            // The larger one than the next chunk has its own chunk, so it is unmapped as soon as it is released.
+            chunk = createChunk(roundUp(needed));
+            memory = chunk->base;
+        } else {
+            if (current == nullptr || used + needed > current->length) {
+                if (current != nullptr) {
+                    release(current);
+                }
+                current = createChunk(nextLength);
+                used = 0;
+                nextLength = std::min(nextLength * 2, MAX_CHUNK_SIZE);
+            }
+            chunk = current;
+            memory = chunk->base + used;
+            used += needed;
+            chunk->references.fetch_add(1, std::memory_order_relaxed);
+        }
+        *reinterpret_cast<Chunk **>(memory) = chunk;
+        return memory + header;
+    }
+
+    inline SegmentArena::Chunk *SegmentArena::createChunk(const size_t length) {
+        auto chunk = std::make_unique<Chunk>();
+        chunk->length = length;
+        chunk->method = method;
+        if (method == FrtSegmentStorageMethod::MAPPED_FILE) {
+            if (file == nullptr) {
+                file = std::make_shared<File>(directory);
+            }
+            chunk->file = file;
+            chunk->offset = file->size;
+            const uint64_t size = file->size + length;
+#ifdef _WIN32
+            const HANDLE mapping = CreateFileMappingW(file->handle, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32),
+                                                      static_cast<DWORD>(size), nullptr);
+            // The view keeps the mapping, so the handle is closed here.
+            void *view = mapping == nullptr
+                             ? nullptr
+                             : MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, static_cast<DWORD>(chunk->offset >> 32),
+                                             static_cast<DWORD>(chunk->offset), length);
+            if (mapping != nullptr) {
+                CloseHandle(mapping);
+            }
+            if (view == nullptr) {
+                throw std::bad_alloc();
+            }
+#else
+            void *view = ftruncate(file->descriptor, static_cast<off_t>(size)) == 0
+                             ? mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, file->descriptor,
+                                    static_cast<off_t>(chunk->offset))
+                             : MAP_FAILED;
+            if (view == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            madvise(view, length, MADV_SEQUENTIAL);
+#endif
+            file->size = size;
+            chunk->base = static_cast<std::byte *>(view);
+            return chunk.release();
+        }
+
+#ifdef _WIN32
+        void *memory = nullptr;
+        if (const SIZE_T large = GetLargePageMinimum(); large > 0 && length % large == 0) {
+            memory = VirtualAlloc(nullptr, length, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+        }
+        if (memory == nullptr) {
+            memory = VirtualAlloc(nullptr, length, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        }
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+#else
+        void *memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (memory == MAP_FAILED) {
+            memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+#ifdef MADV_HUGEPAGE
+            madvise(memory, length, MADV_HUGEPAGE);
+#endif
+        }
+#endif
+        chunk->base = static_cast<std::byte *>(memory);
+        return chunk.release();
+    }
+
+    inline void SegmentArena::release(Chunk *chunk) {
+        if (chunk->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+#ifdef _WIN32
+        if (chunk->method == FrtSegmentStorageMethod::MAPPED_FILE) {
+            UnmapViewOfFile(chunk->base);
+        } else {
+            VirtualFree(chunk->base, 0, MEM_RELEASE);
+        }
+#else
+        munmap(chunk->base, chunk->length);
+#ifdef FALLOC_FL_PUNCH_HOLE
+        // The range of the file is freed too, although the file keeps its size.
+        if (chunk->file != nullptr) {
+            fallocate(chunk->file->descriptor, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                      static_cast<off_t>(chunk->offset), static_cast<off_t>(chunk->length));
+        }
+#endif
+#endif
+        delete chunk;
+    }
+
+
+    inline SegmentStorage::SegmentStorage(const FrtSegmentStorageMethod method, const std::string &directory) :
+        method(method), directory(scratchDirectory(directory)) {
+    }
+
+    inline std::filesystem::path SegmentStorage::scratchDirectory(const std::string &directory) {
+        // The directory of the settings is UTF-8.
+        if (directory.empty()) {
+            return std::filesystem::temp_directory_path() / Constants::Fractal::SCRATCH_DIRECTORY;
+        }
+        return {std::u8string(directory.begin(), directory.end())};
+    }
+
+    inline SegmentStorage::SegmentStorage(const SegmentStorage &other) : method(other.method), directory(other.directory) {
+    }
+
+    inline SegmentStorage &SegmentStorage::operator=(const SegmentStorage &other) {
+        if (this != &other) {
+            method = other.method;
+            directory = other.directory;
+            arena = nullptr;
+        }
+        return *this;
+    }
+
+    inline bool SegmentStorage::isZeroed() const {
+        return method != FrtSegmentStorageMethod::HEAP;
+    }
+
+    inline void *SegmentStorage::allocate(const size_t bytes) const {
+        if (method == FrtSegmentStorageMethod::HEAP) {
+            auto *memory = static_cast<std::byte *>(::operator new(bytes + HEADER, std::align_val_t{ALIGNMENT}));
+            *reinterpret_cast<SegmentArena::Chunk **>(memory) = nullptr;
+            return memory + HEADER;
+        }
+        if (arena == nullptr) {
+            arena = std::make_unique<SegmentArena>(method, directory);
+        }
+        return arena->allocate(bytes, HEADER);
+    }
+
+    inline void SegmentStorage::deallocate(void *segment, size_t) {
+        if (segment == nullptr) {
+            return;
+        }
+        auto *memory = static_cast<std::byte *>(segment) - HEADER;
+        if (auto *chunk = *reinterpret_cast<SegmentArena::Chunk **>(memory); chunk != nullptr) {
+            SegmentArena::release(chunk);
+            return;
+        }
+        ::operator delete(memory, std::align_val_t{ALIGNMENT});
+    }
+}
@@ -6,13 +6,17 @@
 
 #include <vector>
 #include <memory>
+#include <span>
 #include <cassert>
 #include <cstring>
 #include <stdexcept>
 
+#include "SegmentStorage.h"
+
 namespace merutilm::rff2 {
 
-    template<typename T, size_t SEGMENT_BIT_SIZE = 16>
+    // Storage is where the segments are allocated, see SegmentStorage.h
+    template<typename T, size_t SEGMENT_BIT_SIZE = 16, typename Storage = SegmentStorage>
     class SegmentedVector {
     public:
         static constexpr size_t SEGMENT_SIZE = 1ULL << SEGMENT_BIT_SIZE;
@@ -24,7 +28,10 @@ namespace merutilm::rff2 {
         using size_type = size_t;
 
     private:
-        std::vector<std::unique_ptr<T[]>> segments;
+        using Segment = SegmentPointer<T, Storage, SEGMENT_SIZE>;
+
+        std::vector<Segment> segments;
+        Storage storage;
         size_type m_size = 0;
         size_type m_logical_capacity = 0;
 
@@ -33,13 +40,15 @@ namespace merutilm::rff2 {
                 segments.resize(segment_index + 1);
             }
             if (!segments[segment_index]) {
-                segments[segment_index] = std::make_unique<T[]>(SEGMENT_SIZE);
+                segments[segment_index] = allocateSegment<T, SEGMENT_SIZE>(storage);
             }
         }
 
     public:
         SegmentedVector() = default;
 
+        explicit SegmentedVector(Storage storage) : storage(std::move(storage)) {}
+
         SegmentedVector(const SegmentedVector&) = delete;
         SegmentedVector& operator=(const SegmentedVector&) = delete;
 
@@ -63,6 +72,18 @@ namespace merutilm::rff2 {
             return segments[seg_idx][index & MASK];
         }
 
+        // The elements from the given index to the end of its segment, which are contiguous in memory.
+        // Empty if the segment is not allocated.
+        std::span<const T> segment_span(size_type index) const {
+            size_type seg_idx = index >> SEGMENT_BIT_SIZE;
+            if (seg_idx >= segments.size() || !segments[seg_idx]) {
+                return {};
+            }
+            return {segments[seg_idx].get() + (index & MASK), SEGMENT_SIZE - (index & MASK)};
+        }
+
+        const Storage& get_storage() const noexcept { return storage; }
+
         reference back() { return (*this)[m_size - 1]; }
         const_reference back() const { return (*this)[m_size - 1]; }
 
@@ -134,6 +155,14 @@ namespace merutilm::rff2 {
             return seg_idx < segments.size() && segments[seg_idx] != nullptr;
         }
 
+        // Frees the segment of the given index, when its elements are moved elsewhere. The size is not changed.
+        void release_segment(size_type index) {
+            size_type seg_idx = index >> SEGMENT_BIT_SIZE;
+            if (seg_idx < segments.size()) {
+                segments[seg_idx].reset();
+            }
+        }
+
         size_type allocated_memory() const {
             size_type count = 0;
             for (const auto& seg : segments) {
@@ -0,0 +1,356 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "CompressedReferenceCursor.h"
+#include "../attr/FractalAttribute.h"
+#include "../calc/dex.h"
+#include "../constants/Constants.hpp"
+#include "../formula/MandelbrotContinuation.h"
+#include "../parallel/ParallelRenderState.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Series Approximation</b>
+     * <br/>
+     * The skip of the first iterations, which is shared by all pixels of the frame. <br/>
+     * While the delta is small, it is a polynomial of dc. So the polynomial is iterated once for the frame,
+     * and every pixel starts at the skipped iteration with the delta evaluated from it.
+     * <li> dz = Σ a_k * u^k (k = 1..terms), u = dc / r, where r is the distance of the farthest probe.
+     * a_k = m_k * 2^scale, so the coefficients are the double mantissas with the shared exponent, and they do not underflow in the deep zoom.</li>
+     * <li> dz/dz1 = Σ b_k * u^k (k = 0..terms-1) is iterated in the same way, only when the interior detection needs it.</li>
+     * <li> The iteration is skipped until the step which is not valid for all pixels.
+     * The truncated terms must be small, the delta must neither rebase nor escape in the disk, and the series must match the probes.
+     * The deltas of the probes are iterated together, and the ones of the corner pixels are enough since the disk is bounded by them.</li>
+     */
+    class SeriesApproximation final {
+        struct Coefficients {
+            std::vector<double> mr;
+            std::vector<double> mi;
+            std::vector<double> br;
+            std::vector<double> bi;
+            int scale = 0;
+            int derScale = 0;
+        };
+
+        Coefficients coefficients;
+        dex inverseRadius = dex::ZERO;
+        uint64_t skip = 0;
+        double zr = 0;
+        double zi = 0;
+        bool derivative = false;
+
+    public:
+        static constexpr double RESCALE_MAX = 0x1p64;
+        static constexpr double RESCALE_MIN = 0x1p-64;
+
+        /**
+         * Iterates the series along the reference, until it is not valid.
+         * @param state the state to check the interruption
+         * @param reference the reference of the perturbator
+         * @param calc the attribute of the frame. The number of the terms and the epsilon are from its MPA attribute.
+         * @param probes the offsets of the farthest pixels from the center
+         * @param offR the real part of the offset from the reference to the center
+         * @param offI the imaginary part of the offset from the reference to the center
+         * @return the series, or @code nullptr@endcode if it is disabled, interrupted, or skips fewer iterations than its terms.
+         */
+        template<typename Ref>
+        static std::unique_ptr<SeriesApproximation> create(const ParallelRenderState &state, const Ref &reference,
+                                                           const FractalAttribute &calc,
+                                                           std::span<const std::array<dex, 2> > probes,
+                                                           const dex &offR, const dex &offI);
+
+        [[nodiscard]] uint64_t getSkip() const;
+
+        /**
+         * @param dcr the real part of the pixel offset from the reference
+         * @param dci the imaginary part of the pixel offset from the reference
+         * @return the state of the pixel at the skipped iteration
+         */
+        [[nodiscard]] MandelbrotContinuation evaluate(const dex &dcr, const dex &dci) const;
+
+    private:
+        /**
+         * @return v / 2^scale as double
+         */
+        static double scaledMantissa(const dex &v, int scale);
+
+        /**
+         * Rescales the mantissas when the largest one leaves the safe range.
+         * @return the exponent which is added to their scale
+         */
+        static int rescale(std::vector<double> &re, std::vector<double> &im);
+    };
+
+    // DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION
+    // DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION
+    // DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION
+    // DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION
+    // DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION  DEFINITION OF SERIES APPROXIMATION
+
+
+    template<typename Ref>
+    std::unique_ptr<SeriesApproximation> SeriesApproximation::create(
+        const ParallelRenderState &state, const Ref &reference, const FractalAttribute &calc,
+        const std::span<const std::array<dex, 2> > probes, const dex &offR, const dex &offI) {
+        const size_t terms = calc.mpaAttribute.seriesApproximationTerms;
+        const uint64_t maxRefIteration = reference.longestPeriod();
+        if (terms == 0 || probes.empty() || calc.absoluteIterationMode ||
+            std::min(maxRefIteration, calc.maxIteration) <= terms) {
+            return nullptr;
+        }
+
+        // The probes from the reference, and the radius of the disk
+        const size_t probeCount = probes.size();
+        auto pr = std::vector<dex>(probeCount);
+        auto pi = std::vector<dex>(probeCount);
+        int probeExponent = INT32_MIN;
+        for (size_t p = 0; p < probeCount; ++p) {
+            pr[p] = probes[p][0] + offR;
+            pi[p] = probes[p][1] + offI;
+            for (const dex &v: {pr[p], pi[p]}) {
+                if (v.sgn() != 0) {
+                    probeExponent = std::max(probeExponent, v.get_exp2());
+                }
+            }
+        }
+        if (probeExponent == INT32_MIN) {
+            return nullptr;
+        }
+        double radiusMantissa = 0;
+        for (size_t p = 0; p < probeCount; ++p) {
+            radiusMantissa = std::max(radiusMantissa, std::hypot(scaledMantissa(pr[p], probeExponent),
+                                                                 scaledMantissa(pi[p], probeExponent)));
+        }
+        dex radius = dex(probeExponent, radiusMantissa);
+        dex::normalize(&radius);
+
+        auto result = std::make_unique<SeriesApproximation>();
+        result->inverseRadius = dex::ONE / radius;
+        result->derivative = calc.interiorDetectionMethod != FrtInteriorDetectionMethod::NONE;
+        const bool derivative = result->derivative;
+        const double epsilon = std::pow(10.0, calc.mpaAttribute.epsilonPower);
+        const double bailout = calc.bailout;
+        const uint64_t maxSkip = std::min(maxRefIteration, calc.maxIteration) - 1;
+
+        // dz = 0 and dz/dz1 = 1 at the iteration zero
+        auto current = Coefficients{
+            .mr = std::vector<double>(terms), .mi = std::vector<double>(terms),
+            .br = std::vector<double>(terms), .bi = std::vector<double>(terms),
+            .scale = radius.get_exp2(), .derScale = 0
+        };
+        current.br[0] = 1;
+        auto next = current;
+
+        // The deltas of the probes, and dc of them, in the scale of the coefficients.
+        auto ur = std::vector<double>(probeCount);
+        auto ui = std::vector<double>(probeCount);
+        auto qr = std::vector<double>(probeCount);
+        auto qi = std::vector<double>(probeCount);
+        auto cr = std::vector<double>(probeCount);
+        auto ci = std::vector<double>(probeCount);
+        double rc = scaledMantissa(radius, current.scale);
+        for (size_t p = 0; p < probeCount; ++p) {
+            ur[p] = static_cast<double>(pr[p] * result->inverseRadius);
+            ui[p] = static_cast<double>(pi[p] * result->inverseRadius);
+            cr[p] = scaledMantissa(pr[p], current.scale);
+            ci[p] = scaledMantissa(pi[p], current.scale);
+        }
+
+        auto cursor = CompressedReferenceCursor(reference.compressor, reference.compressorOffsets);
+        uint64_t index = cursor.seek(0);
+        // The light reference keeps the pairs of double, and the deep reference keeps the records of dex.
+        const auto loadReference = [&reference](const uint64_t i) -> std::pair<double, double> {
+            if constexpr (requires { reference.orbit[i].real; }) {
+                return {reference.orbit[i].real, reference.orbit[i].imag};
+            } else {
+                return {static_cast<double>(reference.orbit.real(i)), static_cast<double>(reference.orbit.imag(i))};
+            }
+        };
+        auto [refR, refI] = loadReference(index);
+        int checkCounter = Constants::Fractal::EXIT_CHECK_INTERVAL;
+
+        for (uint64_t n = 0; n < maxSkip; ++n) {
+            if (--checkCounter == 0) {
+                if (state.interruptRequested()) {
+                    return nullptr;
+                }
+                checkCounter = Constants::Fractal::EXIT_CHECK_INTERVAL;
+            }
+
+            const double twoZr = 2 * refR;
+            const double twoZi = 2 * refI;
+            const double s = std::ldexp(1.0, current.scale);
+            next.scale = current.scale;
+            next.derScale = current.derScale;
+
+            // b' = 2Z * b + 2 * dz * b, from z1 because z0 is zero
+            if (derivative && n > 0) {
+                for (size_t k = 0; k < terms; ++k) {
+                    double tr = 0;
+                    double ti = 0;
+                    for (size_t j = 1; j <= k; ++j) {
+                        tr += current.mr[j - 1] * current.br[k - j] - current.mi[j - 1] * current.bi[k - j];
+                        ti += current.mr[j - 1] * current.bi[k - j] + current.mi[j - 1] * current.br[k - j];
+                    }
+                    next.br[k] = twoZr * current.br[k] - twoZi * current.bi[k] + 2 * s * tr;
+                    next.bi[k] = twoZr * current.bi[k] + twoZi * current.br[k] + 2 * s * ti;
+                }
+            }
+
+            // m' = 2Z * m + 2^scale * m^2 + dc, where dc = r * u
+            for (size_t k = 0; k < terms; ++k) {
+                double tr = k == 0 ? rc : 0;
+                double ti = 0;
+                for (size_t j = 0; j < k; ++j) {
+                    tr += s * (current.mr[j] * current.mr[k - 1 - j] - current.mi[j] * current.mi[k - 1 - j]);
+                    ti += s * (current.mr[j] * current.mi[k - 1 - j] + current.mi[j] * current.mr[k - 1 - j]);
+                }
+                next.mr[k] = twoZr * current.mr[k] - twoZi * current.mi[k] + tr;
+                next.mi[k] = twoZr * current.mi[k] + twoZi * current.mr[k] + ti;
+            }
+
+            for (size_t p = 0; p < probeCount; ++p) {
+                const double qr0 = qr[p];
+                qr[p] = (twoZr + s * qr0) * qr0 - (twoZi + s * qi[p]) * qi[p] + cr[p];
+                qi[p] = (twoZr + s * qr0) * qi[p] + (twoZi + s * qi[p]) * qr0 + ci[p];
+            }
+
+            if (const int e = rescale(next.mr, next.mi); e != 0) {
+                next.scale += e;
+                rc = std::ldexp(rc, -e);
+                for (size_t p = 0; p < probeCount; ++p) {
+                    qr[p] = std::ldexp(qr[p], -e);
+                    qi[p] = std::ldexp(qi[p], -e);
+                    cr[p] = std::ldexp(cr[p], -e);
+                    ci[p] = std::ldexp(ci[p], -e);
+                }
+            }
+            if (derivative) {
+                next.derScale += rescale(next.br, next.bi);
+            }
+
+            index = cursor.next();
+            std::tie(refR, refI) = loadReference(index);
+
+            // The validity at the iteration n + 1. |dz| <= R in the disk.
+            double radiusOfDelta = 0;
+            for (size_t k = 0; k < terms; ++k) {
+                radiusOfDelta += std::hypot(next.mr[k], next.mi[k]);
+            }
+            const double z = std::hypot(refR, refI);
+            const double last = std::hypot(next.mr[terms - 1], next.mi[terms - 1]);
+            bool valid = std::ldexp(z, -next.scale) >= 2 * radiusOfDelta &&
+                         z + std::ldexp(radiusOfDelta, next.scale) <= bailout &&
+                         (terms == 1 || last <= epsilon * std::hypot(next.mr[0], next.mi[0]));
+            if (valid && derivative && terms > 1) {
+                valid = std::hypot(next.br[terms - 1], next.bi[terms - 1]) <=
+                        epsilon * std::hypot(next.br[0], next.bi[0]);
+            }
+            for (size_t p = 0; valid && p < probeCount; ++p) {
+                double sr = 0;
+                double si = 0;
+                for (size_t k = terms; k-- > 0;) {
+                    const double tr = sr + next.mr[k];
+                    const double ti = si + next.mi[k];
+                    sr = tr * ur[p] - ti * ui[p];
+                    si = tr * ui[p] + ti * ur[p];
+                }
+                valid = std::hypot(sr - qr[p], si - qi[p]) <= epsilon * std::hypot(qr[p], qi[p]);
+            }
+            if (!valid) {
+                break;
+            }
+
+            std::swap(current, next);
+            result->skip = n + 1;
+            result->zr = refR;
+            result->zi = refI;
+        }
+
+        if (result->skip <= terms) {
+            return nullptr;
+        }
+        result->coefficients = std::move(current);
+        return result;
+    }
+
+    inline uint64_t SeriesApproximation::getSkip() const {
+        return skip;
+    }
+
+    inline MandelbrotContinuation SeriesApproximation::evaluate(const dex &dcr, const dex &dci) const {
+        const auto ur = static_cast<double>(dcr * inverseRadius);
+        const auto ui = static_cast<double>(dci * inverseRadius);
+        const auto &[mr, mi, br, bi, scale, derScale] = coefficients;
+        const size_t terms = mr.size();
+
+        double sr = 0;
+        double si = 0;
+        for (size_t k = terms; k-- > 0;) {
+            const double tr = sr + mr[k];
+            const double ti = si + mi[k];
+            sr = tr * ur - ti * ui;
+            si = tr * ui + ti * ur;
+        }
+        dex dzr = dex(scale, sr);
+        dex dzi = dex(scale, si);
+        dex::normalize(&dzr);
+        dex::normalize(&dzi);
+
+        auto result = MandelbrotContinuation{.dzr = dzr, .dzi = dzi, .iteration = skip, .refIteration = skip};
+        if (derivative) {
+            double dr = 0;
+            double di = 0;
+            for (size_t k = terms; k-- > 0;) {
+                const double tr = dr * ur - di * ui + br[k];
+                di = dr * ui + di * ur + bi[k];
+                dr = tr;
+            }
+            result.derR = dex(derScale, dr);
+            result.derI = dex(derScale, di);
+            dex::normalize(&result.derR);
+            dex::normalize(&result.derI);
+        }
+
+        const double r = zr + static_cast<double>(dzr);
+        const double i = zi + static_cast<double>(dzi);
+        result.cd = r * r + i * i;
+        result.pd = result.cd;
+        return result;
+    }
+
+    inline double SeriesApproximation::scaledMantissa(const dex &v, const int scale) {
+        if (v.sgn() == 0) {
+            return 0;
+        }
+        return std::ldexp(v.get_mantissa(), v.get_exp2() - scale);
+    }
+
+    inline int SeriesApproximation::rescale(std::vector<double> &re, std::vector<double> &im) {
+        double m = 0;
+        for (size_t k = 0; k < re.size(); ++k) {
+            m = std::max({m, std::abs(re[k]), std::abs(im[k])});
+        }
+        if (m == 0 || (m <= RESCALE_MAX && m >= RESCALE_MIN)) {
+            return 0;
+        }
+        const int exponent = std::ilogb(m) + 1;
+        for (size_t k = 0; k < re.size(); ++k) {
+            re[k] = std::ldexp(re[k], -exponent);
+            im[k] = std::ldexp(im[k], -exponent);
+        }
+        return exponent;
+    }
+}
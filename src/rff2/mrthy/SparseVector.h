@@ -8,9 +8,12 @@
 #include <cassert>
 #include <cstring>
 
+#include "SegmentStorage.h"
+
 namespace merutilm::rff2 {
 
-    template<typename T, size_t SEGMENT_BIT_SIZE = 16>
+    // Storage is where the segments are allocated, see SegmentStorage.h
+    template<typename T, size_t SEGMENT_BIT_SIZE = 16, typename Storage = SegmentStorage>
     class SparseVector {
     public:
         static constexpr size_t SEGMENT_SIZE = 1ULL << SEGMENT_BIT_SIZE;
@@ -22,7 +25,10 @@ namespace merutilm::rff2 {
         using size_type = uint64_t;
 
     private:
-        std::vector<std::unique_ptr<T[]>> m_segments;
+        using Segment = SegmentPointer<T, Storage, SEGMENT_SIZE>;
+
+        std::vector<Segment> m_segments;
+        Storage m_storage;
         size_type m_size = 0;
 
         static size_type segment_index(size_type index) {
@@ -38,24 +44,27 @@ namespace merutilm::rff2 {
                 m_segments.resize(seg_idx + 1);
             }
             if (m_segments[seg_idx] == nullptr) {
-                m_segments[seg_idx] = std::make_unique<T[]>(SEGMENT_SIZE);
+                m_segments[seg_idx] = allocateSegment<T, SEGMENT_SIZE>(m_storage);
             }
         }
 
     public:
         SparseVector() = default;
 
+        explicit SparseVector(Storage storage) : m_storage(std::move(storage)) {}
+
         SparseVector(const SparseVector&) = delete;
         SparseVector& operator=(const SparseVector&) = delete;
 
         SparseVector(SparseVector&& other) noexcept
-            : m_segments(std::move(other.m_segments)), m_size(other.m_size) {
+            : m_segments(std::move(other.m_segments)), m_storage(std::move(other.m_storage)), m_size(other.m_size) {
             other.m_size = 0;
         }
 
         SparseVector& operator=(SparseVector&& other) noexcept {
             if (this != &other) {
                 m_segments = std::move(other.m_segments);
+                m_storage = std::move(other.m_storage);
                 m_size = other.m_size;
                 other.m_size = 0;
             }
@@ -166,7 +175,7 @@ namespace merutilm::rff2 {
                 if (seg != nullptr) count++;
             }
             return count * SEGMENT_SIZE * sizeof(T) + 
-                   m_segments.capacity() * sizeof(std::unique_ptr<T[]>);
+                   m_segments.capacity() * sizeof(Segment);
         }
     };
 
@@ -3,36 +3,112 @@
 //
 
 #pragma once
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <queue>
+#include <span>
+
 #include "ParallelRenderState.h"
+#include "ParallelThreadPool.h"
 #include "../data/Matrix.h"
 namespace merutilm::rff2 {
     template<typename T>
     using ParallelArrayRenderer = std::function<T(uint16_t x, uint16_t y, uint16_t xRes, uint16_t yRes, float xRat, float yRat, uint32_t index,
                                                   T value)>;
 
+    /**
+     * Renders the pixels of the row at once. The values must be written in the order of the given x.
+     */
+    template<typename T>
+    using ParallelArrayRowRenderer = std::function<void(uint16_t y, uint16_t xRes, uint16_t yRes,
+                                                        std::span<const uint16_t> xs, std::span<T> values)>;
+
+
+    /**
+     * Called for the pixels which are filled by the guess instead of being rendered.
+     */
+    template<typename T>
+    using ParallelArrayFiller = std::function<void(uint16_t x, uint16_t y, uint16_t xRes, uint16_t yRes, uint32_t index,
+                                                   const T &value)>;
+
 
     template<typename T>
     class ParallelArrayDispatcher {
+        static constexpr uint16_t GUESSING_TILE_SIZE = 64;
+        static constexpr uint16_t GUESSING_VERIFY_STRIDE = 4;
+
         ParallelRenderState &state;
+        ParallelThreadPool &pool;
         Matrix<T> &matrix;
         ParallelArrayRenderer<T> renderer;
+        ParallelArrayRowRenderer<T> rowRenderer;
         uint32_t threads;
+        std::vector<double> rowCosts;
 
     public:
-        ParallelArrayDispatcher(ParallelRenderState &state, Matrix<T> &matrix, uint32_t threads,
+        ParallelArrayDispatcher(ParallelRenderState &state, ParallelThreadPool &pool, Matrix<T> &matrix, uint32_t threads,
                                 ParallelArrayRenderer<T> renderer);
 
+        /**
+         * The rows are rendered by the row renderer instead of the renderer.
+         */
+        ParallelArrayDispatcher(ParallelRenderState &state, ParallelThreadPool &pool, Matrix<T> &matrix, uint32_t threads,
+                                ParallelArrayRenderer<T> renderer, ParallelArrayRowRenderer<T> rowRenderer);
 
+
+        /**
+         * Sets the estimated cost of each row, such as the sum of the iterations of the previous pass.
+         * When it is set, the rows are given to the threads by the longest-first, instead of the bands.
+         * @param costs the cost of each row. It is ignored unless it has all rows and any positive cost.
+         */
+        void setRowCosts(std::vector<double> costs);
+
+        /**
+         * Renders the rows on the pool. Each thread starts from its own band of rows, and steals the rows of the others when done.
+         * If the row costs are set, each thread starts from its own rows of the similar total cost instead.
+         */
         void dispatch();
 
+        /**
+         * Renders the masked pixels only, and keeps the values of the others. The rows without any masked pixel are skipped.
+         * @param mask whether to render each pixel
+         */
+        void dispatchMasked(const std::vector<bool> &mask);
+
+        /**
+         * Renders with the solid guessing (Mariani-Silver). The tiles are rendered on the pool. <br/>
+         * The border of the rectangle is rendered first. If the whole border is the solid value, the inside is filled with it.
+         * Otherwise, it is divided into four, and the new borders are rendered in the same way.
+         * <li> It is exact for the interior of the Mandelbrot set, which has no holes, unless a thinner filament than a pixel crosses the border.</li>
+         * <li> The verification renders the filled rectangles sparsely, and renders them entirely if any pixel is not the solid value.</li>
+         * @param solid the value of the interior
+         * @param verify whether to verify the filled rectangles
+         * @param filler called for each filled pixel
+         * @param rendered the pixels which are already rendered, such as by the preview passes. They are neither rendered again nor filled,
+         * and the rectangle is not filled if any of them inside is not the solid value.
+         */
+        void dispatchGuessing(const T &solid, bool verify, const ParallelArrayFiller<T> &filler,
+                              const std::vector<bool> *rendered = nullptr);
+
     private:
         static std::vector<uint16_t> getRenderPriority(uint16_t rpy);
 
 
-        void renderForward(uint16_t xRes, uint16_t yRes, uint16_t y, std::vector<std::atomic<bool> > &rendered);
+        std::vector<std::vector<uint32_t> > getScheduledRows(const std::vector<uint32_t> &rows) const;
+
+
+        void dispatchRows(const std::vector<bool> *mask);
+
+
+        void renderForward(uint16_t xRes, uint16_t yRes, uint16_t y, const std::vector<bool> *mask);
 
 
-        void renderBackward(uint16_t xRes, uint16_t yRes, uint32_t len, std::vector<std::atomic<bool> > &rendered);
+        void renderRowForward(uint16_t xRes, uint16_t yRes, uint16_t y, const std::vector<bool> *mask);
+
+
+        void renderTile(uint16_t l, uint16_t t, const T &solid, bool verify, const ParallelArrayFiller<T> &filler,
+                        const std::vector<bool> *rendered);
     };
 
     // DEFINITION OF PARALLEL ARRAY DISPATCHER  DEFINITION OF PARALLEL ARRAY DISPATCHER  DEFINITION OF PARALLEL ARRAY DISPATCHER  DEFINITION OF PARALLEL ARRAY DISPATCHER
@@ -43,13 +119,39 @@ namespace merutilm::rff2 {
 
 
     template<typename T>
-    ParallelArrayDispatcher<T>::ParallelArrayDispatcher(ParallelRenderState &state, Matrix<T> &matrix, const uint32_t threads,
-                                                        ParallelArrayRenderer<T> renderer) : state(state), matrix(matrix),
+    ParallelArrayDispatcher<T>::ParallelArrayDispatcher(ParallelRenderState &state, ParallelThreadPool &pool, Matrix<T> &matrix,
+                                                        const uint32_t threads,
+                                                        ParallelArrayRenderer<T> renderer) : state(state), pool(pool), matrix(matrix),
         renderer(std::move(renderer)), threads(threads) {
     }
 
+    template<typename T>
+    ParallelArrayDispatcher<T>::ParallelArrayDispatcher(ParallelRenderState &state, ParallelThreadPool &pool, Matrix<T> &matrix,
+                                                        const uint32_t threads,
+                                                        ParallelArrayRenderer<T> renderer,
+                                                        ParallelArrayRowRenderer<T> rowRenderer) : state(state), pool(pool),
+        matrix(matrix), renderer(std::move(renderer)), rowRenderer(std::move(rowRenderer)), threads(threads) {
+    }
+
+    template<typename T>
+    void ParallelArrayDispatcher<T>::setRowCosts(std::vector<double> costs) {
+        rowCosts = std::move(costs);
+    }
+
     template<typename T>
     void ParallelArrayDispatcher<T>::dispatch() {
+        dispatchRows(nullptr);
+    }
+
+
+    template<typename T>
+    void ParallelArrayDispatcher<T>::dispatchMasked(const std::vector<bool> &mask) {
+        dispatchRows(&mask);
+    }
+
+
+    template<typename T>
+    void ParallelArrayDispatcher<T>::dispatchRows(const std::vector<bool> *mask) {
         const uint16_t rpy = matrix.getHeight() / threads + 1;
         if (state.interruptRequested()) {
             return;
@@ -57,28 +159,72 @@ namespace merutilm::rff2 {
 
 
         const std::vector<uint16_t> rpyIndices = getRenderPriority(rpy);
-        auto threadPool = std::vector<std::jthread>();
-        threadPool.reserve(threads);
-        auto xRes = matrix.getWidth();
-        auto yRes = matrix.getHeight();
-        auto len = matrix.getLength();
-        auto rendered = std::vector<std::atomic<bool> >(len);
-
-        for (uint16_t sy = 0; sy < matrix.getHeight(); sy += rpy) {
-            threadPool.emplace_back([sy, &rpyIndices, xRes, yRes, this, &rendered, len] {
+        const auto xRes = matrix.getWidth();
+        const auto yRes = matrix.getHeight();
+        auto bands = std::vector<std::vector<uint32_t> >();
+
+        const auto isMaskedRow = [mask, xRes](const uint32_t y) {
+            const auto begin = mask->begin() + static_cast<ptrdiff_t>(xRes) * y;
+            return std::find(begin, begin + xRes, true) != begin + xRes;
+        };
+
+        if (rowCosts.size() == yRes && std::ranges::any_of(rowCosts, [](const double c) { return c > 0; })) {
+            auto rows = std::vector<uint32_t>();
+            rows.reserve(yRes);
+            for (uint32_t y = 0; y < yRes; ++y) {
+                if (mask == nullptr || isMaskedRow(y)) {
+                    rows.push_back(y);
+                }
+            }
+            bands = getScheduledRows(rows);
+        } else {
+            for (uint32_t sy = 0; sy < yRes; sy += rpy) {
+                auto &rows = bands.emplace_back();
+                rows.reserve(rpy);
                 for (const auto vy: rpyIndices) {
-                    renderForward(xRes, yRes, sy + vy, rendered);
+                    if (sy + vy < yRes && (mask == nullptr || isMaskedRow(sy + vy))) {
+                        rows.push_back(sy + vy);
+                    }
                 }
-                renderBackward(xRes, yRes, len, rendered);
-            });
+            }
+        }
+
+        pool.run(state, bands, [xRes, yRes, mask, this](const uint32_t y) {
+            if (rowRenderer) {
+                renderRowForward(xRes, yRes, static_cast<uint16_t>(y), mask);
+            } else {
+                renderForward(xRes, yRes, static_cast<uint16_t>(y), mask);
+            }
+        });
+    }
+
+
+    template<typename T>
+    void ParallelArrayDispatcher<T>::dispatchGuessing(const T &solid, const bool verify,
+                                                      const ParallelArrayFiller<T> &filler,
+                                                      const std::vector<bool> *rendered) {
+        if (state.interruptRequested()) {
+            return;
         }
 
+        const uint32_t tilesX = (matrix.getWidth() + GUESSING_TILE_SIZE - 1) / GUESSING_TILE_SIZE;
+        const uint32_t tilesY = (matrix.getHeight() + GUESSING_TILE_SIZE - 1) / GUESSING_TILE_SIZE;
+        const uint32_t tpy = tilesY / threads + 1;
+        auto bands = std::vector<std::vector<uint32_t> >();
 
-        for (auto &t: threadPool) {
-            if (t.joinable()) {
-                t.join();
+        for (uint32_t sy = 0; sy < tilesY; sy += tpy) {
+            auto &tiles = bands.emplace_back();
+            for (uint32_t ty = sy; ty < std::min(sy + tpy, tilesY); ++ty) {
+                for (uint32_t tx = 0; tx < tilesX; ++tx) {
+                    tiles.push_back(ty * tilesX + tx);
+                }
             }
         }
+
+        pool.run(state, bands, [tilesX, &solid, verify, &filler, rendered, this](const uint32_t tile) {
+            renderTile(static_cast<uint16_t>(tile % tilesX * GUESSING_TILE_SIZE),
+                       static_cast<uint16_t>(tile / tilesX * GUESSING_TILE_SIZE), solid, verify, filler, rendered);
+        });
     }
 
 
@@ -118,41 +264,252 @@ namespace merutilm::rff2 {
 
 
     template<typename T>
-    void ParallelArrayDispatcher<T>::renderForward(const uint16_t xRes, const uint16_t yRes, const uint16_t y,
-                                                   std::vector<std::atomic<bool> > &rendered) {
-        if (y >= yRes) {
-            return;
+    std::vector<std::vector<uint32_t> > ParallelArrayDispatcher<T>::getScheduledRows(
+        const std::vector<uint32_t> &rows) const {
+        // LPT : the most expensive row is given to the thread of the least total cost.
+        // Each queue is in the descending order of the cost, so the stealers take the cheapest rows from the back.
+        auto sorted = rows;
+        std::ranges::stable_sort(sorted, [this](const uint32_t a, const uint32_t b) {
+            return rowCosts[a] > rowCosts[b];
+        });
+
+        using Load = std::pair<double, uint32_t>;
+        auto loads = std::priority_queue<Load, std::vector<Load>, std::greater<> >();
+        const uint32_t lanes = std::max(threads, 1u);
+        for (uint32_t lane = 0; lane < lanes; ++lane) {
+            loads.emplace(0.0, lane);
         }
 
+        auto queues = std::vector<std::vector<uint32_t> >(lanes);
+        for (const uint32_t y: sorted) {
+            auto [load, lane] = loads.top();
+            loads.pop();
+            queues[lane].push_back(y);
+            loads.emplace(load + rowCosts[y], lane);
+        }
+        return queues;
+    }
+
+
+    template<typename T>
+    void ParallelArrayDispatcher<T>::renderForward(const uint16_t xRes, const uint16_t yRes, const uint16_t y,
+                                                   const std::vector<bool> *mask) {
         for (uint16_t x = 0; x < xRes; ++x) {
             if (x % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 && state.interruptRequested()) {
                 return;
             }
 
             uint32_t i = static_cast<uint32_t>(xRes) * y + x;
+            if (mask != nullptr && !(*mask)[i]) {
+                continue;
+            }
+            matrix[i] = renderer(x, y, xRes, yRes, static_cast<float>(x) / xRes,
+                                 static_cast<float>(y) / yRes, i, matrix[i]);
+        }
+    }
+
+
+    template<typename T>
+    void ParallelArrayDispatcher<T>::renderRowForward(const uint16_t xRes, const uint16_t yRes, const uint16_t y,
+                                                      const std::vector<bool> *mask) {
+        // The row is rendered in chunks, to keep the interruption check interval of renderForward().
+        constexpr uint16_t chunk = Constants::Fractal::EXIT_CHECK_INTERVAL;
+        auto xs = std::vector<uint16_t>();
+        auto values = std::vector<T>();
+        xs.reserve(chunk);
+        values.reserve(chunk);
+
+        for (uint32_t sx = 0; sx < xRes; sx += chunk) {
+            if (state.interruptRequested()) {
+                return;
+            }
 
-            if (!rendered[i].exchange(true)) {
-                matrix[i] = renderer(x, y, xRes, yRes, static_cast<float>(x) / xRes,
-                                     static_cast<float>(y) / yRes, i, matrix[i]);
+            xs.clear();
+            const uint32_t ex = std::min<uint32_t>(xRes, sx + chunk);
+            for (uint32_t x = sx; x < ex; ++x) {
+                if (mask == nullptr || (*mask)[static_cast<uint32_t>(xRes) * y + x]) {
+                    xs.push_back(static_cast<uint16_t>(x));
+                }
+            }
+            if (xs.empty()) {
+                continue;
+            }
+
+            values.resize(xs.size());
+            rowRenderer(y, xRes, yRes, xs, values);
+            for (size_t k = 0; k < xs.size(); ++k) {
+                matrix[static_cast<uint32_t>(xRes) * y + xs[k]] = std::move(values[k]);
             }
         }
     }
 
 
     template<typename T>
-    void ParallelArrayDispatcher<T>::renderBackward(const uint16_t xRes, const uint16_t yRes, const uint32_t len,
-                                                    std::vector<std::atomic<bool> > &rendered) {
-        for (uint32_t i = len - 1; i > 0; --i) {
-            if (i % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 && state.interruptRequested()) {
+    void ParallelArrayDispatcher<T>::renderTile(const uint16_t l, const uint16_t t, const T &solid, const bool verify,
+                                                const ParallelArrayFiller<T> &filler,
+                                                const std::vector<bool> *rendered) {
+        const uint16_t xRes = matrix.getWidth();
+        const uint16_t yRes = matrix.getHeight();
+        const uint16_t r = std::min<uint16_t>(l + GUESSING_TILE_SIZE, xRes) - 1;
+        const uint16_t b = std::min<uint16_t>(t + GUESSING_TILE_SIZE, yRes) - 1;
+        const uint16_t w = r - l + 1;
+
+        // The rectangles are inclusive, and the adjacent ones share their border.
+        using Rect = std::array<uint16_t, 4>;
+        auto done = std::vector<bool>(static_cast<size_t>(w) * (b - t + 1));
+        auto rects = std::vector<Rect>{{l, t, r, b}};
+        auto filled = std::vector<Rect>();
+        auto xs = std::vector<uint16_t>();
+        auto values = std::vector<T>();
+
+        const auto index = [xRes](const uint16_t x, const uint16_t y) {
+            return static_cast<uint32_t>(xRes) * y + x;
+        };
+
+        const auto isRendered = [&](const uint16_t x, const uint16_t y) {
+            return rendered != nullptr && (*rendered)[index(x, y)];
+        };
+
+        // The rendered pixels are on the borders without being rendered again.
+        for (uint16_t y = t; rendered != nullptr && y <= b; ++y) {
+            for (uint16_t x = l; x <= r; ++x) {
+                done[static_cast<size_t>(y - t) * w + (x - l)] = isRendered(x, y);
+            }
+        }
+
+        const auto renderPixel = [&](const uint16_t x, const uint16_t y) {
+            const uint32_t i = index(x, y);
+            matrix[i] = renderer(x, y, xRes, yRes, static_cast<float>(x) / xRes, static_cast<float>(y) / yRes, i,
+                                 matrix[i]);
+        };
+
+        const auto renderRow = [&](const uint16_t y, const uint16_t from, const uint16_t to) {
+            xs.clear();
+            for (uint16_t x = from; x <= to; ++x) {
+                if (const size_t d = static_cast<size_t>(y - t) * w + (x - l); !done[d]) {
+                    done[d] = true;
+                    xs.push_back(x);
+                }
+            }
+            if (!rowRenderer) {
+                for (const uint16_t x: xs) {
+                    renderPixel(x, y);
+                }
                 return;
             }
-            const auto [px, py] = matrix.getLocation(i);
+            if (xs.empty()) {
+                return;
+            }
+            values.resize(xs.size());
+            rowRenderer(y, xRes, yRes, xs, values);
+            for (size_t k = 0; k < xs.size(); ++k) {
+                matrix[index(xs[k], y)] = std::move(values[k]);
+            }
+        };
 
-            if (!rendered[i].exchange(true)) {
-                T c = renderer(px, py, xRes, yRes, static_cast<float>(px) / xRes, static_cast<float>(py) / yRes, i,
-                                    matrix[i]);
-                matrix[i] = std::move(c);
+        const auto renderColumn = [&](const uint16_t x, const uint16_t from, const uint16_t to) {
+            for (uint16_t y = from; y <= to; ++y) {
+                if (const size_t d = static_cast<size_t>(y - t) * w + (x - l); !done[d]) {
+                    done[d] = true;
+                    renderPixel(x, y);
+                }
+            }
+        };
+
+        const auto isSolid = [&](const Rect &rect) {
+            const auto [rl, rt, rr, rb] = rect;
+            for (uint16_t x = rl; x <= rr; ++x) {
+                if (matrix[index(x, rt)] != solid || matrix[index(x, rb)] != solid) {
+                    return false;
+                }
+            }
+            for (uint16_t y = rt + 1; y < rb; ++y) {
+                if (matrix[index(rl, y)] != solid || matrix[index(rr, y)] != solid) {
+                    return false;
+                }
+            }
+            for (uint16_t y = rt + 1; rendered != nullptr && y < rb; ++y) {
+                for (uint16_t x = rl + 1; x < rr; ++x) {
+                    if (isRendered(x, y) && matrix[index(x, y)] != solid) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+
+        while (!rects.empty()) {
+            if (state.interruptRequested()) {
+                return;
+            }
+
+            const Rect rect = rects.back();
+            rects.pop_back();
+            const auto [rl, rt, rr, rb] = rect;
+
+            renderRow(rt, rl, rr);
+            renderRow(rb, rl, rr);
+            if (rb - rt >= 2) {
+                renderColumn(rl, rt + 1, rb - 1);
+                renderColumn(rr, rt + 1, rb - 1);
+            }
+
+            if (rr - rl < 2 || rb - rt < 2) {
+                continue;
+            }
+
+            if (isSolid(rect)) {
+                for (uint16_t y = rt + 1; y < rb; ++y) {
+                    for (uint16_t x = rl + 1; x < rr; ++x) {
+                        if (isRendered(x, y)) {
+                            continue;
+                        }
+                        const uint32_t i = index(x, y);
+                        done[static_cast<size_t>(y - t) * w + (x - l)] = true;
+                        matrix[i] = solid;
+                        filler(x, y, xRes, yRes, i, solid);
+                    }
+                }
+                filled.push_back(rect);
+                continue;
+            }
+
+            const uint16_t mx = (rl + rr) / 2;
+            const uint16_t my = (rt + rb) / 2;
+            rects.push_back({mx, my, rr, rb});
+            rects.push_back({rl, my, mx, rb});
+            rects.push_back({mx, rt, rr, my});
+            rects.push_back({rl, rt, mx, my});
+        }
+
+        if (!verify) {
+            return;
+        }
+
+        for (const auto &[rl, rt, rr, rb]: filled) {
+            if (state.interruptRequested()) {
+                return;
+            }
+
+            bool valid = true;
+            for (uint16_t y = rt + 1; valid && y < rb; y += GUESSING_VERIFY_STRIDE) {
+                for (uint16_t x = rl + 1; valid && x < rr; x += GUESSING_VERIFY_STRIDE) {
+                    if (!isRendered(x, y)) {
+                        renderPixel(x, y);
+                    }
+                    valid = matrix[index(x, y)] == solid;
+                }
+            }
+            if (valid) {
+                continue;
+            }
+            for (uint16_t y = rt + 1; y < rb; ++y) {
+                for (uint16_t x = rl + 1; x < rr; ++x) {
+                    if (!isRendered(x, y)) {
+                        renderPixel(x, y);
+                    }
+                }
             }
         }
     }
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 
 #pragma once
 #include "ParallelRenderState.h"
+#include "ParallelThreadPool.h"
 #include "../constants/Constants.hpp"
 namespace merutilm::rff2 {
     using ParallelRenderer = std::function<void(uint32_t x, uint32_t y, uint32_t xRes, uint32_t yRes, float xRat,
@@ -11,25 +12,27 @@ namespace merutilm::rff2 {
 
     class ParallelDispatcher {
         ParallelRenderState &state;
+        ParallelThreadPool &pool;
         ParallelRenderer renderer;
         uint32_t xRes;
         uint32_t yRes;
         uint32_t threads;
 
     public:
-        ParallelDispatcher(ParallelRenderState &state, uint32_t xRes, uint32_t yRes, uint32_t threads, ParallelRenderer renderer);
+        ParallelDispatcher(ParallelRenderState &state, ParallelThreadPool &pool, uint32_t xRes, uint32_t yRes,
+                           uint32_t threads, ParallelRenderer renderer);
 
 
+        /**
+         * Renders the rows on the pool. Each thread starts from its own band of rows, and steals the rows of the others when done.
+         */
         void dispatch() const;
 
     private:
         static std::vector<uint32_t> getRenderPriority(uint32_t rpy);
 
 
-        void renderForward(uint32_t xRes, uint32_t yRes, uint32_t y, std::vector<std::atomic<bool> > &rendered) const;
-
-
-        void renderBackward(uint32_t xRes, uint32_t yRes, uint32_t len, std::vector<std::atomic<bool> > &rendered) const;
+        void renderForward(uint32_t xRes, uint32_t yRes, uint32_t y) const;
     };
 
     // DEFINITION OF PARALLEL ARRAY DISPATCHER  DEFINITION OF PARALLEL ARRAY DISPATCHER  DEFINITION OF PARALLEL ARRAY DISPATCHER  DEFINITION OF PARALLEL ARRAY DISPATCHER
@@ -39,8 +42,9 @@ namespace merutilm::rff2 {
     // DEFINITION OF PARALLEL ARRAY DISPATCHER  DEFINITION OF PARALLEL ARRAY DISPATCHER  DEFINITION OF PARALLEL ARRAY DISPATCHER  DEFINITION OF PARALLEL ARRAY DISPATCHER
 
 
-    inline ParallelDispatcher::ParallelDispatcher(ParallelRenderState &state, const uint32_t xRes, const uint32_t yRes, const uint32_t threads,
-                                                  ParallelRenderer renderer) : state(state), renderer(std::move(renderer)),
+    inline ParallelDispatcher::ParallelDispatcher(ParallelRenderState &state, ParallelThreadPool &pool, const uint32_t xRes,
+                                                  const uint32_t yRes, const uint32_t threads,
+                                                  ParallelRenderer renderer) : state(state), pool(pool), renderer(std::move(renderer)),
                                                                                xRes(xRes), yRes(yRes), threads(threads) {
     }
 
@@ -52,26 +56,21 @@ namespace merutilm::rff2 {
 
 
         const std::vector<uint32_t> rpyIndices = getRenderPriority(rpy);
-        auto threadPool = std::vector<std::jthread>();
-        threadPool.reserve(threads);
-        auto len = xRes * yRes;
-        auto rendered = std::vector<std::atomic<bool> >(len);
+        auto bands = std::vector<std::vector<uint32_t> >();
 
         for (uint32_t sy = 0; sy < yRes; sy += rpy) {
-            threadPool.emplace_back([sy, &rpyIndices, this, &rendered, len] {
-                for (const auto vy: rpyIndices) {
-                    renderForward(xRes, yRes, sy + vy, rendered);
+            auto &rows = bands.emplace_back();
+            rows.reserve(rpy);
+            for (const auto vy: rpyIndices) {
+                if (sy + vy < yRes) {
+                    rows.push_back(sy + vy);
                 }
-                renderBackward(xRes, yRes, len, rendered);
-            });
-        }
-
-
-        for (auto &t: threadPool) {
-            if (t.joinable()) {
-                t.join();
             }
         }
+
+        pool.run(state, bands, [this](const uint32_t y) {
+            renderForward(xRes, yRes, y);
+        });
     }
 
 
@@ -109,39 +108,15 @@ namespace merutilm::rff2 {
     }
 
 
-    inline void ParallelDispatcher::renderForward(const uint32_t xRes, const uint32_t yRes, const uint32_t y,
-                                                  std::vector<std::atomic<bool> > &rendered) const {
-        if (y >= yRes) {
-            return;
-        }
-
+    inline void ParallelDispatcher::renderForward(const uint32_t xRes, const uint32_t yRes, const uint32_t y) const {
         for (uint32_t x = 0; x < xRes; ++x) {
             if (x % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 && state.interruptRequested()) {
                 return;
             }
 
-            if (const uint32_t i = static_cast<uint32_t>(xRes) * y + x;
-                !rendered[i].exchange(true)
-                ) {
-                renderer(x, y, xRes, yRes, static_cast<float>(x) / xRes,
-                         static_cast<float>(y) / yRes, i);
-                }
-        }
-    }
-
-
-    inline void ParallelDispatcher::renderBackward(const uint32_t xRes, const uint32_t yRes, const uint32_t len,
-                                                   std::vector<std::atomic<bool> > &rendered) const {
-        for (uint32_t i = len - 1; i > 0; --i) {
-            if (i % Constants::Fractal::EXIT_CHECK_INTERVAL == 0 && state.interruptRequested()) {
-                return;
-            }
-            const uint32_t px = i % xRes;
-            const uint32_t py = i / xRes;
-
-            if (!rendered[i].exchange(true)) {
-                renderer(px, py, xRes, yRes, static_cast<float>(px) / xRes, static_cast<float>(py) / yRes, i);
-            }
+            const uint32_t i = static_cast<uint32_t>(xRes) * y + x;
+            renderer(x, y, xRes, yRes, static_cast<float>(x) / xRes,
+                     static_cast<float>(y) / yRes, i);
         }
     }
 }
\ No newline at end of file
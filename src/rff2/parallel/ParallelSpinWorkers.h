@@ -0,0 +1,156 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <immintrin.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Parallel Spin Workers</b>
+     * <br/>
+     * The small fixed group of pinned threads for the very short fork-join tasks, such as the multiplications of one reference iteration.
+     * <li> The workers do not sleep between the tasks. They spin on the generation counter, so the task starts without the kernel wake-up latency.</li>
+     * <li> The caller thread runs the lane zero, and spins until all workers finish.</li>
+     * <li> It is only worth it when each task is much longer than the synchronization cost.</li>
+     */
+    class ParallelSpinWorkers final {
+        static constexpr uint32_t SPINS_BEFORE_YIELD = 1 << 16;
+
+        std::vector<std::jthread> threads;
+        std::atomic<uint64_t> generation = 0;
+        std::atomic<uint32_t> pending = 0;
+        std::atomic<bool> terminated = false;
+        void *taskContext = nullptr;
+        void (*taskInvoker)(void *, uint32_t) = nullptr;
+
+    public:
+        /**
+         * @param lanes the number of lanes including the caller thread.
+         */
+        explicit ParallelSpinWorkers(uint32_t lanes);
+
+        ~ParallelSpinWorkers();
+
+        ParallelSpinWorkers(const ParallelSpinWorkers &) = delete;
+
+        ParallelSpinWorkers &operator=(const ParallelSpinWorkers &) = delete;
+
+        ParallelSpinWorkers(ParallelSpinWorkers &&) = delete;
+
+        ParallelSpinWorkers &operator=(ParallelSpinWorkers &&) = delete;
+
+        /**
+         * Runs @code task(lane)@endcode for all lanes, and returns when all of them are finished.
+         * @param task the task to run. It must be invocable with the lane index.
+         */
+        template<typename F> requires std::is_invocable_r_v<void, F &, uint32_t>
+        void run(F &&task);
+
+        [[nodiscard]] uint32_t getLanes() const;
+
+    private:
+        void workerLoop(uint32_t lane);
+
+        static void spinPause(uint32_t &spins);
+
+        static void pinCurrentThread(uint32_t lane);
+    };
+
+    // DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS
+    // DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS
+    // DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS
+    // DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS
+    // DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS  DEFINITION OF PARALLEL SPIN WORKERS
+
+
+    inline ParallelSpinWorkers::ParallelSpinWorkers(const uint32_t lanes) {
+        threads.reserve(lanes - 1);
+        for (uint32_t lane = 1; lane < lanes; ++lane) {
+            threads.emplace_back([this, lane] { workerLoop(lane); });
+        }
+    }
+
+    inline ParallelSpinWorkers::~ParallelSpinWorkers() {
+        terminated.store(true, std::memory_order_release);
+        generation.fetch_add(1, std::memory_order_release);
+        for (auto &thread: threads) {
+            thread.join();
+        }
+    }
+
+    template<typename F> requires std::is_invocable_r_v<void, F &, uint32_t>
+    void ParallelSpinWorkers::run(F &&task) {
+        taskContext = &task;
+        taskInvoker = [](void *context, const uint32_t lane) {
+            (*static_cast<std::remove_reference_t<F> *>(context))(lane);
+        };
+        pending.store(static_cast<uint32_t>(threads.size()), std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+
+        task(0);
+
+        uint32_t spins = 0;
+        while (pending.load(std::memory_order_acquire) != 0) {
+            spinPause(spins);
+        }
+    }
+
+    inline uint32_t ParallelSpinWorkers::getLanes() const {
+        return static_cast<uint32_t>(threads.size()) + 1;
+    }
+
+    inline void ParallelSpinWorkers::workerLoop(const uint32_t lane) {
+        pinCurrentThread(lane);
+        uint64_t seen = 0;
+        while (true) {
+            uint32_t spins = 0;
+            uint64_t current;
+            while ((current = generation.load(std::memory_order_acquire)) == seen) {
+                spinPause(spins);
+            }
+            seen = current;
+            if (terminated.load(std::memory_order_acquire)) {
+                return;
+            }
+            taskInvoker(taskContext, lane);
+            pending.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    inline void ParallelSpinWorkers::spinPause(uint32_t &spins) {
+        if (++spins < SPINS_BEFORE_YIELD) {
+            _mm_pause();
+            return;
+        }
+        // The caller is doing something else for a long time. don't burn the core.
+        std::this_thread::yield();
+    }
+
+    inline void ParallelSpinWorkers::pinCurrentThread(const uint32_t lane) {
+        // Skip the SMT sibling of the caller when possible, the siblings share the multiplier.
+        const uint32_t processors = std::max(1u, std::thread::hardware_concurrency());
+        const uint32_t stride = processors >= 4 ? 2 : 1;
+        const uint32_t processor = lane * stride % processors;
+#ifdef _WIN32
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << processor % (sizeof(DWORD_PTR) * 8));
+#else
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(processor, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    }
+}
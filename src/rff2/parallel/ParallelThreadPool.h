@@ -0,0 +1,226 @@
+//
+// Created by Merutilm on 2026-10-16.
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ParallelRenderState.h"
+
+namespace merutilm::rff2 {
+    /**
+     * <b>Parallel Thread Pool</b>
+     * <br/>
+     * The process-wide threads, created once and reused by every dispatch.
+     * <li> The workers sleep between the jobs, so they are not a burden when idle.</li>
+     * <li> The caller thread always runs the lane zero. The lanes which are not taken by any worker are run by the caller too,
+     * so the job finishes even if the pool is busy or smaller than the lanes.</li>
+     * <li> Only one job runs on the workers at once. Another job submitted at the same time is run on its caller alone.</li>
+     */
+    class ParallelThreadPool final {
+        struct Job {
+            void *context;
+            void (*invoker)(void *, uint32_t);
+            uint32_t lanes;
+            std::atomic<uint32_t> nextLane = 1;
+        };
+
+        /**
+         * The queue of a lane. The owner takes the items from the front, and the others steal them from the back.
+         */
+        struct LaneQueue {
+            std::mutex mutex;
+            std::vector<uint32_t> items;
+            size_t front = 0;
+            size_t back = 0;
+        };
+
+        std::vector<std::jthread> threads;
+        std::mutex jobMutex;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        Job *job = nullptr;
+        uint64_t generation = 0;
+        uint32_t running = 0;
+        bool terminated = false;
+
+    public:
+        /**
+         * @param workers the number of the worker threads, except the caller thread.
+         */
+        explicit ParallelThreadPool(uint32_t workers);
+
+        ~ParallelThreadPool();
+
+        ParallelThreadPool(const ParallelThreadPool &) = delete;
+
+        ParallelThreadPool &operator=(const ParallelThreadPool &) = delete;
+
+        ParallelThreadPool(ParallelThreadPool &&) = delete;
+
+        ParallelThreadPool &operator=(ParallelThreadPool &&) = delete;
+
+        /**
+         * Runs @code task(lane)@endcode for all lanes, and returns when all of them are finished.
+         * @param lanes the number of lanes including the caller thread.
+         * @param task the task to run. It must be invocable with the lane index.
+         */
+        template<typename F> requires std::is_invocable_r_v<void, F &, uint32_t>
+        void run(uint32_t lanes, F &&task);
+
+        /**
+         * Runs @code task(item)@endcode for all items of the queues, one lane per queue. <br/>
+         * The lane takes the items of its own queue in order, and steals from the back of the other queues when its own queue is empty.
+         * No item is taken after the interruption.
+         * @param state the state to check the interruption
+         * @param queues the items of each lane
+         * @param task the task to run. It must be invocable with the item.
+         */
+        template<typename F> requires std::is_invocable_r_v<void, F &, uint32_t>
+        void run(const ParallelRenderState &state, const std::vector<std::vector<uint32_t> > &queues, F &&task);
+
+        [[nodiscard]] uint32_t getWorkers() const;
+
+    private:
+        void workerLoop();
+
+        static void runLanes(Job &job);
+    };
+
+    // DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL
+    // DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL
+    // DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL
+    // DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL
+    // DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL  DEFINITION OF PARALLEL THREAD POOL
+
+
+    inline ParallelThreadPool::ParallelThreadPool(const uint32_t workers) {
+        threads.reserve(workers);
+        for (uint32_t i = 0; i < workers; ++i) {
+            threads.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    inline ParallelThreadPool::~ParallelThreadPool() {
+        {
+            std::scoped_lock lock(mutex);
+            terminated = true;
+        }
+        wake.notify_all();
+        for (auto &thread: threads) {
+            thread.join();
+        }
+    }
+
+    template<typename F> requires std::is_invocable_r_v<void, F &, uint32_t>
+    void ParallelThreadPool::run(const uint32_t lanes, F &&task) {
+        auto current = Job{
+            .context = &task,
+            .invoker = [](void *context, const uint32_t lane) {
+                (*static_cast<std::remove_reference_t<F> *>(context))(lane);
+            },
+            .lanes = std::max(lanes, 1u)
+        };
+
+        std::unique_lock jobLock(jobMutex, std::try_to_lock);
+        const bool shared = jobLock.owns_lock() && current.lanes > 1 && !threads.empty();
+        if (shared) {
+            std::scoped_lock lock(mutex);
+            job = &current;
+            ++generation;
+        }
+        if (shared) {
+            wake.notify_all();
+        }
+
+        task(0);
+        runLanes(current);
+
+        if (shared) {
+            // The workers which have not joined yet must not see the job after it is returned.
+            std::unique_lock lock(mutex);
+            job = nullptr;
+            finished.wait(lock, [this] { return running == 0; });
+        }
+    }
+
+    template<typename F> requires std::is_invocable_r_v<void, F &, uint32_t>
+    void ParallelThreadPool::run(const ParallelRenderState &state, const std::vector<std::vector<uint32_t> > &queues,
+                                 F &&task) {
+        const auto lanes = static_cast<uint32_t>(queues.size());
+        auto laneQueues = std::vector<LaneQueue>(lanes);
+        for (uint32_t i = 0; i < lanes; ++i) {
+            laneQueues[i].items = queues[i];
+            laneQueues[i].back = queues[i].size();
+        }
+
+        const auto take = [&laneQueues](const uint32_t lane, const bool steal, uint32_t *item) {
+            LaneQueue &queue = laneQueues[lane];
+            std::scoped_lock lock(queue.mutex);
+            if (queue.front == queue.back) {
+                return false;
+            }
+            *item = steal ? queue.items[--queue.back] : queue.items[queue.front++];
+            return true;
+        };
+
+        run(lanes, [&](const uint32_t lane) {
+            uint32_t item = 0;
+            while (!state.interruptRequested()) {
+                bool found = take(lane, false, &item);
+                for (uint32_t i = 1; !found && i < lanes; ++i) {
+                    found = take((lane + i) % lanes, true, &item);
+                }
+                if (!found) {
+                    return;
+                }
+                task(item);
+            }
+        });
+    }
+
+    inline uint32_t ParallelThreadPool::getWorkers() const {
+        return static_cast<uint32_t>(threads.size());
+    }
+
+    inline void ParallelThreadPool::workerLoop() {
+        uint64_t seen = 0;
+        while (true) {
+            Job *current = nullptr;
+            {
+                std::unique_lock lock(mutex);
+                wake.wait(lock, [this, &seen] { return terminated || generation != seen; });
+                if (terminated) {
+                    return;
+                }
+                seen = generation;
+                if (job == nullptr) {
+                    continue;
+                }
+                current = job;
+                ++running;
+            }
+
+            runLanes(*current);
+
+            {
+                std::scoped_lock lock(mutex);
+                --running;
+            }
+            finished.notify_all();
+        }
+    }
+
+    inline void ParallelThreadPool::runLanes(Job &job) {
+        for (uint32_t lane = job.nextLane.fetch_add(1); lane < job.lanes; lane = job.nextLane.fetch_add(1)) {
+            job.invoker(job.context, lane);
+        }
+    }
+}
@@ -11,7 +11,7 @@ namespace merutilm::rff2 {
     }
 
     FrtMPAAttribute CalculationPresets::UltraFast::genMPA() const {
-        return FrtMPAAttribute{4, 2, -3, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::NO_COMPRESSION};
+        return FrtMPAAttribute{4, 2, -3, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::NO_COMPRESSION, 8};
     }
 
     FrtReferenceCompAttribute CalculationPresets::UltraFast::genReferenceCompression() const {
@@ -23,7 +23,7 @@ namespace merutilm::rff2 {
     }
 
     FrtMPAAttribute CalculationPresets::Fast::genMPA() const {
-        return FrtMPAAttribute{8, 2, -4, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::NO_COMPRESSION};
+        return FrtMPAAttribute{8, 2, -4, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::NO_COMPRESSION, 8};
     }
 
     FrtReferenceCompAttribute CalculationPresets::Fast::genReferenceCompression() const {
@@ -35,7 +35,7 @@ namespace merutilm::rff2 {
     }
 
     FrtMPAAttribute CalculationPresets::Normal::genMPA() const {
-        return FrtMPAAttribute{8, 2, -5, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::LITTLE_COMPRESSION};
+        return FrtMPAAttribute{8, 2, -5, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::LITTLE_COMPRESSION, 16};
     }
 
     FrtReferenceCompAttribute CalculationPresets::Normal::genReferenceCompression() const {
@@ -47,7 +47,7 @@ namespace merutilm::rff2 {
     }
 
     FrtMPAAttribute CalculationPresets::Best::genMPA() const {
-        return FrtMPAAttribute{8, 2, -6, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::LITTLE_COMPRESSION};
+        return FrtMPAAttribute{8, 2, -6, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::LITTLE_COMPRESSION, 16};
     }
 
     FrtReferenceCompAttribute CalculationPresets::Best::genReferenceCompression() const {
@@ -59,7 +59,7 @@ namespace merutilm::rff2 {
     }
 
     FrtMPAAttribute CalculationPresets::UltraBest::genMPA() const {
-        return FrtMPAAttribute{8, 2, -7, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::LITTLE_COMPRESSION};
+        return FrtMPAAttribute{8, 2, -7, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::LITTLE_COMPRESSION, 32};
     }
 
     FrtReferenceCompAttribute CalculationPresets::UltraBest::genReferenceCompression() const {
@@ -71,7 +71,7 @@ namespace merutilm::rff2 {
     }
 
     FrtMPAAttribute CalculationPresets::Stable::genMPA() const {
-        return FrtMPAAttribute{8, 2, -4, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::STRONGEST};
+        return FrtMPAAttribute{8, 2, -4, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::STRONGEST, 16};
     }
 
     FrtReferenceCompAttribute CalculationPresets::Stable::genReferenceCompression() const {
@@ -83,7 +83,7 @@ namespace merutilm::rff2 {
     }
 
     FrtMPAAttribute CalculationPresets::MoreStable::genMPA() const {
-        return FrtMPAAttribute{8, 2, -4, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::STRONGEST};
+        return FrtMPAAttribute{8, 2, -4, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::STRONGEST, 16};
     }
 
     FrtReferenceCompAttribute CalculationPresets::MoreStable::genReferenceCompression() const {
@@ -95,7 +95,7 @@ namespace merutilm::rff2 {
     }
 
     FrtMPAAttribute CalculationPresets::UltraStable::genMPA() const {
-        return FrtMPAAttribute{8, 2, -4, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::STRONGEST};
+        return FrtMPAAttribute{8, 2, -4, FrtMPASelectionMethod::HIGHEST, FrtMPACompressionMethod::STRONGEST, 0};
     }
 
     FrtReferenceCompAttribute CalculationPresets::UltraStable::genReferenceCompression() const {
@@ -13,7 +13,7 @@ namespace merutilm::rff2 {
     }
 
     RenderAttribute RenderPresets::Potato::genRender() const {
-        return RenderAttribute{0.1f, 60, true, std::thread::hardware_concurrency()};
+        return RenderAttribute{0.1f, 60, true, std::thread::hardware_concurrency(), RdrGuessingMethod::SOLID_GUESSING_VERIFIED};
     }
 
 
@@ -22,7 +22,7 @@ namespace merutilm::rff2 {
     }
 
     RenderAttribute RenderPresets::Low::genRender() const {
-        return RenderAttribute{0.3f, 60, true, std::thread::hardware_concurrency()};
+        return RenderAttribute{0.3f, 60, true, std::thread::hardware_concurrency(), RdrGuessingMethod::SOLID_GUESSING_VERIFIED};
     }
 
     std::string RenderPresets::Medium::getName() const {
@@ -30,7 +30,7 @@ namespace merutilm::rff2 {
     }
 
     RenderAttribute RenderPresets::Medium::genRender() const {
-        return RenderAttribute{0.5f, 60, true, std::thread::hardware_concurrency()};
+        return RenderAttribute{0.5f, 60, true, std::thread::hardware_concurrency(), RdrGuessingMethod::NONE};
     }
 
     std::string RenderPresets::High::getName() const {
@@ -38,7 +38,7 @@ namespace merutilm::rff2 {
     }
 
     RenderAttribute RenderPresets::High::genRender() const {
-        return RenderAttribute{1.0f, 60, true, std::thread::hardware_concurrency()};
+        return RenderAttribute{1.0f, 60, true, std::thread::hardware_concurrency(), RdrGuessingMethod::NONE};
     }
 
     std::string RenderPresets::Ultra::getName() const {
@@ -46,7 +46,7 @@ namespace merutilm::rff2 {
     }
 
     RenderAttribute RenderPresets::Ultra::genRender() const {
-        return RenderAttribute{2.0f, 60, true, std::thread::hardware_concurrency()};
+        return RenderAttribute{2.0f, 60, true, std::thread::hardware_concurrency(), RdrGuessingMethod::NONE};
     }
 
     std::string RenderPresets::Extreme::getName() const {
@@ -54,6 +54,6 @@ namespace merutilm::rff2 {
     }
 
     RenderAttribute RenderPresets::Extreme::genRender() const {
-        return RenderAttribute{4.0f,  60, true, std::thread::hardware_concurrency()};
+        return RenderAttribute{4.0f,  60, true, std::thread::hardware_concurrency(), RdrGuessingMethod::NONE};
     }
 }
@@ -131,7 +131,7 @@ namespace merutilm::rff2 {
         auto core = vkh::factory::create<vkh::Core>();
         engine = vkh::factory::create<vkh::Engine>(std::move(core));
         wc = engine->attachWindowContext(renderWindow, Constants::VulkanWindow::MAIN_WINDOW_ATTACHMENT_INDEX);
-        scene = std::make_unique<RenderScene>(*engine, *wc, &statusMessages);
+        scene = std::make_unique<RenderScene>(*engine, *wc, threadPool, &statusMessages);
     }
 
     void Application::setProcedure() {
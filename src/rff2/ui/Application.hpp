@@ -16,6 +16,7 @@ namespace merutilm::rff2 {
         HWND renderWindow = nullptr;
         HWND statusBar = nullptr;
         vkh::WindowContextPtr wc = nullptr;
+        ParallelThreadPool threadPool = ParallelThreadPool(std::max(1u, std::thread::hardware_concurrency()) - 1);
         std::unique_ptr<RenderScene> scene = nullptr;
         std::unique_ptr<SettingsMenu> settingsMenu = nullptr;
         vkh::Engine engine = nullptr;
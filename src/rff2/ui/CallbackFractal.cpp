@@ -70,6 +70,46 @@ namespace merutilm::rff2 {
                                   L"NO Compressor normalization",
                                   L"Do not use normalization when compressing references. L"
                                   L"this will accelerates table creation, But may cause table creation to fail in the specific locations!!");
+        window->registerTextInput<uint32_t>(L"Threaded Reference Min Bits",
+                                            &calc.threadedReferenceMinBits,
+                                            Unparser::U_LONG, Parser::U_LONG,
+                                            ValidCondition::ALL_U_LONG, Callback::NOTHING,
+                                            L"Threaded Reference Minimum Precision",
+                                            L"When the precision of the reference is higher than this bits, the multiplications of each iteration are done on the multiple threads.\n"
+                                            L"The lower precision is faster on the single thread, because of the synchronization cost.\n"
+                                            L"Not activate option is ZERO.");
+        window->registerTextInput<uint32_t>(L"Reference Checkpoint Interval",
+                                            &calc.referenceCheckpointInterval,
+                                            Unparser::U_LONG, Parser::U_LONG,
+                                            ValidCondition::ALL_U_LONG, Callback::NOTHING,
+                                            L"Reference Checkpoint Interval",
+                                            L"Sets the interval in seconds to save the reference in progress to the temp directory.\n"
+                                            L"When the reference is cancelled after a long run, the next reference of the same location resumes from it.\n"
+                                            L"Not activate option is ZERO.");
+        window->registerTextInput<uint32_t>(L"Reference Cache Capacity",
+                                            &calc.referenceCacheCapacity,
+                                            Unparser::U_LONG, Parser::U_LONG,
+                                            ValidCondition::ALL_U_LONG, Callback::NOTHING,
+                                            L"Reference Cache Capacity",
+                                            L"Sets the capacity in MiB to keep the references and the tables in the temp directory.\n"
+                                            L"When the same location is rendered again, they are read instead of being computed.\n"
+                                            L"The least recently used ones are removed when it exceeds the capacity.\n"
+                                            L"Not activate option is ZERO.");
+        window->registerRadioButtonInput<FrtSegmentStorageMethod>(L"Reference Storage", &calc.referenceStorageMethod,
+                                                               Callback::NOTHING, L"Reference Storage",
+                                                               L"Sets where the segments of the reference orbit are allocated from the next reference.\n"
+                                                               L"Huge page misses the TLB less, and mapped file keeps the orbit larger than the memory in the scratch directory.");
+        window->registerRadioButtonInput<FrtSegmentStorageMethod>(L"Table Storage", &calc.tableStorageMethod,
+                                                               Callback::NOTHING, L"Table Storage",
+                                                               L"Sets where the MPA table is allocated from the next table.\n"
+                                                               L"Huge page misses the TLB less, and mapped file keeps the table larger than the memory in the scratch directory.");
+        window->registerTextInput<std::string>(L"Scratch Directory", &calc.scratchDirectory,
+                                               Unparser::STRING, Parser::STRING, [](const std::string &) {
+                                                   return true;
+                                               }, Callback::NOTHING,
+                                               L"Scratch Directory",
+                                               L"Sets the directory of the files of the mapped file storage and the reference checkpoints.\n"
+                                               L"Not activate option is EMPTY, which is the temp directory.");
         window->setWindowCloseFunction(
             [centerPtr, zoomPtr, locationChanged, &settingsMenu, &scene, &calc] {
                 const int exp10 = Perturbator::logZoomToExp10(*zoomPtr);
@@ -109,6 +149,11 @@ namespace merutilm::rff2 {
                                                                     &calc.decimalizeIterationMethod,
                                                                     Callback::NOTHING, L"Decimalize Iteration Method",
                                                                     L"Sets the decimalization method of iterations.");
+        window->registerRadioButtonInput<FrtInteriorDetectionMethod>(L"Interior detection",
+                                                                  &calc.interiorDetectionMethod,
+                                                                  Callback::NOTHING, L"Interior Detection Method",
+                                                                  L"Sets the method to stop iterating the interior before the max iteration.\n"
+                                                                  L"It is not used in the absolute iteration mode.");
         window->setWindowCloseFunction([&settingsMenu] {
             settingsMenu.setCurrentActiveSettingsWindow(nullptr);
         });
@@ -116,8 +161,8 @@ namespace merutilm::rff2 {
     };
     const std::function<void(SettingsMenu &, RenderScene &)> CallbackFractal::MPA = [
             ](SettingsMenu &settingsMenu, RenderScene  &scene) {
-        auto &[minSkipReference, maxMultiplierBetweenLevel, epsilonPower, mpaSelectionMethod, mpaCompressionMethod] =
-                scene.getAttribute().fractal.mpaAttribute;
+        auto &[minSkipReference, maxMultiplierBetweenLevel, epsilonPower, mpaSelectionMethod, mpaCompressionMethod,
+            seriesApproximationTerms] = scene.getAttribute().fractal.mpaAttribute;
         auto window = std::make_unique<SettingsWindow>(L"MP-Approximation");
         window->registerTextInput<uint16_t>(L"Min Skip Reference", &minSkipReference, Unparser::U_SHORT,
                                             Parser::U_SHORT, [](const unsigned short &v) { return v >= 4; },
@@ -149,6 +194,14 @@ namespace merutilm::rff2 {
                                                                L"\"Strongest\" works based on the Reference Compressor, so if it is disabled, it will behave the same as \"Little Compression\".\n L"
                                                                L"It uses acceleration when possible, and can accelerate table creation by 10x~100x of times."
         );
+        window->registerTextInput<uint8_t>(L"Series Approximation Terms", &seriesApproximationTerms,
+                                           Unparser::U_CHAR, Parser::U_CHAR,
+                                           [](const unsigned char &v) { return v <= 64; }, Callback::NOTHING,
+                                           L"Set the number of terms of the series approximation. 0 to disable.",
+                                           L"The first iterations of all pixels are skipped together by the series of the frame,\n"
+                                           L"as long as it matches the corner pixels within the epsilon.\n"
+                                           L"More terms skip more iterations, but cost more for each pixel. It is not used in the absolute iteration mode."
+        );
         window->setWindowCloseFunction([&settingsMenu] {
             settingsMenu.setCurrentActiveSettingsWindow(nullptr);
         });
@@ -12,7 +12,7 @@ namespace merutilm::rff2 {
     const std::function<void(SettingsMenu &, RenderScene &)> CallbackRender::SET_CLARITY = [
             ](SettingsMenu &settingsMenu, RenderScene &scene) {
         auto window = std::make_unique<SettingsWindow>(L"Set Render Properties");
-        auto &[clarityMultiplier, fps, linearInterpolation, threads] = scene.getAttribute().render;
+        auto &[clarityMultiplier, fps, linearInterpolation, threads, guessingMethod] = scene.getAttribute().render;
         window->registerTextInput<float>(L"Clarity", &clarityMultiplier, Unparser::FLOAT, Parser::FLOAT,
                                          [](const float &v) {
                                              return v > 0.05 && v <= 4;
@@ -28,6 +28,12 @@ namespace merutilm::rff2 {
         window->registerTextInput<uint32_t>(L"Threads", &threads, Unparser::U_LONG, Parser::U_LONG,
                                          ValidCondition::ALL_U_LONG, Callback::NOTHING, L"Threads",
                                          L"Sets the number of threads when calculating.");
+        window->registerRadioButtonInput<RdrGuessingMethod>(L"Guessing", &guessingMethod, [&scene] {
+                                                                scene.getRequests().requestRecompute();
+                                                            }, L"Guessing method",
+                                                            L"Sets the guessing method.\n"
+                                                            L"The inside of the rectangle is not calculated when its border is all the interior.\n"
+                                                            L"The verification calculates some of them to find the thin filaments.");
         window->setWindowCloseFunction([&settingsMenu] {
             settingsMenu.setCurrentActiveSettingsWindow(nullptr);
         });
@@ -11,8 +11,11 @@
 #include "../vulkan/RCC1.hpp"
 #include "../vulkan/GPCIterationPalette.hpp"
 #include "../calc/dex_exp.h"
+#include "../data/PixelGrid.h"
 #include "../formula/DeepMandelbrotPerturbator.h"
 #include "../formula/LightMandelbrotPerturbator.h"
+#include "../formula/ScaledMandelbrotPerturbator.h"
+#include "../io/RFFReferenceCache.h"
 #include "../locator/MandelbrotLocator.h"
 #include "../parallel/ParallelArrayDispatcher.h"
 #include "../parallel/ParallelDispatcher.h"
@@ -36,12 +39,13 @@
 
 
 namespace merutilm::rff2 {
-    RenderScene::RenderScene(vkh::EngineRef engine, vkh::WindowContextRef wc,
+    RenderScene::RenderScene(vkh::EngineRef engine, vkh::WindowContextRef wc, ParallelThreadPool &threadPool,
                              std::array<std::wstring, Constants::Status::LENGTH> *
                              statusMessageRef) : EngineHandler(
                                                      engine),
-                                                 wc(wc), attr(genDefaultAttr()),
+                                                 wc(wc), threadPool(threadPool), attr(genDefaultAttr()),
                                                  statusMessageRef(statusMessageRef) {
+        approxTableCache.threadPool = &threadPool;
         RenderScene::init();
     }
 
@@ -159,7 +163,14 @@ namespace merutilm::rff2 {
                 .reuseReferenceMethod = FrtReuseReferenceMethod::DISABLED,
                 .autoMaxIteration = true,
                 .autoIterationMultiplier = 100,
-                .absoluteIterationMode = false
+                .absoluteIterationMode = false,
+                .interiorDetectionMethod = FrtInteriorDetectionMethod::DERIVATIVE,
+                .threadedReferenceMinBits = Constants::Fractal::THREADED_REFERENCE_MIN_BITS,
+                .referenceCheckpointInterval = Constants::Fractal::REFERENCE_CHECKPOINT_INTERVAL,
+                .referenceCacheCapacity = Constants::Fractal::REFERENCE_CACHE_CAPACITY,
+                .referenceStorageMethod = FrtSegmentStorageMethod::HEAP,
+                .tableStorageMethod = FrtSegmentStorageMethod::HEAP,
+                .scratchDirectory = ""
             },
             .render = RenderPresets::High().genRender(),
             .shader = {
@@ -294,17 +305,10 @@ namespace merutilm::rff2 {
     }
 
     std::array<dex, 2> RenderScene::offsetConversion(const Attribute &settings, const int mx, const int my) const {
-        using namespace Constants::Fractal;
-        const double ox = static_cast<double>(mx) - static_cast<double>(getIterationBufferWidth(settings)) / 2.0;
-        const double oy = static_cast<double>(my) - static_cast<double>(getIterationBufferHeight(settings)) / 2.0;
-
+        const dex divisor = getDivisor(settings);
         return {
-            dex::value(std::abs(ox) < INTENTIONAL_ERROR_OFFSET_MIN_PIX ? INTENTIONAL_ERROR_OFFSET_MIN_PIX : ox) /
-            getDivisor(settings)
-            / settings.render.clarityMultiplier,
-            dex::value(std::abs(oy) < INTENTIONAL_ERROR_OFFSET_MIN_PIX ? INTENTIONAL_ERROR_OFFSET_MIN_PIX : oy) /
-            getDivisor(settings)
-            / settings.render.clarityMultiplier
+            PixelGrid::offset(getIterationBufferWidth(settings), mx, divisor, settings.render.clarityMultiplier),
+            PixelGrid::offset(getIterationBufferHeight(settings), my, divisor, settings.render.clarityMultiplier)
         };
     }
 
@@ -408,6 +412,7 @@ namespace merutilm::rff2 {
         renderer->rendererPresent->setRescaledResolution({sWidth, sHeight});
         renderer->rendererIteration->resetIterationBuffer(iw, ih);
         iterationMatrix = std::make_unique<Matrix<double> >(iw, ih);
+        continuationBuffer.invalidate();
         renderer->iterationStagingBufferContext = std::make_unique<GraphicsMatrixBuffer<double> >(
             wc.core, iw, ih, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
     }
@@ -539,6 +544,8 @@ namespace merutilm::rff2 {
         if (state.interruptRequested()) return false;
 
         auto &calc = attr.fractal;
+        approxTableCache.threads = attr.render.threads;
+        approxTableCache.storage = SegmentStorage(calc.tableStorageMethod, calc.scratchDirectory);
 
         const float logZoom = calc.logZoom;
 
@@ -547,7 +554,9 @@ namespace merutilm::rff2 {
         setStatusMessage(Constants::Status::ZOOM_STATUS,
                          std::format(L"Z : {:.06f}E{:d}", pow(10, fmod(logZoom, 1)), static_cast<int>(logZoom)));
 
-        const std::array<dex, 2> offset = offsetConversion(attr, 0, 0);
+        // The offsets of the pixels are computed once, and shared by all passes of the dispatcher.
+        const auto grid = PixelGrid(w, h, logZoom, attr.render.clarityMultiplier);
+        const std::array<dex, 2> offset = grid(0, 0);
         dex dcMax = dex::ZERO;
         dex_trigonometric::hypot_approx(&dcMax, offset[0], offset[1]);
         const auto refreshInterval = Utilities::getRefreshInterval(logZoom);
@@ -566,13 +575,52 @@ namespace merutilm::rff2 {
         };
 
 
+        // the cache to write the new reference after it is completed.
+        std::unique_ptr<RFFReferenceCache> referenceCache = nullptr;
+
+        // When only the max iteration is raised, the pixels which reached the previous one are continued.
+        const bool continued = calc.reuseReferenceMethod != FrtReuseReferenceMethod::CENTERED_REFERENCE &&
+                               currentPerturbator != nullptr &&
+                               continuationBuffer.canContinue(calc, w, h, currentPerturbator->getReference());
+
+        // When the center is moved by the whole pixels, the previous pixels are moved, and only the exposed ones are rendered.
+        // The reference is kept while it is in the view.
+        std::optional<std::array<int32_t, 2> > shift = std::nullopt;
+        if (!continued && calc.reuseReferenceMethod != FrtReuseReferenceMethod::CENTERED_REFERENCE &&
+            currentPerturbator != nullptr) {
+            const MandelbrotReference *previousReference = currentPerturbator->getReference();
+            shift = continuationBuffer.getShift(calc, w, h, previousReference,
+                                                dex::value(1.0) / getDivisor(attr) / attr.render.clarityMultiplier);
+            if (shift.has_value() && calc.reuseReferenceMethod == FrtReuseReferenceMethod::DISABLED) {
+                const int exp10 = Perturbator::logZoomToExp10(logZoom);
+                fp_complex_calculator referenceOffset = calc.center.edit(exp10);
+                referenceOffset -= previousReference->center.edit(exp10);
+                dex offR = dex::ZERO;
+                dex offI = dex::ZERO;
+                referenceOffset.getReal().double_exp_value(&offR);
+                referenceOffset.getImag().double_exp_value(&offI);
+                if (dex_trigonometric::hypot_approx(offR, offI) > dcMax) {
+                    shift = std::nullopt;
+                }
+            }
+        }
+
+        if (continued || shift.has_value()) {
+            continuationBuffer.invalidate();
+        } else {
+            continuationBuffer.reset(len);
+        }
+
         if (state.interruptRequested()) return false;
-        switch (calc.reuseReferenceMethod) {
+        switch (continued || shift.has_value() ? FrtReuseReferenceMethod::CURRENT_REFERENCE : calc.reuseReferenceMethod) {
                 using enum FrtReuseReferenceMethod;
             case CURRENT_REFERENCE: {
                 if (auto p = dynamic_cast<DeepMandelbrotPerturbator *>(currentPerturbator.get())) {
                     currentPerturbator = p->reuse(calc, currentPerturbator->getDcMaxAsDoubleExp(), approxTableCache);
                 }
+                if (auto p = dynamic_cast<ScaledMandelbrotPerturbator *>(currentPerturbator.get())) {
+                    currentPerturbator = p->reuse(calc, currentPerturbator->getDcMaxAsDoubleExp(), approxTableCache);
+                }
                 if (auto p = dynamic_cast<LightMandelbrotPerturbator *>(currentPerturbator.get())) {
                     currentPerturbator = p->reuse(calc, static_cast<double>(currentPerturbator->getDcMaxAsDoubleExp()),
                                                   approxTableCache);
@@ -596,7 +644,7 @@ namespace merutilm::rff2 {
                 int refExp10 = Perturbator::logZoomToExp10(refCalc.logZoom);
 
                 if (refCalc.logZoom > Constants::Fractal::ZOOM_DEADLINE) {
-                    currentPerturbator = std::make_unique<DeepMandelbrotPerturbator>(
+                    currentPerturbator = std::make_unique<ScaledMandelbrotPerturbator>(
                                 state, refCalc, center->perturbator->getDcMaxAsDoubleExp(),
                                 refExp10,
                                 period, approxTableCache, std::move(actionPerRefCalcIteration),
@@ -613,16 +661,37 @@ namespace merutilm::rff2 {
             }
             case DISABLED: {
                 int exp10 = Perturbator::logZoomToExp10(logZoom);
+                referenceCache = RFFReferenceCache::create(calc);
                 if (logZoom > Constants::Fractal::ZOOM_DEADLINE) {
-                    currentPerturbator = std::make_unique<DeepMandelbrotPerturbator>(
+                    auto cachedReference = referenceCache == nullptr
+                                               ? nullptr
+                                               : referenceCache->load<DeepMandelbrotReference>(
+                                                   calc, exp10, dcMax, approxTableCache);
+                    auto cachedTable = cachedReference == nullptr
+                                           ? nullptr
+                                           : std::make_unique<DeepMPATable>(
+                                               *cachedReference, &calc.mpaAttribute, approxTableCache);
+                    if (cachedReference != nullptr) referenceCache = nullptr;
+                    currentPerturbator = std::make_unique<ScaledMandelbrotPerturbator>(
                         state, calc, dcMax, exp10,
                         0, approxTableCache, std::move(actionPerRefCalcIteration),
-                        std::move(actionPerCreatingTableIteration));
+                        std::move(actionPerCreatingTableIteration), false, std::move(cachedReference),
+                        std::move(cachedTable));
                 } else {
+                    auto cachedReference = referenceCache == nullptr
+                                               ? nullptr
+                                               : referenceCache->load<LightMandelbrotReference>(
+                                                   calc, exp10, static_cast<double>(dcMax), approxTableCache);
+                    auto cachedTable = cachedReference == nullptr
+                                           ? nullptr
+                                           : std::make_unique<LightMPATable>(
+                                               *cachedReference, &calc.mpaAttribute, approxTableCache);
+                    if (cachedReference != nullptr) referenceCache = nullptr;
                     currentPerturbator = std::make_unique<LightMandelbrotPerturbator>(
                         state, calc, static_cast<double>(dcMax), exp10,
                         0, approxTableCache, std::move(actionPerRefCalcIteration),
-                        std::move(actionPerCreatingTableIteration));
+                        std::move(actionPerCreatingTableIteration), false, std::move(cachedReference),
+                        std::move(cachedTable));
                 }
                 break;
             }
@@ -631,10 +700,35 @@ namespace merutilm::rff2 {
             }
         }
 
+        // Beyond the deadline, the reference and the table are handed to whichever of the scaled and the deep perturbator is faster.
+        if (currentPerturbator->getReference() != Constants::NullPointer::PROCESS_TERMINATED_REFERENCE) {
+            if (const auto p = dynamic_cast<ScaledMandelbrotPerturbator *>(currentPerturbator.get());
+                p != nullptr && !ScaledMandelbrotPerturbator::isFasterThanDeep(logZoom, p->getTable())) {
+                currentPerturbator = p->toDeep(approxTableCache);
+            } else if (const auto q = dynamic_cast<DeepMandelbrotPerturbator *>(currentPerturbator.get());
+                q != nullptr && ScaledMandelbrotPerturbator::isFasterThanDeep(logZoom, q->getTable())) {
+                currentPerturbator = q->toScaled(approxTableCache);
+            }
+        }
+
         const MandelbrotReference *reference = currentPerturbator->getReference();
         if (reference == Constants::NullPointer::PROCESS_TERMINATED_REFERENCE || state.interruptRequested())
             return false;
 
+        if (referenceCache != nullptr &&
+            std::chrono::high_resolution_clock::now() - start >= Constants::Fractal::REFERENCE_CACHE_MIN_DURATION) {
+            const int exp10 = Perturbator::logZoomToExp10(logZoom);
+            if (const auto p = dynamic_cast<DeepMandelbrotPerturbator *>(currentPerturbator.get())) {
+                referenceCache->store(calc, exp10, dcMax, *p->getReference(), approxTableCache);
+            }
+            if (const auto p = dynamic_cast<ScaledMandelbrotPerturbator *>(currentPerturbator.get())) {
+                referenceCache->store(calc, exp10, dcMax, *p->getReference(), approxTableCache);
+            }
+            if (const auto p = dynamic_cast<LightMandelbrotPerturbator *>(currentPerturbator.get())) {
+                referenceCache->store(calc, exp10, static_cast<double>(dcMax), *p->getReference(), approxTableCache);
+            }
+        }
+
         lastLogZoom = calc.logZoom;
         lastMaxIteration = calc.maxIteration;
         lastPeriod = reference->longestPeriod();
@@ -646,41 +740,170 @@ namespace merutilm::rff2 {
         if (const auto t = dynamic_cast<DeepMandelbrotPerturbator *>(currentPerturbator.get())) {
             mpaLen = t->getTable().getLength();
         }
+        if (const auto t = dynamic_cast<ScaledMandelbrotPerturbator *>(currentPerturbator.get())) {
+            mpaLen = t->getTable().getLength();
+        }
 
         setStatusMessage(Constants::Status::PERIOD_STATUS,
                          std::format(L"P : {:L} ({:L}, {:L})", lastPeriod, refLength, mpaLen));
         if (state.interruptRequested()) return false;
 
+        // The series is shared by all pixels, so it is checked with the corners, which are the farthest from the center.
+        currentPerturbator->approximateSeries(std::array{
+            grid(0, 0), grid(w - 1, 0),
+            grid(0, h - 1), grid(w - 1, h - 1)
+        });
+        if (state.interruptRequested()) return false;
 
-        std::atomic renderPixelsCount = 0;
 
-        auto rendered = std::vector<bool>(len);
+        // The moved pixels are kept, and the others are rendered.
+        auto mask = std::vector<bool>();
+        if (shift.has_value()) {
+            const auto [sx, sy] = *shift;
+            const auto previous = iterationMatrix->getCanvasClone();
+            mask.assign(len, true);
+            for (int32_t y = std::max(0, -sy); y < std::min<int32_t>(h, h - sy); ++y) {
+                for (int32_t x = std::max(0, -sx); x < std::min<int32_t>(w, w - sx); ++x) {
+                    const uint32_t i = y * w + x;
+                    (*iterationMatrix)[i] = previous[(y + sy) * w + x + sx];
+                    mask[i] = false;
+                }
+            }
 
-        auto previewer = ParallelArrayDispatcher<double>(
-            state, *iterationMatrix, attr.render.threads,
-            [attr, this, &renderPixelsCount, &rendered](const uint16_t x, const uint16_t y,
-                                                        const uint16_t xRes, const uint16_t yRes, float,
-                                                        float, const uint32_t i, double) {
-                rendered[i] = true;
-                const auto dc = offsetConversion(attr, x, y);
-                const double iteration = currentPerturbator->iterate(dc[0], dc[1]);
-                renderer->iterationStagingBufferContext->set(x, y, iteration);
+            // The center lines are rendered with the intentional error offset, so the new and the moved ones are rendered again.
+            for (const int32_t cx: {w / 2, w / 2 - sx}) {
+                for (int32_t y = 0; w % 2 == 0 && cx >= 0 && cx < w && y < h; ++y) {
+                    mask[y * w + cx] = true;
+                }
+            }
+            for (const int32_t cy: {h / 2, h / 2 - sy}) {
+                for (int32_t x = 0; h % 2 == 0 && cy >= 0 && cy < h && x < w; ++x) {
+                    mask[cy * w + x] = true;
+                }
+            }
+            continuationBuffer.shift(w, h, *shift);
+        }
+
+        // The renderers of the threads mark the neighbouring pixels at once, so each flag is a separate atomic byte.
+        auto rendered = std::vector<std::atomic<uint8_t> >(len);
+        int renderedCount = 0;
+        for (uint32_t i = 0; i < mask.size(); ++i) {
+            rendered[i].store(!mask[i], std::memory_order_relaxed);
+            renderedCount += !mask[i];
+        }
+        std::atomic renderPixelsCount = renderedCount;
+
+        // The progressive passes show each coarse pixel as its block, so the rendered pixel is not copied down.
+        const bool progressive = !shift.has_value();
+        const auto preview = [this, &rendered, progressive](const uint16_t x, const uint16_t y, const uint16_t xRes,
+                                                            const uint16_t yRes, const double iteration) {
+            renderer->iterationStagingBufferContext->set(x, y, iteration);
+            if (progressive) {
+                return;
+            }
 
-                auto my = static_cast<int16_t>(y + 1);
-                while (my < yRes && !rendered[my * xRes + x]) {
-                    renderer->iterationStagingBufferContext->set(x, my, iteration);
-                    ++my;
+            auto my = static_cast<int16_t>(y + 1);
+            while (my < yRes && !rendered[my * xRes + x].load(std::memory_order_relaxed)) {
+                renderer->iterationStagingBufferContext->set(x, my, iteration);
+                ++my;
+            }
+        };
+
+        ParallelArrayRenderer<double> pixelRenderer =
+            [attr, this, continued, &grid, &renderPixelsCount, &rendered, &preview](
+            const uint16_t x, const uint16_t y, const uint16_t xRes, const uint16_t yRes, float, float,
+            const uint32_t i, const double value) {
+                rendered[i].store(true, std::memory_order_relaxed);
+                const uint32_t slot = continued ? continuationBuffer.getSlot(i) : ContinuationBuffer::UNKNOWN;
+                double iteration;
+                // The escaped pixel keeps its iteration, which is in the matrix until it is rendered.
+                if (slot == ContinuationBuffer::ESCAPED) {
+                    iteration = value;
+                } else if (slot == ContinuationBuffer::INTERIOR) {
+                    iteration = static_cast<double>(attr.fractal.maxIteration);
+                } else {
+                    auto continuation = slot == ContinuationBuffer::UNKNOWN
+                                            ? MandelbrotContinuation()
+                                            : continuationBuffer.get(slot);
+                    const auto dc = grid(x, y);
+                    iteration = currentPerturbator->iterate(dc[0], dc[1], continuation);
+                    continuationBuffer.store(i, continuation);
                 }
+                preview(x, y, xRes, yRes, iteration);
 
                 ++renderPixelsCount;
                 return iteration;
-            });
+            };
+
+        // The light perturbator iterates the rows in SIMD lanes. The continued pass goes by the pixels, since most of them are not iterated.
+        ParallelArrayRowRenderer<double> rowRenderer = nullptr;
+        if (const auto light = dynamic_cast<const LightMandelbrotPerturbator *>(currentPerturbator.get());
+            light != nullptr && !continued) {
+            rowRenderer = [this, light, &grid, &renderPixelsCount, &rendered, &preview](
+                const uint16_t y, const uint16_t xRes, const uint16_t yRes, const std::span<const uint16_t> xs,
+                const std::span<double> iterations) {
+                // The scratch of each worker thread is reused by its rows, so nothing is allocated per row once it is grown.
+                thread_local struct {
+                    std::vector<dex> dcr;
+                    std::vector<dex> dci;
+                    std::vector<MandelbrotContinuation> continuations;
+                } scratch;
+                scratch.dcr.resize(xs.size());
+                scratch.dci.resize(xs.size());
+                scratch.continuations.assign(xs.size(), MandelbrotContinuation());
+                const auto dcr = std::span(scratch.dcr);
+                const auto dci = std::span(scratch.dci);
+                const auto continuations = std::span(scratch.continuations);
+                for (size_t k = 0; k < xs.size(); ++k) {
+                    rendered[static_cast<uint32_t>(xRes) * y + xs[k]].store(true, std::memory_order_relaxed);
+                    dcr[k] = grid.getReal(xs[k]);
+                    dci[k] = grid.getImag(y);
+                }
+
+                light->iterateBatch(dcr, dci, iterations, continuations);
+
+                for (size_t k = 0; k < xs.size(); ++k) {
+                    preview(xs[k], y, xRes, yRes, iterations[k]);
+                    continuationBuffer.store(static_cast<uint32_t>(xRes) * y + xs[k], continuations[k]);
+                }
+                renderPixelsCount += static_cast<int>(xs.size());
+            };
+        }
+
+        auto previewer = ParallelArrayDispatcher<double>(state, threadPool, *iterationMatrix, attr.render.threads,
+                                                         std::move(pixelRenderer), std::move(rowRenderer));
+
+        // The iterations of the previous pass predict the cost of the rows, which are scheduled by it.
+        // The continued pass does not iterate the escaped and the interior pixels again.
+        if (!shift.has_value()) {
+            auto rowCosts = std::vector<double>(h);
+            for (uint16_t y = 0; y < h; ++y) {
+                for (uint16_t x = 0; x < w; ++x) {
+                    const uint32_t i = static_cast<uint32_t>(w) * y + x;
+                    const uint32_t slot = continued ? continuationBuffer.getSlot(i) : ContinuationBuffer::UNKNOWN;
+                    const bool skipped = slot == ContinuationBuffer::ESCAPED || slot == ContinuationBuffer::INTERIOR;
+                    rowCosts[y] += skipped ? 1 : 1 + (*iterationMatrix)[i];
+                }
+            }
+            previewer.setRowCosts(std::move(rowCosts));
+        }
 
-        renderer->iterationStagingBufferContext->fillZero();
+        if (shift.has_value()) {
+            for (uint16_t y = 0; y < h; ++y) {
+                for (uint16_t x = 0; x < w; ++x) {
+                    const uint32_t i = static_cast<uint32_t>(w) * y + x;
+                    renderer->iterationStagingBufferContext->set(
+                        x, y, rendered[i].load(std::memory_order_relaxed) ? (*iterationMatrix)[i] : 0);
+                }
+            }
+        } else {
+            renderer->iterationStagingBufferContext->fillZero();
+        }
 
         auto statusThread = std::jthread([&renderPixelsCount, len, this, &start](const std::stop_token &stop) {
             while (!stop.stop_requested()) {
-                float ratio = static_cast<float>(renderPixelsCount.load()) / static_cast<float>(len) * 100;
+                // The verification of the guessing renders some of the filled pixels again.
+                float ratio = std::min(static_cast<float>(renderPixelsCount.load()) / static_cast<float>(len) * 100, 100.0f);
                 setStatusMessage(Constants::Status::TIME_STATUS, Utilities::elapsed_time(start));
                 setStatusMessage(Constants::Status::RENDER_STATUS, std::format(L"C : {:.3f}%", ratio));
 
@@ -688,22 +911,80 @@ namespace merutilm::rff2 {
             }
         });
 
-        previewer.dispatch();
+        // The matrix is copied to the staging buffer as the contiguous bands of the rows of each thread.
+        // The lanes of the pool cannot throw, so the size is checked here.
+        const uint32_t syncLanes = std::max<uint32_t>(std::min<uint32_t>(attr.render.threads, h), 1);
+        renderer->iterationStagingBufferContext->checkSize(w, h);
+
+        // The exposed strips are too thin to guess, or to preview progressively.
+        if (shift.has_value()) {
+            previewer.dispatchMasked(mask);
+        } else {
+            // The progressive passes render the pixels of the coarse grid first, and show each of them as its block.
+            // The finer pass shares the pixels of the coarser ones, and the guessing or the last pass renders the rest.
+            auto coarse = std::vector<bool>(len);
+            auto blockRows = std::vector(syncLanes, std::vector<double>(w));
+            for (uint16_t step = Constants::Fractal::PROGRESSIVE_PREVIEW_STEP;
+                 step > 1 && !state.interruptRequested(); step >>= 1) {
+                for (uint16_t y = 0; y < h; ++y) {
+                    for (uint16_t x = 0; x < w; ++x) {
+                        const uint32_t i = static_cast<uint32_t>(w) * y + x;
+                        coarse[i] = x % step == 0 && y % step == 0 && !rendered[i].load(std::memory_order_relaxed);
+                    }
+                }
+                previewer.dispatchMasked(coarse);
+
+                // Every pixel of the coarse grid is rendered, and the others are shown as the block of their coarse pixel.
+                threadPool.run(syncLanes, [this, step, w, h, syncLanes, &blockRows](const uint32_t lane) noexcept {
+                    auto &row = blockRows[lane];
+                    for (uint32_t y = h * lane / syncLanes; y < h * (lane + 1) / syncLanes; ++y) {
+                        const uint32_t offset = static_cast<uint32_t>(w) * (y - y % step);
+                        for (uint16_t x = 0; x < w; ++x) {
+                            row[x] = (*iterationMatrix)[offset + x - x % step];
+                        }
+                        renderer->iterationStagingBufferContext->fillRow(y, row);
+                    }
+                });
+            }
+
+            // The interior is the max iteration, unless the absolute iteration is shown.
+            if (const auto guessingMethod = attr.render.guessingMethod;
+                guessingMethod != RdrGuessingMethod::NONE && !calc.absoluteIterationMode) {
+                // The filled pixels are marked as rendered while guessing, so the coarse pixels are given as a copy.
+                for (uint32_t i = 0; i < len; ++i) {
+                    coarse[i] = rendered[i].load(std::memory_order_relaxed);
+                }
+                previewer.dispatchGuessing(static_cast<double>(calc.maxIteration),
+                                           guessingMethod == RdrGuessingMethod::SOLID_GUESSING_VERIFIED,
+                                           [this, &renderPixelsCount, &rendered, &preview](
+                                       const uint16_t x, const uint16_t y, const uint16_t xRes, const uint16_t yRes,
+                                       const uint32_t i, const double &iteration) {
+                                               rendered[i].store(true, std::memory_order_relaxed);
+                                               continuationBuffer.forget(i);
+                                               preview(x, y, xRes, yRes, iteration);
+                                               ++renderPixelsCount;
+                                           }, &coarse);
+            } else {
+                for (uint32_t i = 0; i < len; ++i) {
+                    coarse[i] = !rendered[i].load(std::memory_order_relaxed);
+                }
+                previewer.dispatchMasked(coarse);
+            }
+        }
 
         statusThread.request_stop();
         statusThread.join();
 
         if (state.interruptRequested()) return false;
 
-        const auto syncer = ParallelDispatcher(
-            state, w, h, attr.render.threads,
-            [this](const uint16_t x, const uint16_t y, uint16_t, uint16_t, float, float, uint32_t) {
-                renderer->iterationStagingBufferContext->set(x, y, (*iterationMatrix)(x, y));
-            });
-
-        syncer.dispatch();
+        // The matrix replaces the preview.
+        threadPool.run(syncLanes, [this, h, syncLanes](const uint32_t lane) noexcept {
+            renderer->iterationStagingBufferContext->fillRows(iterationMatrix->getCanvas(), h * lane / syncLanes,
+                                                              h * (lane + 1) / syncLanes);
+        });
 
         if (state.interruptRequested()) return false;
+        continuationBuffer.commit(calc, w, h, reference);
         setStatusMessage(Constants::Status::RENDER_STATUS, L"Done");
 
         return true;
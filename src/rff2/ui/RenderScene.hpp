@@ -12,9 +12,11 @@
 #include "RenderSceneRenderer.hpp"
 #include "../../vulkan_helper/handle/EngineHandler.hpp"
 #include "../data/ApproxTableCache.h"
+#include "../data/ContinuationBuffer.h"
 #include "../formula/MandelbrotPerturbator.h"
 #include "../io/RFFDynamicMapBinary.h"
 #include "../parallel/BackgroundThreads.h"
+#include "../parallel/ParallelThreadPool.h"
 #include "../preset/Presets.h"
 #include "../attr/Attribute.h"
 
@@ -22,6 +24,7 @@ namespace merutilm::rff2 {
     class RenderScene final : public vkh::EngineHandler {
 
         vkh::WindowContextRef wc;
+        ParallelThreadPool &threadPool;
         ParallelRenderState state;
         Attribute attr;
 
@@ -42,6 +45,7 @@ namespace merutilm::rff2 {
 
         std::array<std::wstring, Constants::Status::LENGTH> *statusMessageRef = nullptr;
         std::unique_ptr<Matrix<double>> iterationMatrix = nullptr;
+        ContinuationBuffer continuationBuffer = ContinuationBuffer();
 
         std::unique_ptr<MandelbrotPerturbator> currentPerturbator = nullptr;
 
@@ -54,7 +58,7 @@ namespace merutilm::rff2 {
         BackgroundThreads backgroundThreads = BackgroundThreads();
 
     public:
-        explicit RenderScene(vkh::EngineRef engine, vkh::WindowContextRef wc,
+        explicit RenderScene(vkh::EngineRef engine, vkh::WindowContextRef wc, ParallelThreadPool &threadPool,
                              std::array<std::wstring, Constants::Status::LENGTH> *statusMessageRef);
 
         ~RenderScene() override;
@@ -164,6 +168,7 @@ namespace merutilm::rff2 {
         }
 
         void setCurrentPerturbator(std::unique_ptr<MandelbrotPerturbator> perturbator) {
+            continuationBuffer.invalidate();
             currentPerturbator = std::move(perturbator);
         }
 